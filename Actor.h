@@ -0,0 +1,313 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+/*
+ * File:   Actor.h
+ * Created on October 18, 2026
+ */
+
+#ifndef PROTOTYPAL_C_ACTOR_H_
+#define PROTOTYPAL_C_ACTOR_H_
+
+#include "Prototypal_Cpp.h"
+#include "Thread_Pool.h"
+#include <stddef.h>
+#include <atomic>
+#include <string>
+#include <thread>
+
+class Actor;
+
+/**  \brief Runs Actors on a Thread_Pool. An Actor is scheduled when a
+ *  message arrives in its empty mailbox. Each activation delivers up to
+ *  batch messages, then schedules the Actor again if more are waiting, so
+ *  one wakeup serves many messages and busy Actors take turns.
+ */
+class Actor_Scheduler {
+    Thread_Pool &my_pool;
+    size_t my_batch;
+    /**
+     *   \brief Actors scheduled or running
+     */
+    std::atomic<size_t> my_active;
+    std::atomic<size_t> my_failures;
+
+    friend class Actor;
+
+    /**
+     *   \brief Queues an activation of actor behind the tasks already
+     *   queued, so that busy Actors take turns.
+     */
+    inline void run(Actor &actor);
+
+    inline void schedule(Actor &actor);
+
+public:
+
+    /**
+     *  \brief Runs Actors on pool, delivering up to batch messages per
+     *  activation.
+     */
+    explicit Actor_Scheduler(Thread_Pool &pool, size_t batch = 64)
+    : my_pool(pool), my_batch(batch == 0 ? 1 : batch), my_active(0),
+    my_failures(0) {
+    }
+
+    Actor_Scheduler(const Actor_Scheduler &) = delete;
+    Actor_Scheduler& operator =(const Actor_Scheduler &) = delete;
+
+    /**
+     *  \brief A scheduler on Thread_Pool::shared(), used by Actors that are
+     *  not given one.
+     */
+    static Actor_Scheduler & shared() {
+        static Actor_Scheduler scheduler(Thread_Pool::shared());
+        return scheduler;
+    }
+
+    /**
+     *  \brief Blocks until every mailbox is empty and no message is being
+     *  delivered. Runs pool tasks on the calling thread while it waits.
+     */
+    void wait_idle() {
+        while (this->my_active.load(std::memory_order_acquire) != 0) {
+            if (!this->my_pool.run_one())
+                std::this_thread::yield();
+        }
+    }
+
+    /**
+     *  \brief Number of messages whose delivery threw. The exception is
+     *  dropped after exec has printed its message.
+     */
+    size_t failures() const {
+        return this->my_failures.load(std::memory_order_relaxed);
+    }
+};
+
+/**  \brief Object with a mailbox. Messages sent to an Actor with send or
+ *  lsend are delivered one at a time, in the order each sender sent them,
+ *  on whichever pool thread runs the Actor. No two messages to the same
+ *  Actor are delivered at once, so functions reached through messages need
+ *  no locks for the Actor's own state.
+ *  The mailbox is a lock-free multi-producer, single-consumer queue of
+ *  intrusive nodes: a send is one allocation and one atomic exchange.
+ *  An Actor must not be destroyed while messages to it are pending;
+ *  call Actor_Scheduler.wait_idle first.
+ */
+class Actor : public Object {
+public:
+
+    /**  \brief A queued message. deliver runs it against the Actor.
+     */
+    struct Message {
+        std::atomic<Message *> next;
+
+        Message() : next(nullptr) {
+        }
+
+        virtual void deliver(Actor &) {
+        }
+
+        virtual ~Message() {
+        }
+    };
+
+private:
+
+    template <class Function> struct Function_Message : Message {
+        Function f;
+
+        explicit Function_Message(const Function &function) : f(function) {
+        }
+
+        void deliver(Actor &actor) {
+            this->f(actor);
+        }
+    };
+
+    friend class Actor_Scheduler;
+
+    Actor_Scheduler &my_scheduler;
+    /**
+     *   \brief Producers push here
+     */
+    std::atomic<Message *> my_head;
+    /**
+     *   \brief Messages sent and not yet delivered
+     */
+    std::atomic<size_t> my_pending;
+    /**
+     *   \brief Keeps my_tail off the cache line that senders write
+     */
+    char my_padding[64];
+    /**
+     *   \brief Only the running activation pops from here
+     */
+    Message * my_tail;
+    Message my_stub;
+
+    void push(Message * m) {
+        m->next.store(nullptr, std::memory_order_relaxed);
+        Message * previous = this->my_head.exchange(m, std::memory_order_acq_rel);
+        previous->next.store(m, std::memory_order_release);
+    }
+
+    /**
+     *  \brief Takes the oldest message.
+     *  @return nullptr if the mailbox is empty, or if a sender is between
+     *  the two steps of push and the next message is not linked in yet
+     */
+    Message * pop() {
+        Message * tail = this->my_tail;
+        Message * next = tail->next.load(std::memory_order_acquire);
+        if (tail == &this->my_stub) {
+            if (next == nullptr)
+                return nullptr;
+            this->my_tail = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next != nullptr) {
+            this->my_tail = next;
+            return tail;
+        }
+        if (tail != this->my_head.load(std::memory_order_acquire))
+            return nullptr;
+        this->push(&this->my_stub);
+        next = tail->next.load(std::memory_order_acquire);
+        if (next != nullptr) {
+            this->my_tail = next;
+            return tail;
+        }
+        return nullptr;
+    }
+
+    /**
+     *  \brief Delivers up to batch messages on the calling thread.
+     *  @return true if messages are still waiting
+     */
+    bool activate(size_t batch) {
+        size_t delivered = 0;
+        while (delivered < batch) {
+            Message * m = this->pop();
+            if (m == nullptr) {
+                if (this->my_pending.load(std::memory_order_acquire) == delivered)
+                    break;
+                // A sender has counted its message but not linked it yet.
+                std::this_thread::yield();
+                continue;
+            }
+            try {
+                m->deliver(*this);
+            } catch (...) {
+                this->my_scheduler.my_failures.fetch_add(1,
+                        std::memory_order_relaxed);
+            }
+            delete m;
+            ++delivered;
+        }
+        return this->my_pending.fetch_sub(delivered, std::memory_order_acq_rel)
+                != delivered;
+    }
+
+    void enqueue(Message * m) {
+        bool first = this->my_pending.fetch_add(1, std::memory_order_acq_rel) == 0;
+        this->push(m);
+        if (first)
+            this->my_scheduler.schedule(*this);
+    }
+
+public:
+
+    /**
+     *  \brief Empty Actor run by scheduler.
+     */
+    explicit Actor(Actor_Scheduler &scheduler = Actor_Scheduler::shared())
+    : Object(), my_scheduler(scheduler), my_head(&my_stub), my_pending(0),
+    my_padding(), my_tail(&my_stub), my_stub() {
+    }
+
+    /**
+     *  \brief Copies o's properties, parent and function into an Actor with
+     *  an empty mailbox on the same scheduler.
+     */
+    Actor(const Actor &o) : Object(o), my_scheduler(o.my_scheduler),
+    my_head(&my_stub), my_pending(0), my_padding(), my_tail(&my_stub),
+    my_stub() {
+    }
+
+    /**
+     *  \brief Copies other's properties, parent and function. The mailbox
+     *  is not copied.
+     */
+    Actor& operator =(const Actor &other) {
+        Object::operator =(other);
+        return *this;
+    }
+
+    /**
+     *  \brief Frees undelivered messages.
+     */
+    ~Actor() {
+        Message * m;
+        while ((m = this->pop()) != nullptr)
+            delete m;
+    }
+
+    /**
+     *  \brief Queues f, which is called as f(actor) when the message is
+     *  delivered.
+     */
+    template <class Function> void post(const Function &f) {
+        this->enqueue(new Function_Message<Function>(f));
+    }
+};
+
+inline void Actor_Scheduler::run(Actor &actor) {
+    Actor * a = &actor;
+    this->my_pool.defer([this, a] {
+        if (a->activate(this->my_batch))
+            this->run(*a);
+        else
+            this->my_active.fetch_sub(1, std::memory_order_acq_rel);
+    });
+}
+
+inline void Actor_Scheduler::schedule(Actor &actor) {
+    this->my_active.fetch_add(1, std::memory_order_acq_rel);
+    this->run(actor);
+}
+
+/**
+ * \brief Queues target.exec(function_name, Parameters...) in target's
+ * mailbox and returns at once. Parameters are copied.
+ */
+template <class ...A> void send(Actor &target, const std::string &function_name,
+        A... Parameters) {
+    target.post([function_name, Parameters...](Actor & self) {
+        self.exec(function_name, Parameters...);
+    });
+}
+
+/**
+ * \brief Queues target.lexec<Standard_Function>(function_name,
+ * Parameters...) in target's mailbox and returns at once.
+ */
+template <class Standard_Function, class ...A> void lsend(Actor &target,
+        const std::string &function_name, A... Parameters) {
+    target.post([function_name, Parameters...](Actor & self) {
+        self.lexec<Standard_Function>(function_name, Parameters...);
+    });
+}
+#endif    // PROTOTYPAL_C_ACTOR_H_
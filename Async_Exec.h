@@ -0,0 +1,472 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+/*
+ * File:   Async_Exec.h
+ * Created on October 18, 2026
+ */
+
+#ifndef PROTOTYPAL_C_ASYNC_EXEC_H_
+#define PROTOTYPAL_C_ASYNC_EXEC_H_
+
+#include "Prototypal_Cpp.h"
+#include "Thread_Pool.h"
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+
+#ifdef __cpp_impl_coroutine
+#include <coroutine>
+#endif
+#ifdef __cpp_lib_coroutine
+#define PROTOTYPAL_CPP_COROUTINES 1
+#include <optional>
+#endif
+
+/**
+ *   \brief Runs a task somewhere, now or later, on this thread or another.
+ */
+typedef std::function<void(std::function<void()>)> Executor;
+
+/**
+ *   \brief An Executor that posts tasks to pool. pool must outlive it.
+ */
+inline Executor pool_executor(Thread_Pool &pool) {
+    Thread_Pool * p = &pool;
+    return [p](std::function<void()> task) {
+        p->post(std::move(task));
+    };
+}
+
+/**
+ *   \brief The Executor used when none is given. Posts to
+ *   Thread_Pool::shared() until it is replaced. Replace it before any
+ *   asynchronous call is made, not while they run.
+ */
+inline Executor & default_executor() {
+    static Executor executor = pool_executor(Thread_Pool::shared());
+    return executor;
+}
+
+/**  \brief Runs a function and hands its result or exception to a
+ *  std::promise.
+ */
+template <class Return_Type> struct Async_Exec {
+
+    template <class Function> static void run(std::promise<Return_Type> &promise,
+            Function &f) {
+        try {
+            promise.set_value(f());
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+        }
+    }
+
+    /**
+     *   \brief Posts f to executor.
+     *   @return a future for f's result
+     */
+    template <class Function> static std::future<Return_Type> post
+    (const Executor &executor, Function f) {
+        std::shared_ptr<std::promise<Return_Type> > promise =
+                std::make_shared<std::promise<Return_Type> >();
+        std::future<Return_Type> future = promise->get_future();
+        executor([promise, f]() mutable {
+            Async_Exec<Return_Type>::run(*promise, f);
+        });
+        return future;
+    }
+};
+
+template <> template <class Function> inline void Async_Exec<void>::run
+(std::promise<void> &promise, Function &f) {
+    try {
+        f();
+        promise.set_value();
+    } catch (...) {
+        promise.set_exception(std::current_exception());
+    }
+}
+
+/**
+ * \brief Performs o.exec<Return_Type>(function_name, Parameters...) on
+ * executor. Parameters are copied; o must outlive the call and must not be
+ * modified while it runs.
+ * @return a future for the result. It holds the -1 that exec throws when
+ * function_name cannot be found.
+ */
+template <class Return_Type = void, class ...A> std::future<Return_Type>
+exec_async(const Executor &executor, Object &o, const std::string &function_name,
+        A... Parameters) {
+    Object * target = &o;
+    return Async_Exec<Return_Type>::post(executor,
+            [target, function_name, Parameters...]() {
+                return target->exec<Return_Type>(function_name, Parameters...);
+            });
+}
+
+/**
+ * \brief exec_async on default_executor()
+ */
+template <class Return_Type = void, class ...A> std::future<Return_Type>
+exec_async(Object &o, const std::string &function_name, A... Parameters) {
+    return exec_async<Return_Type>(default_executor(), o, function_name,
+            Parameters...);
+}
+
+/**
+ * \brief Performs o.call<Return_Type>(Parameters...) on executor, like
+ * exec_async.
+ */
+template <class Return_Type = void, class ...A> std::future<Return_Type>
+call_async(const Executor &executor, Object &o, A... Parameters) {
+    Object * target = &o;
+    return Async_Exec<Return_Type>::post(executor,
+            [target, Parameters...]() {
+                return target->call<Return_Type>(Parameters...);
+            });
+}
+
+/**
+ * \brief call_async on default_executor()
+ */
+template <class Return_Type = void, class ...A> std::future<Return_Type>
+call_async(Object &o, A... Parameters) {
+    return call_async<Return_Type>(default_executor(), o, Parameters...);
+}
+
+/**
+ * \brief Performs o.lexec<Standard_Function, Return_Type>(function_name,
+ * Parameters...) on executor, like exec_async.
+ */
+template <class Standard_Function, class Return_Type = void, class ...A>
+std::future<Return_Type> lexec_async(const Executor &executor, Object &o,
+        const std::string &function_name, A... Parameters) {
+    Object * target = &o;
+    return Async_Exec<Return_Type>::post(executor,
+            [target, function_name, Parameters...]() {
+                return target->lexec<Standard_Function, Return_Type>
+                        (function_name, Parameters...);
+            });
+}
+
+/**
+ * \brief lexec_async on default_executor()
+ */
+template <class Standard_Function, class Return_Type = void, class ...A>
+std::future<Return_Type> lexec_async(Object &o,
+        const std::string &function_name, A... Parameters) {
+    return lexec_async<Standard_Function, Return_Type>(default_executor(), o,
+            function_name, Parameters...);
+}
+
+#ifdef PROTOTYPAL_CPP_COROUTINES
+
+/**  \brief The value or exception a coroutine or an awaited call ended with.
+ */
+template <class Return_Type> struct Coroutine_Result {
+    std::optional<Return_Type> value;
+    std::exception_ptr error;
+
+    template <class Function> void run(Function &f) {
+        try {
+            this->value.emplace(f());
+        } catch (...) {
+            this->error = std::current_exception();
+        }
+    }
+
+    Return_Type take() {
+        if (this->error)
+            std::rethrow_exception(this->error);
+        return std::move(*this->value);
+    }
+};
+
+template <> struct Coroutine_Result<void> {
+    std::exception_ptr error;
+
+    template <class Function> void run(Function &f) {
+        try {
+            f();
+        } catch (...) {
+            this->error = std::current_exception();
+        }
+    }
+
+    void take() {
+        if (this->error)
+            std::rethrow_exception(this->error);
+    }
+};
+
+template <class Return_Type> class Task;
+
+/**  \brief The parts of Task's promise_type that depend on whether the
+ *  coroutine returns a value.
+ */
+template <class Return_Type> struct Task_Promise_Base {
+    Coroutine_Result<Return_Type> result;
+
+    void return_value(Return_Type value) {
+        this->result.value.emplace(std::move(value));
+    }
+};
+
+template <> struct Task_Promise_Base<void> {
+    Coroutine_Result<void> result;
+
+    void return_void() {
+    }
+};
+
+/**  \brief Return type for coroutines that can be stored in an Object and
+ *  awaited by other coroutines. A Task starts when it is awaited and
+ *  resumes its awaiter when it finishes, on the thread it finished on.
+ *  Store a coroutine as a std::function returning a Task and call it with
+ *  lexec, then co_await the Task.
+ *  Use spawn or sync_wait to run a Task from code that is not a coroutine.
+ */
+template <class Return_Type = void> class Task {
+public:
+
+    struct promise_type : Task_Promise_Base<Return_Type> {
+        std::coroutine_handle<> continuation;
+
+        Task get_return_object() {
+            return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept {
+            return std::suspend_always();
+        }
+
+        struct Final_Awaiter {
+
+            bool await_ready() noexcept {
+                return false;
+            }
+
+            std::coroutine_handle<> await_suspend
+            (std::coroutine_handle<promise_type> h) noexcept {
+                std::coroutine_handle<> next = h.promise().continuation;
+                if (next)
+                    return next;
+                return std::noop_coroutine();
+            }
+
+            void await_resume() noexcept {
+            }
+        };
+
+        Final_Awaiter final_suspend() noexcept {
+            return Final_Awaiter();
+        }
+
+        void unhandled_exception() {
+            this->result.error = std::current_exception();
+        }
+    };
+
+    Task(Task &&other) noexcept : my_handle(other.my_handle) {
+        other.my_handle = nullptr;
+    }
+
+    Task(const Task &) = delete;
+    Task& operator =(const Task &) = delete;
+
+    ~Task() {
+        if (this->my_handle)
+            this->my_handle.destroy();
+    }
+
+    struct Awaiter {
+        std::coroutine_handle<promise_type> handle;
+
+        bool await_ready() noexcept {
+            return false;
+        }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting)
+        noexcept {
+            this->handle.promise().continuation = awaiting;
+            return this->handle;
+        }
+
+        Return_Type await_resume() {
+            return this->handle.promise().result.take();
+        }
+    };
+
+    /**
+     *   \brief Starts the Task and suspends the awaiting coroutine until the
+     *   Task finishes. Yields the Task's result or rethrows its exception.
+     */
+    Awaiter operator co_await() && noexcept {
+        return Awaiter{this->my_handle};
+    }
+
+private:
+    std::coroutine_handle<promise_type> my_handle;
+
+    explicit Task(std::coroutine_handle<promise_type> h) : my_handle(h) {
+    }
+};
+
+/**  \brief Eager coroutine that nobody awaits. Frees itself when done.
+ */
+struct Detached_Coroutine {
+
+    struct promise_type {
+
+        Detached_Coroutine get_return_object() {
+            return Detached_Coroutine();
+        }
+
+        std::suspend_never initial_suspend() noexcept {
+            return std::suspend_never();
+        }
+
+        std::suspend_never final_suspend() noexcept {
+            return std::suspend_never();
+        }
+
+        void return_void() {
+        }
+
+        void unhandled_exception() {
+            std::terminate();
+        }
+    };
+};
+
+template <class Return_Type> Detached_Coroutine spawn_into(Task<Return_Type> task,
+        std::shared_ptr<std::promise<Return_Type> > promise) {
+    try {
+        promise->set_value(co_await std::move(task));
+    } catch (...) {
+        promise->set_exception(std::current_exception());
+    }
+}
+
+inline Detached_Coroutine spawn_into(Task<void> task,
+        std::shared_ptr<std::promise<void> > promise) {
+    try {
+        co_await std::move(task);
+        promise->set_value();
+    } catch (...) {
+        promise->set_exception(std::current_exception());
+    }
+}
+
+/**
+ * \brief Starts task on this thread. It runs until its first suspension.
+ * @return a future for the Task's result
+ */
+template <class Return_Type> std::future<Return_Type> spawn
+(Task<Return_Type> task) {
+    std::shared_ptr<std::promise<Return_Type> > promise =
+            std::make_shared<std::promise<Return_Type> >();
+    std::future<Return_Type> future = promise->get_future();
+    spawn_into(std::move(task), promise);
+    return future;
+}
+
+/**
+ * \brief Runs task and waits until it finishes, running queued tasks of
+ * pool meanwhile, like Thread_Pool::parallel_for. It may be called from a
+ * worker of pool, or with a pool of one thread, when task awaits work
+ * posted to pool. Work posted elsewhere must be able to finish without the
+ * calling thread.
+ */
+template <class Return_Type> Return_Type sync_wait(Task<Return_Type> task,
+        Thread_Pool &pool) {
+    std::future<Return_Type> future = spawn(std::move(task));
+    while (future.wait_for(std::chrono::seconds(0))
+            != std::future_status::ready) {
+        if (!pool.run_one())
+            std::this_thread::yield();
+    }
+    return future.get();
+}
+
+/**
+ * \brief sync_wait helping Thread_Pool::shared(), which
+ * default_executor() posts to unless it was replaced.
+ */
+template <class Return_Type> Return_Type sync_wait(Task<Return_Type> task) {
+    return sync_wait(std::move(task), Thread_Pool::shared());
+}
+
+/**  \brief Awaitable returned by co_exec.
+ */
+template <class Return_Type> class Exec_Awaiter {
+    Executor my_executor;
+    std::function<Return_Type()> my_job;
+    Coroutine_Result<Return_Type> my_result;
+
+public:
+
+    Exec_Awaiter(const Executor &executor, std::function<Return_Type()> job)
+    : my_executor(executor), my_job(std::move(job)), my_result() {
+    }
+
+    bool await_ready() noexcept {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> awaiting) {
+        // The job may resume the coroutine, which destroys this awaiter,
+        // before the executor returns.
+        Executor executor = this->my_executor;
+        executor([this, awaiting]() {
+            this->my_result.run(this->my_job);
+            awaiting.resume();
+        });
+    }
+
+    Return_Type await_resume() {
+        return this->my_result.take();
+    }
+};
+
+/**
+ * \brief co_await co_exec<Return_Type>(o, "name", Parameters...) suspends
+ * the calling coroutine, performs o.exec on executor and resumes the
+ * coroutine on the executor's thread with the result.
+ */
+template <class Return_Type = void, class ...A> Exec_Awaiter<Return_Type>
+co_exec(const Executor &executor, Object &o, const std::string &function_name,
+        A... Parameters) {
+    Object * target = &o;
+    return Exec_Awaiter<Return_Type>(executor,
+            [target, function_name, Parameters...]() {
+                return target->exec<Return_Type>(function_name, Parameters...);
+            });
+}
+
+/**
+ * \brief co_exec on default_executor()
+ */
+template <class Return_Type = void, class ...A> Exec_Awaiter<Return_Type>
+co_exec(Object &o, const std::string &function_name, A... Parameters) {
+    return co_exec<Return_Type>(default_executor(), o, function_name,
+            Parameters...);
+}
+#endif    // PROTOTYPAL_CPP_COROUTINES
+#endif    // PROTOTYPAL_C_ASYNC_EXEC_H_
@@ -0,0 +1,405 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+/*
+ * File:   Compact_Object.h
+ * Created on October 18, 2026
+ */
+
+#ifndef PROTOTYPAL_C_COMPACT_OBJECT_H_
+#define PROTOTYPAL_C_COMPACT_OBJECT_H_
+
+#include "Prototypal_Cpp.h"
+#include <stdio.h>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**  \brief Object with the same interface as Object and a one pointer header.
+ *  The function pointer, parent pointer and properties live in a Body that
+ *  is only allocated once one of them is set, so an empty Compact_Object
+ *  uses sizeof(void *) bytes and no heap. Properties are kept in a vector
+ *  sorted by name instead of a hash table, which saves the bucket array and
+ *  the per-node next pointer and hash code.
+ *  Compact_Object has no virtual functions and is not meant to be derived
+ *  from. exec identifies callable properties by their Type_Descriptor.
+ */
+class Compact_Object {
+
+    /**  \brief One named property: a shared pointer to the value and the
+     *  descriptor of the value's type.
+     */
+    struct Slot {
+        std::string name;
+        std::shared_ptr<void> p;
+        const Object::Type_Descriptor * t;
+    };
+
+    /**  \brief Everything but the header. Allocated on first use.
+     */
+    struct Body {
+        pcast execute_me;
+        Compact_Object * my_parent;
+        /** Properties sorted by name */
+        std::vector<Slot> slots;
+
+        Body() : execute_me(nullptr), my_parent(nullptr), slots() {
+        }
+    };
+
+    /**
+     *  \brief nullptr until a property, function or parent is set
+     */
+    Body * my_body;
+
+    Body & body() {
+        if (this->my_body == nullptr)
+            this->my_body = new Body();
+        return *this->my_body;
+    }
+
+    Compact_Object * parent() const {
+        return this->my_body == nullptr ? nullptr : this->my_body->my_parent;
+    }
+
+    /**
+     *  \brief Binary search for the property named name in this object only.
+     *  @return the slot or nullptr
+     */
+    const Slot * find(const std::string &name) const {
+        if (this->my_body == nullptr)
+            return nullptr;
+        const std::vector<Slot> &slots = this->my_body->slots;
+        auto it = std::lower_bound(slots.begin(), slots.end(), name,
+                Compact_Object::name_less);
+        if (it != slots.end() && it->name == name)
+            return &*it;
+        return nullptr;
+    }
+
+    static bool name_less(const Slot &slot, const std::string &name) {
+        return slot.name < name;
+    }
+
+    template <class Return_Type, class Unused = void> struct Returned {
+
+        static Return_Type take(void *pointer) {
+            Return_Type * rptr = reinterpret_cast<Return_Type *> (pointer);
+            Return_Type ret = *rptr;
+            delete rptr;
+            return ret;
+        }
+    };
+
+    template <class Unused> struct Returned<void, Unused> {
+
+        static void take(void *) {
+        }
+    };
+
+public:
+
+    /**
+     *  \brief Empty default constructor. Allocates nothing.
+     */
+    Compact_Object() : my_body(nullptr) {
+    }
+
+    /**
+     *  \brief Standard copy constructor.
+     */
+    Compact_Object(const Compact_Object &o) : my_body(nullptr) {
+        if (o.my_body != nullptr)
+            this->my_body = new Body(*o.my_body);
+    }
+
+    /**
+     *  \brief Move constructor. Takes over o's body.
+     */
+    Compact_Object(Compact_Object &&o) : my_body(o.my_body) {
+        o.my_body = nullptr;
+    }
+
+    /**
+     *  \brief Non-virtual destructor.
+     */
+    ~Compact_Object() {
+        delete this->my_body;
+    }
+
+    /**
+     *  \brief Standard assignment operator
+     */
+    Compact_Object& operator =(const Compact_Object &other) {
+        if (this != &other) {
+            Body * copy = other.my_body == nullptr ? nullptr
+                    : new Body(*other.my_body);
+            delete this->my_body;
+            this->my_body = copy;
+        }
+        return *this;
+    }
+
+    /**
+     *  \brief Move assignment. Takes over other's body.
+     */
+    Compact_Object& operator =(Compact_Object &&other) {
+        if (this != &other) {
+            delete this->my_body;
+            this->my_body = other.my_body;
+            other.my_body = nullptr;
+        }
+        return *this;
+    }
+
+    /**  \brief Sets the parent of this Compact_Object to another one
+     *  @param other_object - new parent
+     */
+    inline void setParent(Compact_Object &other_object) {
+        if (&other_object != this)
+            this->body().my_parent = &other_object;
+        else {
+            printf("In Compact_Object.setParent, Compact_Object is not allowed "
+                    "to set its parent pointer to itself.\n  "
+                    "See line number %d in file %s\n\n", __LINE__, __FILE__);
+            return;
+        }
+    }
+
+    /**
+     *   \brief Passes the properties from one Compact_Object to another
+     */
+    inline void pass_contents(const Compact_Object &other) {
+        if (other.my_body == nullptr) {
+            if (this->my_body != nullptr)
+                this->my_body->slots.clear();
+            return;
+        }
+        this->body().slots = other.my_body->slots;
+    }
+
+    /**
+     *  \brief Sets function pointer execute_me to the address of a static function.
+     * @param function_pointer - a generic 64-bit function pointer
+     */
+    template <class Type> void setFunc(Type function_pointer) {
+        if (function_pointer != nullptr && (sizeof (function_pointer) ==
+                sizeof (pcast))) {
+            this->body().execute_me = (pcast) function_pointer;
+            return;
+        } else {
+            printf("In Compact_Object.setFunc, function pointer is null or "
+                    "function cannot safely be assigned.\n  "
+                    "See line number %d in file %s\n\n", __LINE__, __FILE__);
+            return;
+        }
+    }
+
+    /**
+     * Add a single object property with key string::name and generic value.
+     * @param name - name that will be used to retrieve value
+     * @param value - a generic value to be added
+     */
+    template <class Type> void set(const std::string &name, const Type &value) {
+        std::shared_ptr<void> p = std::static_pointer_cast<void>
+                (std::allocate_shared<Type>(Object::Allocator<Type>(), value));
+        std::vector<Slot> &slots = this->body().slots;
+        auto it = std::lower_bound(slots.begin(), slots.end(), name,
+                Compact_Object::name_less);
+        if (it != slots.end() && it->name == name) {
+            it->p = p;
+            it->t = Object::descriptor<Type>();
+        } else {
+            Slot slot = {name, p, Object::descriptor<Type>()};
+            slots.insert(it, slot);
+        }
+    }
+
+    /**
+     *  \brief Alias for Compact_Object.set
+     */
+    template <typename... Args>
+    auto add(Args&&... args) -> decltype(set(std::forward<Args>(args)...)) {
+        return set(std::forward<Args>(args)...);
+    }
+
+    /**
+     * \brief Removes the property name from this object. The parent tree is
+     * not affected.
+     * @param name - name of the property to remove
+     * @return true if this object had the property
+     */
+    bool remove(const std::string &name) {
+        if (this->my_body == nullptr)
+            return false;
+        std::vector<Slot> &slots = this->my_body->slots;
+        auto it = std::lower_bound(slots.begin(), slots.end(), name,
+                Compact_Object::name_less);
+        if (it == slots.end() || it->name != name)
+            return false;
+        slots.erase(it);
+        return true;
+    }
+
+    /**
+     * \brief Removes every property of this object. The function pointer and
+     * parent are kept, and so is the capacity of the property vector.
+     */
+    void clear() {
+        if (this->my_body != nullptr)
+            this->my_body->slots.clear();
+    }
+
+    /**
+     * \brief Checks to see if this object or its parent has a variable named
+     * name.
+     */
+    bool has(const std::string &name) const {
+        if (this->find(name) != nullptr)
+            return true;
+        Compact_Object * parent = this->parent();
+        return parent != nullptr && parent->has(name);
+    }
+
+    /**
+     * \brief Checks to see if this object has a variable named name.
+     */
+    bool hasOwnProperty(const std::string &name) const {
+        return this->find(name) != nullptr;
+    }
+
+    /**
+     * \brief Checks to see if this object or its parent has a variable named
+     * name of type Element_Type.
+     */
+    template <class Element_Type> bool has(const std::string &name) const {
+        const Slot * slot = this->find(name);
+        if (slot != nullptr)
+            return slot->t == Object::descriptor<Element_Type>();
+        Compact_Object * parent = this->parent();
+        return parent != nullptr && parent->has<Element_Type>(name);
+    }
+
+    /**
+     * \brief Checks to see if this object has a variable named name of type
+     * Element_Type.
+     */
+    template <class Element_Type> bool hasOwnProperty
+    (const std::string &name) const {
+        const Slot * slot = this->find(name);
+        return slot != nullptr && slot->t == Object::descriptor<Element_Type>();
+    }
+
+    /**
+     * \brief Retrieves an element from this object or its parent tree.
+     * Throws -1 when name cannot be found or has another type.
+     */
+    template <class Return_Type> Return_Type get(const std::string &name) const {
+        const Slot * slot = this->find(name);
+        if (slot != nullptr) {
+            if (slot->t == Object::descriptor<Return_Type>())
+                return *static_cast<const Return_Type *> (slot->p.get());
+            printf("In Compact_Object.get<class Return_Type>(\"%s\"), "
+                    "template Return_Type does not match up with a "
+                    "retrievable member's type.\n"
+                    "  See line number %d in file %s\n\n",
+                    name.c_str(), __LINE__, __FILE__);
+            throw -1;
+        }
+        Compact_Object * parent = this->parent();
+        if (parent != nullptr)
+            return parent->get<Return_Type>(name);
+        printf("In Compact_Object.get<class Return_Type>(\"%s\"), "
+                "parameter \"%s\" does not correspond to a named "
+                "element.\n  See line number %d in file %s\n\n",
+                name.c_str(), name.c_str(), __LINE__, __FILE__);
+        throw -1;
+    }
+
+    /**
+     * \brief Directly calls the function pointer of this object, or of its
+     * parent tree. Same conventions as Object.call.
+     */
+    template <class Return_Type = void, class ...A>
+    Return_Type call(A... Parameters) {
+        if (this->my_body != nullptr && this->my_body->execute_me != nullptr) {
+            return Returned<Return_Type>::take
+                    (this->my_body->execute_me(Parameters...));
+        }
+        Compact_Object * parent = this->parent();
+        if (parent != nullptr)
+            return parent->call<Return_Type>(Parameters...);
+        printf("In Compact_Object.call, function pointer passed to call is "
+                "nullptr.\n  See line number %d in file %s\n\n",
+                __LINE__, __FILE__);
+        throw -1;
+    }
+
+    /**
+     * \brief Executes a function by its function name. The name must refer to
+     * a Compact_Object, or an Object, whose call function is performed.
+     */
+    template<class Return_Type = void, class ...A> Return_Type exec
+    (const std::string &function_name, A... Parameters) {
+        const Slot * slot = this->find(function_name);
+        if (slot != nullptr) {
+            if (slot->t == Object::descriptor<Compact_Object>())
+                return static_cast<Compact_Object *> (slot->p.get())
+                ->call<Return_Type>(Parameters...);
+            if (slot->t->is_object)
+                return static_cast<Object *> (slot->p.get())
+                ->call<Return_Type>(Parameters...);
+            printf("Compact_Object.exec(\"%s\") does not reference a callable "
+                    "Object.\n  See line number %d in file %s\n\n",
+                    function_name.c_str(), __LINE__, __FILE__);
+            throw -1;
+        }
+        Compact_Object * parent = this->parent();
+        if (parent != nullptr)
+            return parent->exec<Return_Type>(function_name, Parameters...);
+        printf("Function pointer named \"%s\" referenced by "
+                "Compact_Object.exec cannot be found.\n  "
+                "See line number %d in file %s\n\n",
+                function_name.c_str(), __LINE__, __FILE__);
+        throw -1;
+    }
+
+    /**
+     * \brief Executes a standard function by name. Same conventions as
+     * Object.lexec.
+     */
+    template<class Standard_Function, class Return_Type = void, class ...A>
+    Return_Type lexec(const std::string &function_name, A... Parameters) {
+        const Slot * slot = this->find(function_name);
+        if (slot != nullptr) {
+            if (slot->t == Object::descriptor<Standard_Function>())
+                return (*static_cast<Standard_Function *> (slot->p.get()))
+                (Parameters...);
+            printf("Wrong standard function class referenced by "
+                    "Compact_Object.lexec<class Standard_Function>(\"%s\").\n  "
+                    "See line number %d in file %s\n\n",
+                    function_name.c_str(), __LINE__, __FILE__);
+            throw -1;
+        }
+        Compact_Object * parent = this->parent();
+        if (parent != nullptr)
+            return parent->lexec<Standard_Function, Return_Type>
+                (function_name, Parameters...);
+        printf("In Compact_Object.lexec, std::function \"%s\" could not be "
+                "found.\n  See line number %d in file %s\n\n",
+                function_name.c_str(), __LINE__, __FILE__);
+        throw -1;
+    }
+};
+#endif    // PROTOTYPAL_C_COMPACT_OBJECT_H_
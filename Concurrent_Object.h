@@ -0,0 +1,336 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+/*
+ * File:   Concurrent_Object.h
+ * Created on October 18, 2026
+ */
+
+#ifndef PROTOTYPAL_C_CONCURRENT_OBJECT_H_
+#define PROTOTYPAL_C_CONCURRENT_OBJECT_H_
+
+#if __cplusplus < 201402L
+#error "Concurrent_Object.h requires C++14 for std::shared_timed_mutex"
+#endif
+
+#include "Prototypal_Cpp.h"
+#include <stdio.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+/**  \brief Object that may be used from many threads at once.
+ *  Properties are spread over Shard_Count shards by the hash of their name.
+ *  Each shard has its own reader/writer lock on its own cache line, so reads
+ *  never block each other and writes only block accesses to the same shard.
+ *  The parent and function pointers are atomics.
+ *  get returns a copy of the value made under the shard's read lock. exec and
+ *  lexec copy the callable's shared pointer under the lock and call it after
+ *  releasing the lock, so a callable may use this object again.
+ */
+template <std::size_t Shard_Count = 16> class Concurrent_Object {
+
+    static_assert(Shard_Count > 0, "Concurrent_Object needs at least one shard");
+
+    /**  \brief A property value and the descriptor of its type.
+     */
+    struct Slot {
+        std::shared_ptr<void> p;
+        const Object::Type_Descriptor * t;
+    };
+
+    /**  \brief One lock and the properties it protects, padded to a cache
+     *  line so that shards do not share lines.
+     */
+    struct alignas(64) Shard {
+        mutable std::shared_timed_mutex mutex;
+        std::unordered_map<std::string, Slot> contents;
+    };
+
+    Shard my_shards[Shard_Count];
+    std::atomic<pcast> execute_me;
+    std::atomic<Concurrent_Object *> my_parent;
+
+    Shard & shard_of(const std::string &name) {
+        return this->my_shards[std::hash<std::string>()(name) % Shard_Count];
+    }
+
+    const Shard & shard_of(const std::string &name) const {
+        return this->my_shards[std::hash<std::string>()(name) % Shard_Count];
+    }
+
+    /**
+     *  \brief Copies the slot named name out of this object.
+     *  @return false if this object has no such property
+     */
+    bool find(const std::string &name, Slot &out) const {
+        const Shard &shard = this->shard_of(name);
+        std::shared_lock<std::shared_timed_mutex> lock(shard.mutex);
+        auto pair = shard.contents.find(name);
+        if (pair == shard.contents.end())
+            return false;
+        out = pair->second;
+        return true;
+    }
+
+    template <class Return_Type, class Unused = void> struct Returned {
+
+        static Return_Type take(void *pointer) {
+            Return_Type * rptr = reinterpret_cast<Return_Type *> (pointer);
+            Return_Type ret = *rptr;
+            delete rptr;
+            return ret;
+        }
+    };
+
+    template <class Unused> struct Returned<void, Unused> {
+
+        static void take(void *) {
+        }
+    };
+
+public:
+
+    /**
+     *  \brief Empty default constructor.
+     */
+    Concurrent_Object() : execute_me(nullptr), my_parent(nullptr) {
+    }
+
+    Concurrent_Object(const Concurrent_Object &) = delete;
+    Concurrent_Object& operator =(const Concurrent_Object &) = delete;
+
+    /**  \brief Sets the parent of this object. Visible to other threads
+     *  once this returns.
+     *  @param other_object - new parent
+     */
+    void setParent(Concurrent_Object &other_object) {
+        if (&other_object != this)
+            this->my_parent.store(&other_object, std::memory_order_release);
+        else {
+            printf("In Concurrent_Object.setParent, Concurrent_Object is not "
+                    "allowed to set its parent pointer to itself.\n  "
+                    "See line number %d in file %s\n\n", __LINE__, __FILE__);
+            return;
+        }
+    }
+
+    /**
+     *  \brief Sets function pointer execute_me to the address of a static function.
+     */
+    template <class Type> void setFunc(Type function_pointer) {
+        if (function_pointer != nullptr && (sizeof (function_pointer) ==
+                sizeof (pcast))) {
+            this->execute_me.store((pcast) function_pointer,
+                    std::memory_order_release);
+            return;
+        } else {
+            printf("In Concurrent_Object.setFunc, function pointer is null or "
+                    "function cannot safely be assigned.\n  "
+                    "See line number %d in file %s\n\n", __LINE__, __FILE__);
+            return;
+        }
+    }
+
+    /**
+     * \brief Adds or replaces the property name. Takes the write lock of one
+     * shard. The value is copied before the lock is taken.
+     */
+    template <class Type> void set(const std::string &name, const Type &value) {
+        Slot slot = {
+            std::static_pointer_cast<void>(std::allocate_shared<Type>
+            (Object::Allocator<Type>(), value)), Object::descriptor<Type>()
+        };
+        Shard &shard = this->shard_of(name);
+        std::unique_lock<std::shared_timed_mutex> lock(shard.mutex);
+        // The old value is released after the lock, by slot's destructor.
+        std::swap(shard.contents[name], slot);
+    }
+
+    /**
+     *  \brief Alias for Concurrent_Object.set
+     */
+    template <typename... Args>
+    auto add(Args&&... args) -> decltype(set(std::forward<Args>(args)...)) {
+        return set(std::forward<Args>(args)...);
+    }
+
+    /**
+     * \brief Removes the property name from this object.
+     * @return true if this object had the property
+     */
+    bool remove(const std::string &name) {
+        Slot old = Slot();
+        Shard &shard = this->shard_of(name);
+        std::unique_lock<std::shared_timed_mutex> lock(shard.mutex);
+        auto pair = shard.contents.find(name);
+        if (pair == shard.contents.end())
+            return false;
+        std::swap(pair->second, old);
+        shard.contents.erase(pair);
+        return true;
+    }
+
+    /**
+     * \brief Checks to see if this object or its parent has a variable named
+     * name.
+     */
+    bool has(const std::string &name) const {
+        if (this->hasOwnProperty(name))
+            return true;
+        Concurrent_Object * parent = this->my_parent.load(std::memory_order_acquire);
+        return parent != nullptr && parent->has(name);
+    }
+
+    /**
+     * \brief Checks to see if this object has a variable named name.
+     */
+    bool hasOwnProperty(const std::string &name) const {
+        const Shard &shard = this->shard_of(name);
+        std::shared_lock<std::shared_timed_mutex> lock(shard.mutex);
+        return shard.contents.count(name) != 0;
+    }
+
+    /**
+     * \brief Checks to see if this object or its parent has a variable named
+     * name of type Element_Type.
+     */
+    template <class Element_Type> bool has(const std::string &name) const {
+        Slot slot;
+        if (this->find(name, slot))
+            return slot.t == Object::descriptor<Element_Type>();
+        Concurrent_Object * parent = this->my_parent.load(std::memory_order_acquire);
+        return parent != nullptr && parent->template has<Element_Type>(name);
+    }
+
+    /**
+     * \brief Checks to see if this object has a variable named name of type
+     * Element_Type.
+     */
+    template <class Element_Type> bool hasOwnProperty
+    (const std::string &name) const {
+        const Shard &shard = this->shard_of(name);
+        std::shared_lock<std::shared_timed_mutex> lock(shard.mutex);
+        auto pair = shard.contents.find(name);
+        return pair != shard.contents.end() &&
+                pair->second.t == Object::descriptor<Element_Type>();
+    }
+
+    /**
+     * \brief Retrieves a copy of an element from this object or its parent
+     * tree. Throws -1 when name cannot be found or has another type.
+     */
+    template <class Return_Type> Return_Type get(const std::string &name) const {
+        {
+            const Shard &shard = this->shard_of(name);
+            std::shared_lock<std::shared_timed_mutex> lock(shard.mutex);
+            auto pair = shard.contents.find(name);
+            if (pair != shard.contents.end()) {
+                if (pair->second.t == Object::descriptor<Return_Type>())
+                    return *static_cast<const Return_Type *>
+                        (pair->second.p.get());
+                printf("In Concurrent_Object.get<class Return_Type>(\"%s\"), "
+                        "template Return_Type does not match up with a "
+                        "retrievable member's type.\n"
+                        "  See line number %d in file %s\n\n",
+                        name.c_str(), __LINE__, __FILE__);
+                throw -1;
+            }
+        }
+        Concurrent_Object * parent = this->my_parent.load(std::memory_order_acquire);
+        if (parent != nullptr)
+            return parent->template get<Return_Type>(name);
+        printf("In Concurrent_Object.get<class Return_Type>(\"%s\"), "
+                "parameter \"%s\" does not correspond to a named "
+                "element.\n  See line number %d in file %s\n\n",
+                name.c_str(), name.c_str(), __LINE__, __FILE__);
+        throw -1;
+    }
+
+    /**
+     * \brief Directly calls the function pointer of this object, or of its
+     * parent tree. Same conventions as Object.call.
+     */
+    template <class Return_Type = void, class ...A>
+    Return_Type call(A... Parameters) {
+        pcast f = this->execute_me.load(std::memory_order_acquire);
+        if (f != nullptr)
+            return Returned<Return_Type>::take(f(Parameters...));
+        Concurrent_Object * parent = this->my_parent.load(std::memory_order_acquire);
+        if (parent != nullptr)
+            return parent->template call<Return_Type>(Parameters...);
+        printf("In Concurrent_Object.call, function pointer passed to call is "
+                "nullptr.\n  See line number %d in file %s\n\n",
+                __LINE__, __FILE__);
+        throw -1;
+    }
+
+    /**
+     * \brief Executes a function by its function name. The name must refer to
+     * an Object whose call function is performed. The Object is called
+     * outside of any lock and should not be modified concurrently.
+     */
+    template<class Return_Type = void, class ...A> Return_Type exec
+    (const std::string &function_name, A... Parameters) {
+        Slot slot;
+        if (this->find(function_name, slot)) {
+            if (slot.t->is_object)
+                return static_cast<Object *> (slot.p.get())
+                ->call<Return_Type>(Parameters...);
+            printf("Concurrent_Object.exec(\"%s\") does not reference a "
+                    "callable Object.\n  See line number %d in file %s\n\n",
+                    function_name.c_str(), __LINE__, __FILE__);
+            throw -1;
+        }
+        Concurrent_Object * parent = this->my_parent.load(std::memory_order_acquire);
+        if (parent != nullptr)
+            return parent->template exec<Return_Type>(function_name, Parameters...);
+        printf("Function pointer named \"%s\" referenced by "
+                "Concurrent_Object.exec cannot be found.\n  "
+                "See line number %d in file %s\n\n",
+                function_name.c_str(), __LINE__, __FILE__);
+        throw -1;
+    }
+
+    /**
+     * \brief Executes a standard function by name, outside of any lock. Same
+     * conventions as Object.lexec.
+     */
+    template<class Standard_Function, class Return_Type = void, class ...A>
+    Return_Type lexec(const std::string &function_name, A... Parameters) {
+        Slot slot;
+        if (this->find(function_name, slot)) {
+            if (slot.t == Object::descriptor<Standard_Function>())
+                return (*static_cast<Standard_Function *> (slot.p.get()))
+                (Parameters...);
+            printf("Wrong standard function class referenced by "
+                    "Concurrent_Object.lexec<class Standard_Function>(\"%s\")."
+                    "\n  See line number %d in file %s\n\n",
+                    function_name.c_str(), __LINE__, __FILE__);
+            throw -1;
+        }
+        Concurrent_Object * parent = this->my_parent.load(std::memory_order_acquire);
+        if (parent != nullptr)
+            return parent->template lexec<Standard_Function, Return_Type>
+                (function_name, Parameters...);
+        printf("In Concurrent_Object.lexec, std::function \"%s\" could not be "
+                "found.\n  See line number %d in file %s\n\n",
+                function_name.c_str(), __LINE__, __FILE__);
+        throw -1;
+    }
+};
+#endif    // PROTOTYPAL_C_CONCURRENT_OBJECT_H_
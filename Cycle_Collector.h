@@ -0,0 +1,425 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+/*
+ * File:   Cycle_Collector.h
+ * Created on October 18, 2026
+ */
+
+#ifndef PROTOTYPAL_C_CYCLE_COLLECTOR_H_
+#define PROTOTYPAL_C_CYCLE_COLLECTOR_H_
+
+#include "Prototypal_Cpp.h"
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+/**  \brief Reclaims cycles of Objects that keep each other alive through
+ *  shared_ptr properties.
+ *
+ *  Every Object held in a shared_ptr, either stored directly as a property or
+ *  stored as a std::shared_ptr<Object> property, is a candidate. For a
+ *  candidate the collector walks the Objects reachable through such
+ *  properties and counts, for each of them, the references coming from
+ *  inside that subgraph (trial deletion). An Object whose use_count is higher
+ *  has an outside owner, and it and everything it reaches is live. The rest
+ *  of the subgraph is only owned by itself, so it is emptied as by
+ *  Object::clear, frozen or not: change hooks see change_clear and memoized
+ *  results and versions are dropped. That breaks the cycle and frees it.
+ *
+ *  References held by std::function captures and other opaque values are not
+ *  visible to the collector: those Objects look externally owned and are
+ *  never reclaimed. A candidate found alive max_examinations times in a row
+ *  is dropped, so that such Objects are not examined forever and their
+ *  weak pointers do not keep their memory allocated; it becomes a
+ *  candidate again the next time it is stored. my_parent pointers are not
+ *  owning either, so a reclaimed Object must not be anyone's parent. The collector must not run while other
+ *  threads modify the Objects it may visit.
+ */
+class Cycle_Collector {
+public:
+
+    /**  \brief What one or more collection steps did.
+     */
+    struct Result {
+        /** Objects freed */
+        std::size_t objects;
+        /** estimated bytes freed, from Object::memory_usage */
+        std::size_t bytes;
+        /** Objects examined */
+        std::size_t visited;
+        /** candidates still waiting, including oversized ones */
+        std::size_t pending;
+    };
+
+private:
+
+    /**  \brief An Object found during a walk.
+     */
+    struct Node {
+        /** owners of the Object, from its shared_ptr */
+        long use_count;
+        /** owners of the Object inside the walked subgraph */
+        long internal;
+        bool live;
+        /** an owning pointer to the Object, in a property of another node */
+        const std::shared_ptr<void> * via_value;
+        const std::shared_ptr<Object> * via_pointer;
+    };
+
+    typedef std::vector<std::pair<const std::string *,
+    const Object::Shared_Pointer_And_Type *> > Slot_List;
+
+    typedef std::set<std::weak_ptr<Object>,
+    std::owner_less<std::weak_ptr<Object> > > Candidate_Set;
+
+    /**  \brief An Object waiting to be examined.
+     */
+    struct Candidate {
+        std::weak_ptr<Object> object;
+        /** times it was examined and found alive */
+        std::size_t examinations;
+    };
+
+    std::mutex my_mutex;
+    /**
+     *   \brief Candidates in the order they will be examined
+     */
+    std::deque<Candidate> my_candidates;
+    /**
+     *   \brief Candidates whose subgraph was larger than a step's budget.
+     *   Only examined by collect().
+     */
+    std::deque<Candidate> my_oversized;
+    /**
+     *   \brief Everything in my_candidates and my_oversized, for de-duplication
+     */
+    Candidate_Set my_queued;
+    Result my_totals;
+    std::size_t my_max_examinations;
+
+    Cycle_Collector() : my_mutex(), my_candidates(), my_oversized(),
+    my_queued(), my_totals(), my_max_examinations(8) {
+    }
+
+    /**
+     *  \brief Installed as Object::slot_hook while the collector is enabled.
+     */
+    static void on_slot(const std::shared_ptr<void> &value,
+            const Object::Type_Descriptor * type) {
+        if (type->is_object)
+            Cycle_Collector::instance().track(std::static_pointer_cast<Object>
+                (value));
+        else if (type == Object::descriptor<std::shared_ptr<Object> >())
+            Cycle_Collector::instance().track
+                (*static_cast<const std::shared_ptr<Object> *> (value.get()));
+    }
+
+    /**
+     *  \brief Adds the Objects owned by properties of o to the walk.
+     *  @return false if the walk grew past budget
+     */
+    static bool expand(Object *o, std::unordered_map<Object *, Node> &nodes,
+            std::vector<Object *> &order, std::size_t budget) {
+        Slot_List slots;
+        o->for_each_slot(Object::Slot_Collector(slots));
+        for (std::size_t i = 0; i < slots.size(); ++i) {
+            const Object::Shared_Pointer_And_Type &spt = *slots[i].second;
+            if (spt.p == nullptr || spt.t == nullptr)
+                continue;
+            Object * child = nullptr;
+            long use_count = 0;
+            const std::shared_ptr<void> * via_value = nullptr;
+            const std::shared_ptr<Object> * via_pointer = nullptr;
+            if (spt.t->is_object) {
+                child = static_cast<Object *> (spt.p.get());
+                use_count = spt.p.use_count();
+                via_value = &spt.p;
+            } else if (spt.t == Object::descriptor<std::shared_ptr<Object> >()) {
+                via_pointer = static_cast<const std::shared_ptr<Object> *>
+                        (spt.p.get());
+                child = via_pointer->get();
+                use_count = via_pointer->use_count();
+            }
+            if (child == nullptr)
+                continue;
+            auto found = nodes.find(child);
+            if (found == nodes.end()) {
+                if (nodes.size() >= budget)
+                    return false;
+                Node n = {use_count, 1, false, via_value, via_pointer};
+                nodes[child] = n;
+                order.push_back(child);
+            } else {
+                ++found->second.internal;
+            }
+        }
+        return true;
+    }
+
+    /**
+     *  \brief Marks o and every node reachable from it as live.
+     */
+    static void mark_live(Object *o, std::unordered_map<Object *, Node> &nodes) {
+        std::vector<Object *> work(1, o);
+        while (!work.empty()) {
+            Object * current = work.back();
+            work.pop_back();
+            Node &n = nodes[current];
+            if (n.live)
+                continue;
+            n.live = true;
+            Slot_List slots;
+            current->for_each_slot(Object::Slot_Collector(slots));
+            for (std::size_t i = 0; i < slots.size(); ++i) {
+                const Object::Shared_Pointer_And_Type &spt = *slots[i].second;
+                if (spt.p == nullptr || spt.t == nullptr)
+                    continue;
+                Object * child = nullptr;
+                if (spt.t->is_object)
+                    child = static_cast<Object *> (spt.p.get());
+                else if (spt.t ==
+                        Object::descriptor<std::shared_ptr<Object> >())
+                    child = static_cast<const std::shared_ptr<Object> *>
+                        (spt.p.get())->get();
+                if (child != nullptr && nodes.count(child) != 0 &&
+                        !nodes[child].live)
+                    work.push_back(child);
+            }
+        }
+    }
+
+    /**
+     *  \brief Trial deletion of the subgraph reachable from root.
+     *  @return false, leaving everything untouched, if the subgraph has more
+     *  than budget Objects
+     */
+    static bool examine(const std::shared_ptr<Object> &root, std::size_t budget,
+            Result &result) {
+        std::unordered_map<Object *, Node> nodes;
+        std::vector<Object *> order;
+        // The root's count includes the caller's lock of the weak_ptr.
+        Node r = {root.use_count() - 1, 0, false, nullptr, nullptr};
+        nodes[root.get()] = r;
+        order.push_back(root.get());
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            if (!expand(order[i], nodes, order, budget))
+                return false;
+        }
+        result.visited += order.size();
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            Node &n = nodes[order[i]];
+            if (!n.live && n.use_count > n.internal)
+                mark_live(order[i], nodes);
+        }
+        // Hold every garbage Object before touching any of them.
+        std::vector<std::shared_ptr<void> > keep;
+        std::vector<Object *> garbage;
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            Node &n = nodes[order[i]];
+            if (n.live)
+                continue;
+            garbage.push_back(order[i]);
+            if (n.via_value != nullptr)
+                keep.push_back(*n.via_value);
+            else if (n.via_pointer != nullptr)
+                keep.push_back(*n.via_pointer);
+            else
+                keep.push_back(root);
+        }
+        std::vector<Object::Contents> dead(garbage.size());
+        std::vector<std::shared_ptr<const Object::Frozen_Table> >
+                dead_frozen(garbage.size());
+        for (std::size_t i = 0; i < garbage.size(); ++i) {
+            Object::Memory_Usage usage = garbage[i]->memory_usage(false);
+            result.bytes += usage.total() - usage.nested_objects;
+            garbage[i]->release_contents(dead[i], dead_frozen[i]);
+        }
+        result.objects += garbage.size();
+        dead.clear();
+        dead_frozen.clear();
+        keep.clear();
+        return true;
+    }
+
+public:
+
+    /**
+     *  \brief The process-wide collector.
+     */
+    static Cycle_Collector & instance() {
+        static Cycle_Collector collector;
+        return collector;
+    }
+
+    /**
+     *  \brief Makes every Object stored from now on a candidate.
+     */
+    void enable() {
+        Object::slot_hook().store(&Cycle_Collector::on_slot,
+                std::memory_order_release);
+    }
+
+    /**
+     *  \brief Stops adding candidates. Queued candidates are kept.
+     */
+    void disable() {
+        Object::slot_hook().store(nullptr, std::memory_order_release);
+    }
+
+    /**
+     *  \brief Makes an Object held in a shared_ptr a candidate.
+     */
+    void track(const std::shared_ptr<Object> &object) {
+        if (object == nullptr)
+            return;
+        Candidate c = {std::weak_ptr<Object>(object), 0};
+        std::lock_guard<std::mutex> lock(this->my_mutex);
+        if (this->my_queued.insert(c.object).second)
+            this->my_candidates.push_back(c);
+    }
+
+    /**
+     *  \brief Sets how many times a candidate is found alive before it is
+     *  dropped, 8 by default.
+     */
+    void set_max_examinations(std::size_t n) {
+        std::lock_guard<std::mutex> lock(this->my_mutex);
+        this->my_max_examinations = n;
+    }
+
+    /**
+     * \brief Examines candidates until max_objects Objects have been
+     * visited, which bounds the pause. A candidate whose subgraph alone is
+     * larger than max_objects is set aside for collect(). Live candidates go
+     * back to the end of the queue until they were examined
+     * max_examinations times, expired ones are dropped.
+     * @return what this step did
+     */
+    Result step(std::size_t max_objects = 1024) {
+        Result result = Result();
+        std::size_t remaining;
+        {
+            std::lock_guard<std::mutex> lock(this->my_mutex);
+            remaining = this->my_candidates.size();
+        }
+        while (remaining-- > 0 && result.visited < max_objects) {
+            Candidate c;
+            {
+                std::lock_guard<std::mutex> lock(this->my_mutex);
+                if (this->my_candidates.empty())
+                    break;
+                c = this->my_candidates.front();
+                this->my_candidates.pop_front();
+            }
+            std::shared_ptr<Object> root = c.object.lock();
+            if (root == nullptr) {
+                std::lock_guard<std::mutex> lock(this->my_mutex);
+                this->my_queued.erase(c.object);
+                continue;
+            }
+            std::size_t budget = max_objects - result.visited;
+            if (examine(root, budget, result)) {
+                root.reset();
+                this->requeue(c);
+            } else if (budget < max_objects) {
+                // Might fit in a fresh step.
+                std::lock_guard<std::mutex> lock(this->my_mutex);
+                this->my_candidates.push_front(c);
+                break;
+            } else {
+                std::lock_guard<std::mutex> lock(this->my_mutex);
+                this->my_oversized.push_back(c);
+            }
+        }
+        return this->finish(result);
+    }
+
+    /**
+     * \brief Examines every candidate, including oversized ones, with no
+     * bound on the pause.
+     * @return what this collection did
+     */
+    Result collect() {
+        Result result = Result();
+        std::size_t count = 0;
+        {
+            std::lock_guard<std::mutex> lock(this->my_mutex);
+            this->my_candidates.insert(this->my_candidates.end(),
+                    this->my_oversized.begin(), this->my_oversized.end());
+            this->my_oversized.clear();
+            count = this->my_candidates.size();
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            Candidate c;
+            {
+                std::lock_guard<std::mutex> lock(this->my_mutex);
+                if (this->my_candidates.empty())
+                    break;
+                c = this->my_candidates.front();
+                this->my_candidates.pop_front();
+            }
+            std::shared_ptr<Object> root = c.object.lock();
+            if (root == nullptr) {
+                std::lock_guard<std::mutex> lock(this->my_mutex);
+                this->my_queued.erase(c.object);
+                continue;
+            }
+            // An unbounded budget always succeeds.
+            examine(root, (std::size_t) - 1, result);
+            root.reset();
+            this->requeue(c);
+        }
+        return this->finish(result);
+    }
+
+    /**
+     *  \brief Totals of every step and collection so far.
+     */
+    Result totals() {
+        std::lock_guard<std::mutex> lock(this->my_mutex);
+        Result result = this->my_totals;
+        result.pending = this->my_candidates.size() + this->my_oversized.size();
+        return result;
+    }
+
+private:
+
+    /**
+     *  \brief Queues an examined candidate again, or drops it once it was
+     *  found alive max_examinations times. A freed candidate expires and is
+     *  dropped when it comes up again.
+     */
+    void requeue(Candidate c) {
+        std::lock_guard<std::mutex> lock(this->my_mutex);
+        c.examinations += 1;
+        if (c.examinations >= this->my_max_examinations && !c.object.expired())
+            this->my_queued.erase(c.object);
+        else
+            this->my_candidates.push_back(c);
+    }
+
+    Result finish(Result result) {
+        std::lock_guard<std::mutex> lock(this->my_mutex);
+        result.pending = this->my_candidates.size() + this->my_oversized.size();
+        this->my_totals.objects += result.objects;
+        this->my_totals.bytes += result.bytes;
+        this->my_totals.visited += result.visited;
+        return result;
+    }
+};
+#endif    // PROTOTYPAL_C_CYCLE_COLLECTOR_H_
@@ -0,0 +1,458 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+/*
+ * File:   Mapped_Object.h
+ * Created on October 18, 2026
+ */
+
+#ifndef PROTOTYPAL_C_MAPPED_OBJECT_H_
+#define PROTOTYPAL_C_MAPPED_OBJECT_H_
+
+#include "Prototypal_Cpp.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**  \brief Read-only view of an Object in a file written by
+ *  Mapped_Object::write, queried in place through mmap.
+ *
+ *  Opening a file maps it and checks its header; nothing is read or
+ *  allocated per property. Every Object of the file has a minimal perfect
+ *  hash table of its properties, like a frozen Object, so a lookup is one
+ *  hash, one seed load and one name comparison on the mapped pages.
+ *  Parents and nested Objects are numbers into the file, not pointers, and
+ *  are reached as other Mapped_Objects over the same mapping. Processes
+ *  mapping the same file share its pages through the page cache.
+ *
+ *  Arithmetic and other trivially copyable values are returned as
+ *  references into the mapping. Strings and values with custom
+ *  serializers are decoded into a copy. Values must be of registered
+ *  types, as for Object::save. The format is in host byte order.
+ *  Views are cheap to copy and keep the mapping alive.
+ */
+class Mapped_Object {
+
+    /**  \brief Start of the file.
+     */
+    struct File_Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t byte_order;
+        uint32_t unused;
+        uint64_t file_size;
+        uint64_t object_count;
+        /** offset of object_count Records, the first one is the root */
+        uint64_t objects;
+    };
+
+    /**  \brief One Object: count / 2 + 1 uint32_t seeds at seeds, then
+     *  count Entries at entries, placed by Object::Frozen_Table::place on
+     *  Object::type_id of their names.
+     */
+    struct Record {
+        /** number of the parent plus one, 0 for none */
+        uint64_t parent;
+        uint64_t count;
+        uint64_t seeds;
+        uint64_t entries;
+    };
+
+    struct Entry {
+        uint64_t name;
+        uint64_t name_length;
+        /** one of the kinds below */
+        uint64_t kind;
+        /** registered id of the value's type */
+        uint64_t type;
+        /** offset of the serialized value, or the number of the Object */
+        uint64_t value;
+        uint64_t value_length;
+    };
+
+    static const uint32_t mapped_magic = 0x4f4d4350; // "PCMO"
+    static const uint32_t mapped_version = 1;
+    static const uint32_t mapped_byte_order = 0x01020304;
+    static const uint64_t empty_kind = 0;
+    static const uint64_t object_kind = 1;
+    static const uint64_t value_kind = 2;
+
+    /**  \brief An open mapping, unmapped with the last view of it.
+     */
+    struct Mapping {
+        const char * base;
+        std::size_t size;
+
+        Mapping(const char * b, std::size_t n) : base(b), size(n) {
+        }
+
+        Mapping(const Mapping &) = delete;
+        Mapping& operator =(const Mapping &) = delete;
+
+        ~Mapping() {
+            munmap(const_cast<char *> (this->base), this->size);
+        }
+    };
+
+    std::shared_ptr<const Mapping> my_mapping;
+    const Record * my_record;
+
+    Mapped_Object(const std::shared_ptr<const Mapping> &mapping,
+            const Record * record) : my_mapping(mapping), my_record(record) {
+    }
+
+    static void fail(const char *caller, const std::string &name,
+            const char *problem, int line) {
+        printf("In Mapped_Object.%s(\"%s\"), %s.\n  "
+                "See line number %d in file %s\n\n",
+                caller, name.c_str(), problem, line, __FILE__);
+        throw -1;
+    }
+
+    static bool write_all(int fd, const char *p, std::size_t n) {
+        while (n > 0) {
+            ssize_t written = ::write(fd, p, n);
+            if (written < 0 && errno == EINTR)
+                continue;
+            if (written <= 0)
+                return false;
+            p += written;
+            n -= (std::size_t) written;
+        }
+        return true;
+    }
+
+    /**
+     *  \brief Bounds check of [offset, offset + length) in the mapping.
+     */
+    bool inside(uint64_t offset, uint64_t length) const {
+        return offset <= this->my_mapping->size &&
+                length <= this->my_mapping->size - offset;
+    }
+
+    const Record * record(uint64_t number) const {
+        const File_Header * header = reinterpret_cast<const File_Header *>
+                (this->my_mapping->base);
+        if (number >= header->object_count)
+            fail("get", "", "the file is corrupt", __LINE__);
+        return reinterpret_cast<const Record *> (this->my_mapping->base +
+                header->objects) + number;
+    }
+
+    /**
+     *  \brief The entry of the property name of this Object, nullptr if it
+     *  has none. Does not look at the parent.
+     */
+    const Entry * find_own(const std::string &name) const {
+        const Record &r = *this->my_record;
+        if (r.count == 0)
+            return nullptr;
+        const std::size_t bucket_count = (std::size_t) (r.count / 2 + 1);
+        if (!this->inside(r.seeds, bucket_count * sizeof (uint32_t)) ||
+                !this->inside(r.entries, r.count * sizeof (Entry)))
+            fail("get", name, "the file is corrupt", __LINE__);
+        const char * base = this->my_mapping->base;
+        std::size_t h = (std::size_t) Object::type_id(name);
+        uint32_t seed = reinterpret_cast<const uint32_t *> (base + r.seeds)
+                [Object::Frozen_Table::bucket(h, bucket_count)];
+        const Entry &e = reinterpret_cast<const Entry *> (base + r.entries)
+                [Object::Frozen_Table::position(h, seed, (std::size_t) r.count)];
+        if (e.name_length != name.size() || !this->inside(e.name, e.name_length)
+                || name.compare(0, name.size(), base + e.name,
+                (std::size_t) e.name_length) != 0)
+            return nullptr;
+        return &e;
+    }
+
+    /**
+     *  \brief The entry of name in this Object or its parent tree, and the
+     *  Object holding it.
+     */
+    const Entry * find(const std::string &name, Mapped_Object &holder) const {
+        holder = *this;
+        while (true) {
+            const Entry * e = holder.find_own(name);
+            if (e != nullptr || holder.my_record->parent == 0)
+                return e;
+            holder.my_record = holder.record(holder.my_record->parent - 1);
+        }
+    }
+
+    /**  \brief Reads a value of Type from the mapping: a reference for
+     *  types stored as their bytes, a decoded copy for the others.
+     */
+    template <class Type, bool Bytes = Object::Byte_Serial<Type>::value>
+    struct Value {
+        typedef const Type & type;
+
+        static const Type & read(const char * at, uint64_t length,
+                const std::string &name) {
+            if (length != sizeof (Type) ||
+                    (uintptr_t) at % std::alignment_of<Type>::value != 0)
+                fail("get", name, "the file is corrupt", __LINE__);
+            return *reinterpret_cast<const Type *> (at);
+        }
+    };
+
+    template <class Type> struct Value<Type, false> {
+        typedef Type type;
+
+        static Type read(const char * at, uint64_t length,
+                const std::string &name) {
+            const char * end = at + length;
+            std::shared_ptr<void> value =
+                    Object::descriptor<Type>()->deserialize(at, end);
+            if (value == nullptr || at != end)
+                fail("get", name, "the file is corrupt", __LINE__);
+            return *static_cast<const Type *> (value.get());
+        }
+    };
+
+    /**  \brief Output of Mapped_Object::write, built in memory.
+     */
+    struct File_Writer {
+        std::string data;
+
+        void align(std::size_t alignment) {
+            while (this->data.size() % alignment != 0)
+                this->data.push_back('\0');
+        }
+
+        template <class Type> Type * at(uint64_t offset) {
+            return reinterpret_cast<Type *> (&this->data[(std::size_t) offset]);
+        }
+
+        /**
+         *  \brief Appends o's seeds, entries, names and values, and fills
+         *  in its Record.
+         */
+        void add(const Object &o, uint64_t record,
+                const Object::Snapshot_Index &index) {
+            std::vector<std::pair<const std::string *,
+                    const Object::Shared_Pointer_And_Type *> > slots;
+            o.for_each_slot(Object::Slot_Collector(slots));
+            std::vector<std::size_t> hashes(slots.size());
+            for (std::size_t i = 0; i < slots.size(); ++i)
+                hashes[i] = (std::size_t) Object::type_id(*slots[i].first);
+            std::vector<uint32_t> seeds;
+            std::vector<std::size_t> positions;
+            if (!Object::Frozen_Table::place(hashes, seeds, positions))
+                fail("write", "", "two property names have the same hash",
+                    __LINE__);
+            Record r = Record();
+            r.parent = o.my_parent == nullptr ? 0 :
+                    index.object_numbers.find(o.my_parent)->second + 1;
+            r.count = slots.size();
+            this->align(sizeof (uint64_t));
+            r.seeds = this->data.size();
+            this->data.append(reinterpret_cast<const char *> (seeds.data()),
+                    seeds.size() * sizeof (uint32_t));
+            this->align(sizeof (uint64_t));
+            r.entries = this->data.size();
+            this->data.append(slots.size() * sizeof (Entry), '\0');
+            std::string value;
+            for (std::size_t i = 0; i < slots.size(); ++i) {
+                const Object::Shared_Pointer_And_Type * slot =
+                        Object::built_slot(slots[i].second);
+                Entry e = Entry();
+                e.name = this->data.size();
+                e.name_length = slots[i].first->size();
+                this->data.append(*slots[i].first);
+                if (slot->p == nullptr || slot->t == nullptr) {
+                    e.kind = empty_kind;
+                } else if (slot->t == Object::descriptor<Object>()) {
+                    e.kind = object_kind;
+                    e.value = index.object_numbers.find
+                            (static_cast<const Object *> (slot->p.get()))->second;
+                } else {
+                    e.kind = value_kind;
+                    e.type = slot->t->id;
+                    value.clear();
+                    slot->t->serialize(slot->p.get(), value);
+                    this->align(slot->t->align);
+                    e.value = this->data.size();
+                    e.value_length = value.size();
+                    this->data.append(value);
+                }
+                *this->at<Entry>(r.entries + positions[i] * sizeof (Entry)) = e;
+            }
+            *this->at<Record>(record) = r;
+        }
+    };
+
+public:
+
+    /**
+     *  \brief Maps the file at path and views the Object saved in it.
+     *  Throws -1 if the file cannot be mapped, or was not written by
+     *  Mapped_Object::write on a machine of this byte order.
+     */
+    explicit Mapped_Object(const std::string &path) : my_mapping(),
+    my_record(nullptr) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            fail("Mapped_Object", path, "the file cannot be opened", __LINE__);
+        struct stat st;
+        void * base = MAP_FAILED;
+        if (fstat(fd, &st) == 0 && (std::size_t) st.st_size >= sizeof (File_Header))
+            base = mmap(nullptr, (std::size_t) st.st_size, PROT_READ, MAP_SHARED,
+                fd, 0);
+        close(fd);
+        if (base == MAP_FAILED)
+            fail("Mapped_Object", path, "the file cannot be mapped", __LINE__);
+        this->my_mapping = std::make_shared<const Mapping>
+                (static_cast<const char *> (base), (std::size_t) st.st_size);
+        const File_Header &h = *static_cast<const File_Header *> (base);
+        if (h.magic != mapped_magic || h.version != mapped_version ||
+                h.byte_order != mapped_byte_order ||
+                h.file_size != (uint64_t) st.st_size || h.object_count == 0 ||
+                h.objects % sizeof (uint64_t) != 0 ||
+                h.object_count > this->my_mapping->size / sizeof (Record) ||
+                !this->inside(h.objects, h.object_count * sizeof (Record)))
+            fail("Mapped_Object", path, "the file is not a mapped Object of "
+                "this version and byte order", __LINE__);
+        this->my_record = this->record(0);
+    }
+
+    /**
+     *  \brief Writes o, and every Object reachable from it through
+     *  properties and parents, to the file at path for Mapped_Object. Lazy
+     *  values are built. Values must be of registered types that can be
+     *  serialized; function pointers and methods are not written. path is
+     *  replaced at once, Mapped_Objects open on the old file keep reading it.
+     *  Throws -1 if a value cannot be written or the file cannot be created.
+     */
+    static void write(const Object &o, const std::string &path) {
+        Object::Snapshot_Index index(o);
+        File_Writer out;
+        out.data.append(sizeof (File_Header), '\0');
+        const uint64_t records = out.data.size();
+        out.data.append(index.objects.size() * sizeof (Record), '\0');
+        for (std::size_t i = 0; i < index.objects.size(); ++i)
+            out.add(*index.objects[i], records + i * sizeof (Record), index);
+        File_Header h = File_Header();
+        h.magic = mapped_magic;
+        h.version = mapped_version;
+        h.byte_order = mapped_byte_order;
+        h.file_size = out.data.size();
+        h.object_count = index.objects.size();
+        h.objects = records;
+        *out.at<File_Header>(0) = h;
+        // Written to a temporary file renamed over path, so that readers
+        // never see a partial file and mappings of the old one stay valid.
+        const std::string temporary = path + ".tmp";
+        int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+            fail("write", path, "the file cannot be created", __LINE__);
+        bool written = write_all(fd, out.data.data(), out.data.size()) &&
+                ::fsync(fd) == 0;
+        if (::close(fd) != 0 || !written ||
+                ::rename(temporary.c_str(), path.c_str()) != 0) {
+            ::unlink(temporary.c_str());
+            fail("write", path, "the file cannot be written", __LINE__);
+        }
+    }
+
+    /**
+     *  \brief Checks this Object and its parent tree for the property name.
+     */
+    bool has(const std::string &name) const {
+        Mapped_Object holder(*this);
+        return this->find(name, holder) != nullptr;
+    }
+
+    /**
+     *  \brief Checks this Object and its parent tree for the property name
+     *  of type Type.
+     */
+    template <class Type> bool has(const std::string &name) const {
+        Mapped_Object holder(*this);
+        const Entry * e = this->find(name, holder);
+        return e != nullptr && e->kind == value_kind &&
+                e->type == Object::registered_id(Object::descriptor<Type>()) &&
+                e->type != 0;
+    }
+
+    /**
+     *  \brief Checks this Object, but not its parent tree, for the property
+     *  name.
+     */
+    bool hasOwnProperty(const std::string &name) const {
+        return this->find_own(name) != nullptr;
+    }
+
+    /**
+     * \brief Returns the property name of type Type of this Object or its
+     * parent tree, like Object::get. Types stored as their bytes are
+     * returned by reference into the mapping, others as a copy.
+     * Throws -1 if there is no such property or its type is not Type.
+     */
+    template <class Type> typename Value<Type>::type get
+    (const std::string &name) const {
+        Mapped_Object holder(*this);
+        const Entry * e = this->find(name, holder);
+        if (e == nullptr)
+            fail("get", name, "there is no property of that name", __LINE__);
+        if (e->kind != value_kind || e->type == 0 ||
+                e->type != Object::registered_id(Object::descriptor<Type>()))
+            fail("get", name, "template Type does not match up with the "
+                "property's type", __LINE__);
+        if (!this->inside(e->value, e->value_length))
+            fail("get", name, "the file is corrupt", __LINE__);
+        return Value<Type>::read(this->my_mapping->base + e->value,
+                e->value_length, name);
+    }
+
+    /**
+     * \brief Returns the Object stored as the property name of this Object
+     * or its parent tree. Throws -1 if there is none.
+     */
+    Mapped_Object getObject(const std::string &name) const {
+        Mapped_Object holder(*this);
+        const Entry * e = this->find(name, holder);
+        if (e == nullptr || e->kind != object_kind)
+            fail("getObject", name, "there is no Object of that name", __LINE__);
+        return Mapped_Object(this->my_mapping, this->record(e->value));
+    }
+
+    bool hasParent() const {
+        return this->my_record->parent != 0;
+    }
+
+    /**
+     * \brief Returns the parent of this Object. Throws -1 if it has none.
+     */
+    Mapped_Object getParent() const {
+        if (this->my_record->parent == 0)
+            fail("getParent", "", "the Object has no parent", __LINE__);
+        return Mapped_Object(this->my_mapping,
+                this->record(this->my_record->parent - 1));
+    }
+
+    /**
+     *  \brief Number of own properties.
+     */
+    std::size_t size() const {
+        return (std::size_t) this->my_record->count;
+    }
+};
+#endif    // PROTOTYPAL_C_MAPPED_OBJECT_H_
@@ -0,0 +1,519 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+/*
+ * File:   Object_Array.h
+ * Created on October 18, 2026
+ */
+
+#ifndef PROTOTYPAL_C_OBJECT_ARRAY_H_
+#define PROTOTYPAL_C_OBJECT_ARRAY_H_
+
+#include "Prototypal_Cpp.h"
+#include <stdio.h>
+#include <stddef.h>
+#include <type_traits>
+#include <unordered_map>
+#include <memory>
+#include <string>
+#include <vector>
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/**  \brief Struct-of-arrays container for many Objects sharing one property set.
+ *  Every property is stored as a contiguous std::vector<Type> column, so a scan
+ *  over one property touches only that property's memory and never hashes a
+ *  name or copies a shared_ptr per element. Elements are reached through
+ *  Object_Array::Element, which offers the get/set/has interface of Object.
+ */
+class Object_Array {
+
+    /**  \brief Type-erased column. Lets the array resize and convert rows
+     *  without knowing the element type of each column.
+     */
+    struct Column_Base {
+        const Object::Type_Descriptor * t;
+
+        explicit Column_Base(const Object::Type_Descriptor * tt) : t(tt) {
+        }
+
+        virtual ~Column_Base() {
+        }
+        virtual void resize(size_t n) = 0;
+        virtual void reserve(size_t n) = 0;
+        virtual void swap_remove(size_t i) = 0;
+        virtual void load(Object &o, const std::string &name, size_t i) = 0;
+        virtual void store(Object &o, const std::string &name, size_t i) = 0;
+        virtual Column_Base * clone() const = 0;
+    };
+
+    /**  \brief Contiguous storage for a single property of type Type.
+     */
+    template <class Type> struct Column : public Column_Base {
+        std::vector<Type> data;
+
+        Column() : Column_Base(Object::descriptor<Type>()), data() {
+        }
+
+        void resize(size_t n) {
+            this->data.resize(n);
+        }
+
+        void reserve(size_t n) {
+            this->data.reserve(n);
+        }
+
+        void swap_remove(size_t i) {
+            this->data[i] = this->data.back();
+            this->data.pop_back();
+        }
+
+        void load(Object &o, const std::string &name, size_t i) {
+            if (o.has<Type>(name))
+                this->data[i] = o.get<Type>(name);
+        }
+
+        void store(Object &o, const std::string &name, size_t i) {
+            o.set(name, this->data[i]);
+        }
+
+        Column_Base * clone() const {
+            Column<Type> * c = new Column<Type>();
+            c->data = this->data;
+            return c;
+        }
+    };
+
+    /**
+     *   \brief Column names, in the order the columns were added
+     */
+    std::vector<std::string> my_names;
+    /**
+     *   \brief Maps a column name to its position in my_columns
+     */
+    std::unordered_map<std::string, size_t> my_index;
+    /**
+     *   \brief One column per property, parallel to my_names
+     */
+    std::vector<std::unique_ptr<Column_Base> > my_columns;
+    /**
+     *   \brief Number of elements (rows) in every column
+     */
+    size_t my_size;
+
+    /**
+     * \brief Finds the column named name and checks its element type.
+     * Throws -1 when the column is missing or holds another type.
+     */
+    template <class Type> Column<Type> * typed_column(const std::string &name,
+            const char *caller) {
+        return static_cast<Column<Type> *> (this->checked_column
+                (name, Object::descriptor<Type>(), caller));
+    }
+
+    template <class Type> const Column<Type> * typed_column
+    (const std::string &name, const char *caller) const {
+        return static_cast<const Column<Type> *> (this->checked_column
+                (name, Object::descriptor<Type>(), caller));
+    }
+
+    Column_Base * checked_column(const std::string &name,
+            const Object::Type_Descriptor * t, const char *caller) const {
+        auto pair = this->my_index.find(name);
+        if (pair == this->my_index.end()) {
+            printf("In Object_Array.%s(\"%s\"), parameter \"%s\" does not "
+                    "correspond to a column.\n  See line number %d in file %s\n\n",
+                    caller, name.c_str(), name.c_str(), __LINE__, __FILE__);
+            throw -1;
+        }
+        Column_Base * c = this->my_columns[pair->second].get();
+        if (c->t != t) {
+            printf("In Object_Array.%s(\"%s\"), template Type does not match "
+                    "up with the column's type.\n  See line number %d in file "
+                    "%s\n\n", caller, name.c_str(), __LINE__, __FILE__);
+            throw -1;
+        }
+        return c;
+    }
+
+    /**
+     * \brief Sums n values with independent accumulators so that the loop
+     * carries no serial dependency and can be vectorized.
+     */
+    template <class Type> static Type sum_range(const Type *data, size_t n) {
+        Type a0 = Type(), a1 = Type(), a2 = Type(), a3 = Type();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            a0 += data[i];
+            a1 += data[i + 1];
+            a2 += data[i + 2];
+            a3 += data[i + 3];
+        }
+        for (; i < n; ++i)
+            a0 += data[i];
+        return (a0 + a1) + (a2 + a3);
+    }
+
+#if defined(__AVX__)
+
+    static double sum_range(const double *data, size_t n) {
+        __m256d a0 = _mm256_setzero_pd(), a1 = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            a0 = _mm256_add_pd(a0, _mm256_loadu_pd(data + i));
+            a1 = _mm256_add_pd(a1, _mm256_loadu_pd(data + i + 4));
+        }
+        double lanes[4];
+        _mm256_storeu_pd(lanes, _mm256_add_pd(a0, a1));
+        double total = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+        for (; i < n; ++i)
+            total += data[i];
+        return total;
+    }
+
+    static float sum_range(const float *data, size_t n) {
+        __m256 a0 = _mm256_setzero_ps(), a1 = _mm256_setzero_ps();
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            a0 = _mm256_add_ps(a0, _mm256_loadu_ps(data + i));
+            a1 = _mm256_add_ps(a1, _mm256_loadu_ps(data + i + 8));
+        }
+        float lanes[8];
+        _mm256_storeu_ps(lanes, _mm256_add_ps(a0, a1));
+        float total = 0.0f;
+        for (int l = 0; l < 8; ++l)
+            total += lanes[l];
+        for (; i < n; ++i)
+            total += data[i];
+        return total;
+    }
+#elif defined(__SSE2__)
+
+    static double sum_range(const double *data, size_t n) {
+        __m128d a0 = _mm_setzero_pd(), a1 = _mm_setzero_pd();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            a0 = _mm_add_pd(a0, _mm_loadu_pd(data + i));
+            a1 = _mm_add_pd(a1, _mm_loadu_pd(data + i + 2));
+        }
+        double lanes[2];
+        _mm_storeu_pd(lanes, _mm_add_pd(a0, a1));
+        double total = lanes[0] + lanes[1];
+        for (; i < n; ++i)
+            total += data[i];
+        return total;
+    }
+
+    static float sum_range(const float *data, size_t n) {
+        __m128 a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            a0 = _mm_add_ps(a0, _mm_loadu_ps(data + i));
+            a1 = _mm_add_ps(a1, _mm_loadu_ps(data + i + 4));
+        }
+        float lanes[4];
+        _mm_storeu_ps(lanes, _mm_add_ps(a0, a1));
+        float total = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+        for (; i < n; ++i)
+            total += data[i];
+        return total;
+    }
+#endif
+
+public:
+
+    /**  \brief View of a single element of an Object_Array. Offers the
+     *  get/set/has interface of Object over one row of the columns.
+     *  A view is invalidated when its array is destroyed.
+     */
+    class Element {
+        Object_Array * my_array;
+        size_t my_row;
+
+    public:
+
+        Element(Object_Array &array, size_t row) : my_array(&array),
+        my_row(row) {
+        }
+
+        /**
+         *  \brief Index of this element within its array.
+         */
+        size_t index() const {
+            return this->my_row;
+        }
+
+        /**
+         * \brief Retrieves this element's value of the column named name.
+         * Throws -1 when the column is missing or holds another type.
+         */
+        template <class Return_Type> Return_Type get(const std::string &name) {
+            return this->my_array->typed_column<Return_Type>(name, "get")
+                    ->data[this->my_row];
+        }
+
+        /**
+         * \brief Sets this element's value of the column named name.
+         * A missing column is added to the whole array first.
+         * Throws -1 when the column holds another type.
+         */
+        template <class Type> void set(const std::string &name,
+                const Type &value) {
+            if (!this->my_array->hasColumn(name))
+                this->my_array->addColumn<Type>(name);
+            this->my_array->typed_column<Type>(name, "set")->data[this->my_row]
+                    = value;
+        }
+
+        /**
+         *  \brief True if the array has a column named name.
+         */
+        bool has(const std::string &name) const {
+            return this->my_array->hasColumn(name);
+        }
+
+        /**
+         *  \brief True if the array has a column named name of type
+         *  Element_Type.
+         */
+        template <class Element_Type> bool has(const std::string &name) const {
+            return this->my_array->hasColumn<Element_Type>(name);
+        }
+
+        /**
+         *  \brief Same as has. Elements have no parent.
+         */
+        bool hasOwnProperty(const std::string &name) const {
+            return this->has(name);
+        }
+
+        /**
+         *  \brief Same as has<Element_Type>. Elements have no parent.
+         */
+        template <class Element_Type> bool hasOwnProperty
+        (const std::string &name) const {
+            return this->has<Element_Type>(name);
+        }
+    };
+
+    /**
+     *  \brief Empty default constructor.
+     */
+    Object_Array() : my_names(), my_index(), my_columns(), my_size(0) {
+    }
+
+    /**
+     *  \brief Standard copy constructor. Copies every column.
+     */
+    Object_Array(const Object_Array &other) : my_names(other.my_names),
+    my_index(other.my_index), my_columns(), my_size(other.my_size) {
+        for (size_t c = 0; c < other.my_columns.size(); ++c)
+            this->my_columns.emplace_back(other.my_columns[c]->clone());
+    }
+
+    /**
+     *  \brief Standard assignment operator
+     */
+    Object_Array& operator =(const Object_Array &other) {
+        if (this != &other) {
+            Object_Array copy(other);
+            this->my_names.swap(copy.my_names);
+            this->my_index.swap(copy.my_index);
+            this->my_columns.swap(copy.my_columns);
+            this->my_size = copy.my_size;
+        }
+        return *this;
+    }
+
+    /**
+     * \brief Adds a column of type Type named name. Existing elements get a
+     * value-initialized Type. Does nothing if an identical column exists.
+     * Throws -1 if a column of another type already uses the name.
+     * std::vector<bool> is not contiguous, so bool columns are rejected; use
+     * unsigned char instead.
+     */
+    template <class Type> void addColumn(const std::string &name) {
+        static_assert(!std::is_same<Type, bool>::value,
+                "Object_Array cannot store bool columns, use unsigned char");
+        auto pair = this->my_index.find(name);
+        if (pair != this->my_index.end()) {
+            this->typed_column<Type>(name, "addColumn");
+            return;
+        }
+        std::unique_ptr<Column_Base> c(new Column<Type>());
+        c->resize(this->my_size);
+        this->my_index[name] = this->my_columns.size();
+        this->my_names.push_back(name);
+        this->my_columns.push_back(std::move(c));
+    }
+
+    /**
+     *  \brief True if the array has a column named name.
+     */
+    bool hasColumn(const std::string &name) const {
+        return this->my_index.count(name) != 0;
+    }
+
+    /**
+     *  \brief True if the array has a column named name of type Element_Type.
+     */
+    template <class Element_Type> bool hasColumn(const std::string &name) const {
+        auto pair = this->my_index.find(name);
+        return pair != this->my_index.end() &&
+                this->my_columns[pair->second]->t ==
+                Object::descriptor<Element_Type>();
+    }
+
+    /**
+     *  \brief Names of the columns, in the order they were added.
+     */
+    const std::vector<std::string> & columns() const {
+        return this->my_names;
+    }
+
+    /**
+     *  \brief Number of elements.
+     */
+    size_t size() const {
+        return this->my_size;
+    }
+
+    /**
+     *  \brief Resizes every column to n elements.
+     */
+    void resize(size_t n) {
+        for (size_t c = 0; c < this->my_columns.size(); ++c)
+            this->my_columns[c]->resize(n);
+        this->my_size = n;
+    }
+
+    /**
+     *  \brief Reserves room for n elements in every column.
+     */
+    void reserve(size_t n) {
+        for (size_t c = 0; c < this->my_columns.size(); ++c)
+            this->my_columns[c]->reserve(n);
+    }
+
+    /**
+     * \brief Appends an element whose column values are read from object o
+     * (or its parent tree). Columns o has no matching value for are
+     * value-initialized.
+     * @return index of the new element
+     */
+    size_t push_back(Object &o) {
+        size_t row = this->my_size;
+        this->resize(row + 1);
+        for (size_t c = 0; c < this->my_columns.size(); ++c)
+            this->my_columns[c]->load(o, this->my_names[c], row);
+        return row;
+    }
+
+    /**
+     * \brief Appends a value-initialized element.
+     * @return index of the new element
+     */
+    size_t push_back() {
+        this->resize(this->my_size + 1);
+        return this->my_size - 1;
+    }
+
+    /**
+     * \brief Removes element i by moving the last element into its place.
+     * Element order is not preserved.
+     */
+    void swap_remove(size_t i) {
+        if (i >= this->my_size) {
+            printf("In Object_Array.swap_remove(%lu), index is out of range."
+                    "\n  See line number %d in file %s\n\n",
+                    (unsigned long) i, __LINE__, __FILE__);
+            throw -1;
+        }
+        for (size_t c = 0; c < this->my_columns.size(); ++c)
+            this->my_columns[c]->swap_remove(i);
+        --this->my_size;
+    }
+
+    /**
+     * \brief Copies element i into a new Object with one property per column.
+     */
+    Object to_object(size_t i) {
+        Object o;
+        for (size_t c = 0; c < this->my_columns.size(); ++c)
+            this->my_columns[c]->store(o, this->my_names[c], i);
+        return o;
+    }
+
+    /**
+     *  \brief View of element i. Not bounds checked.
+     */
+    Element operator[](size_t i) {
+        return Element(*this, i);
+    }
+
+    /**
+     * \brief Contiguous storage of the column named name, size() elements long.
+     * The pointer is invalidated by anything that resizes the array.
+     * Throws -1 when the column is missing or holds another type.
+     */
+    template <class Type> Type * column(const std::string &name) {
+        Column<Type> * c = this->typed_column<Type>(name, "column");
+        return c->data.empty() ? nullptr : &c->data[0];
+    }
+
+    /**
+     * \brief Sums the column named name. double and float columns use SSE2 or
+     * AVX when the compiler targets them.
+     */
+    template <class Type> Type sum(const std::string &name) const {
+        const std::vector<Type> &data =
+                this->typed_column<Type>(name, "sum")->data;
+        return data.empty() ? Type() : sum_range(&data[0], data.size());
+    }
+
+    /**
+     * \brief Replaces every value v of the column named name with f(v).
+     * The loop body is a plain contiguous store, so simple functors are
+     * vectorized by the compiler.
+     */
+    template <class Type, class Function> void map(const std::string &name,
+            Function f) {
+        std::vector<Type> &data = this->typed_column<Type>(name, "map")->data;
+        Type * p = data.empty() ? nullptr : &data[0];
+        const size_t n = data.size();
+        for (size_t i = 0; i < n; ++i)
+            p[i] = f(p[i]);
+    }
+
+    /**
+     * \brief Finds the elements whose value of the column named name
+     * satisfies predicate.
+     * @return indices of the matching elements, in ascending order
+     */
+    template <class Type, class Predicate> std::vector<size_t> filter
+    (const std::string &name, Predicate predicate) const {
+        const std::vector<Type> &data =
+                this->typed_column<Type>(name, "filter")->data;
+        std::vector<size_t> out(data.size());
+        size_t count = 0;
+        for (size_t i = 0; i < data.size(); ++i) {
+            // Branch-free append: always write, advance only on a match.
+            out[count] = i;
+            count += predicate(data[i]) ? 1 : 0;
+        }
+        out.resize(count);
+        return out;
+    }
+};
+#endif    // PROTOTYPAL_C_OBJECT_ARRAY_H_
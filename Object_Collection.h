@@ -0,0 +1,512 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+/*
+ * File:   Object_Collection.h
+ * Created on October 18, 2026
+ */
+
+#ifndef PROTOTYPAL_C_OBJECT_COLLECTION_H_
+#define PROTOTYPAL_C_OBJECT_COLLECTION_H_
+
+#include "Prototypal_Cpp.h"
+#include <stdio.h>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/**  \brief A set of Objects with indexes on the values of named properties,
+ *  kept up to date as the members change.
+ *
+ *  add_hash_index<Type>(name) answers find<Type>(name, value) in constant
+ *  time, add_ordered_index<Type>(name) answers range<Type>(name, low, high)
+ *  in logarithmic time. Only the members' own properties holding a Type
+ *  are indexed, not those inherited from their parent. Lazy values are
+ *  built when they are indexed.
+ *
+ *  Every set, remove, clear, assignment and pass_contents of a member
+ *  updates the indexes through a hook added with Object::add_change_hook,
+ *  and a destroyed member leaves its collections. Changes to members are
+ *  serialized by one lock shared by every collection, which changes to
+ *  other Objects skip after a lock-free test; queries are not locked, and
+ *  must not run while members change. Collections can be created and
+ *  destroyed while other threads change Objects.
+ */
+class Object_Collection {
+
+    /**  \brief The members, by the value of one property.
+     */
+    struct Index {
+        const Object::Type_Descriptor * type;
+        bool ordered;
+
+        Index(const Object::Type_Descriptor * t, bool o) : type(t), ordered(o) {
+        }
+
+        virtual ~Index() {
+        }
+
+        virtual void insert(const void * value, Object * member) = 0;
+        virtual void erase(Object * member) = 0;
+    };
+
+    template <class Type> struct Hash_Index : Index {
+        std::unordered_map<Type, std::unordered_set<Object *> > members;
+        /** the key each member is filed under */
+        std::unordered_map<Object *, const Type *> keys;
+
+        Hash_Index() : Index(Object::descriptor<Type>(), false), members(),
+        keys() {
+        }
+
+        void insert(const void * value, Object * member) {
+            auto found = this->members.insert(std::make_pair
+                    (*static_cast<const Type *> (value),
+                    std::unordered_set<Object *>())).first;
+            found->second.insert(member);
+            this->keys[member] = &found->first;
+        }
+
+        void erase(Object * member) {
+            auto key = this->keys.find(member);
+            if (key == this->keys.end())
+                return;
+            auto found = this->members.find(*key->second);
+            found->second.erase(member);
+            if (found->second.empty())
+                this->members.erase(found);
+            this->keys.erase(key);
+        }
+    };
+
+    template <class Type> struct Ordered_Index : Index {
+        std::multimap<Type, Object *> members;
+        /** the entry of each member */
+        std::unordered_map<Object *,
+        typename std::multimap<Type, Object *>::iterator> entries;
+
+        Ordered_Index() : Index(Object::descriptor<Type>(), true), members(),
+        entries() {
+        }
+
+        void insert(const void * value, Object * member) {
+            this->entries[member] = this->members.insert(std::make_pair
+                    (*static_cast<const Type *> (value), member));
+        }
+
+        void erase(Object * member) {
+            auto entry = this->entries.find(member);
+            if (entry == this->entries.end())
+                return;
+            this->members.erase(entry->second);
+            this->entries.erase(entry);
+        }
+    };
+
+    /**  \brief The collections of every member, behind the lock that
+     *  serializes their updates. watched holds the keys of members, so
+     *  changes to other Objects skip the lock.
+     */
+    struct Registry {
+        std::recursive_mutex mutex;
+        std::unordered_map<Object *, std::vector<Object_Collection *> > members;
+        std::size_t collections;
+        Object::Watch_Filter watched;
+
+        Registry() : mutex(), members(), collections(0), watched() {
+        }
+
+        /**
+         *  \brief Files collection as one of member's.
+         */
+        void enter(Object &member, Object_Collection * collection) {
+            std::vector<Object_Collection *> &found = this->members[&member];
+            if (found.empty()) {
+                this->watched.add(&member);
+                if (this->watched.crowded()) {
+                    std::vector<const Object *> keys;
+                    keys.reserve(this->members.size());
+                    for (auto it = this->members.begin();
+                            it != this->members.end(); ++it)
+                        keys.push_back(it->first);
+                    this->watched.rebuild(keys);
+                }
+            }
+            found.push_back(collection);
+        }
+
+        /**
+         *  \brief Forgets member, which is in no collection any more.
+         */
+        void leave(Object * member) {
+            if (this->members.erase(member) != 0)
+                this->watched.remove(member);
+        }
+    };
+
+    std::unordered_set<Object *> my_members;
+    std::unordered_map<std::string, std::vector<std::unique_ptr<Index> > >
+    my_indexes;
+
+    static Registry & registry() {
+        static Registry r;
+        return r;
+    }
+
+    static void fail(const char *caller, const std::string &name,
+            const char *problem, int line) {
+        printf("In Object_Collection.%s(\"%s\"), %s.\n  "
+                "See line number %d in file %s\n\n",
+                caller, name.c_str(), problem, line, __FILE__);
+        throw -1;
+    }
+
+    /**
+     *  \brief Files member under its own property name in the indexes of
+     *  that name whose type the value has. The value comes from source.
+     */
+    void insert(Object &member, const Object &source, const std::string &name,
+            std::vector<std::unique_ptr<Index> > &indexes) {
+        const Object::Shared_Pointer_And_Type * slot = source.find_own(name);
+        if (slot == nullptr || slot->p == nullptr)
+            return;
+        for (std::size_t i = 0; i < indexes.size(); ++i)
+            if (indexes[i]->type == slot->t)
+                indexes[i]->insert(slot->p.get(), &member);
+    }
+
+    void insert_all(Object &member, const Object &source) {
+        for (auto it = this->my_indexes.begin(); it != this->my_indexes.end();
+                ++it)
+            this->insert(member, source, it->first, it->second);
+    }
+
+    void erase_all(Object &member) {
+        for (auto it = this->my_indexes.begin(); it != this->my_indexes.end();
+                ++it)
+            for (std::size_t i = 0; i < it->second.size(); ++i)
+                it->second[i]->erase(&member);
+    }
+
+    /**
+     *  \brief Updates the indexes before member changes.
+     */
+    void update(Object &member, Object::Change change,
+            const std::string * name, const void * value,
+            const Object::Type_Descriptor * type) {
+        if (change == Object::change_set || change == Object::change_remove) {
+            auto found = this->my_indexes.find(*name);
+            if (found == this->my_indexes.end())
+                return;
+            std::vector<std::unique_ptr<Index> > &indexes = found->second;
+            for (std::size_t i = 0; i < indexes.size(); ++i)
+                indexes[i]->erase(&member);
+            if (change == Object::change_remove || value == nullptr)
+                return;
+            if (type->is_lazy) {
+                const Object::Shared_Pointer_And_Type &built =
+                        static_cast<Object::Lazy_Cell *>
+                        (const_cast<void *> (value))->force();
+                value = built.p.get();
+                type = built.t;
+            }
+            for (std::size_t i = 0; i < indexes.size(); ++i)
+                if (indexes[i]->type == type && value != nullptr)
+                    indexes[i]->insert(value, &member);
+        } else if (change == Object::change_clear
+                || change == Object::change_destroy) {
+            this->erase_all(member);
+            if (change == Object::change_destroy)
+                this->my_members.erase(&member);
+        } else if (change == Object::change_contents) {
+            this->erase_all(member);
+            this->insert_all(member, *static_cast<const Object *> (value));
+        }
+    }
+
+    /**
+     *  \brief Added with Object::add_change_hook while a collection exists.
+     */
+    static void on_change(Object &object, Object::Change change,
+            const std::string * name, const void * value,
+            const Object::Type_Descriptor * type) {
+        Registry &r = Object_Collection::registry();
+        if (!r.watched.may_contain(&object))
+            return;
+        std::lock_guard<std::recursive_mutex> lock(r.mutex);
+        auto found = r.members.find(&object);
+        if (found == r.members.end())
+            return;
+        std::vector<Object_Collection *> collections = found->second;
+        for (std::size_t i = 0; i < collections.size(); ++i)
+            collections[i]->update(object, change, name, value, type);
+        if (change == Object::change_destroy)
+            r.leave(&object);
+    }
+
+    /**
+     *  \brief The index of Type on name, nullptr if there is none.
+     */
+    template <class Type, class Kind> Kind * find_index(const std::string &name,
+            bool ordered) const {
+        auto found = this->my_indexes.find(name);
+        if (found == this->my_indexes.end())
+            return nullptr;
+        for (std::size_t i = 0; i < found->second.size(); ++i)
+            if (found->second[i]->type == Object::descriptor<Type>()
+                    && found->second[i]->ordered == ordered)
+                return static_cast<Kind *> (found->second[i].get());
+        return nullptr;
+    }
+
+    /**
+     *  \brief Adds index to the indexes of name and files the members in it.
+     */
+    void add_index(const std::string &name, Index * index) {
+        std::unique_ptr<Index> owned(index);
+        Registry &r = Object_Collection::registry();
+        std::lock_guard<std::recursive_mutex> lock(r.mutex);
+        std::vector<std::unique_ptr<Index> > &indexes = this->my_indexes[name];
+        for (std::size_t i = 0; i < indexes.size(); ++i)
+            if (indexes[i]->type == index->type
+                    && indexes[i]->ordered == index->ordered)
+                return;
+        indexes.push_back(std::move(owned));
+        for (auto it = this->my_members.begin(); it != this->my_members.end();
+                ++it) {
+            const Object::Shared_Pointer_And_Type * slot = (*it)->find_own(name);
+            if (slot != nullptr && slot->p != nullptr && slot->t == index->type)
+                index->insert(slot->p.get(), *it);
+        }
+    }
+
+    static Object & member(Object * const &m) {
+        return *m;
+    }
+
+    template <class Key> static Object & member
+    (const std::pair<const Key, Object *> &m) {
+        return *m.second;
+    }
+
+public:
+
+    /**  \brief Iterator over the members found by a query.
+     */
+    template <class Base> class Member_Iterator {
+        Base my_base;
+
+    public:
+
+        explicit Member_Iterator(Base base) : my_base(base) {
+        }
+
+        Object & operator*() const {
+            return Object_Collection::member(*this->my_base);
+        }
+
+        Object * operator->() const {
+            return &Object_Collection::member(*this->my_base);
+        }
+
+        Member_Iterator& operator++() {
+            ++this->my_base;
+            return *this;
+        }
+
+        bool operator==(const Member_Iterator &other) const {
+            return this->my_base == other.my_base;
+        }
+
+        bool operator!=(const Member_Iterator &other) const {
+            return this->my_base != other.my_base;
+        }
+    };
+
+    /**  \brief The members found by a query, for a range-based for loop.
+     */
+    template <class Base> class Member_Range {
+        Base my_begin;
+        Base my_end;
+
+    public:
+
+        Member_Range(Base b, Base e) : my_begin(b), my_end(e) {
+        }
+
+        Member_Iterator<Base> begin() const {
+            return Member_Iterator<Base>(this->my_begin);
+        }
+
+        Member_Iterator<Base> end() const {
+            return Member_Iterator<Base>(this->my_end);
+        }
+
+        bool empty() const {
+            return this->my_begin == this->my_end;
+        }
+
+        std::size_t size() const {
+            std::size_t n = 0;
+            for (Base it = this->my_begin; it != this->my_end; ++it)
+                ++n;
+            return n;
+        }
+    };
+
+    typedef Member_Range<std::unordered_set<Object *>::const_iterator>
+    Hash_Range;
+
+    template <class Type> struct Ordered {
+        typedef Member_Range<typename std::multimap<Type, Object *>
+        ::const_iterator> Range;
+    };
+
+    Object_Collection() : my_members(), my_indexes() {
+        Registry &r = Object_Collection::registry();
+        std::lock_guard<std::recursive_mutex> lock(r.mutex);
+        if (r.collections++ == 0)
+            Object::add_change_hook(&Object_Collection::on_change);
+    }
+
+    Object_Collection(const Object_Collection &) = delete;
+    Object_Collection& operator =(const Object_Collection &) = delete;
+
+    /**
+     *  \brief Removes every member. The Objects are not destroyed.
+     */
+    ~Object_Collection() {
+        Registry &r = Object_Collection::registry();
+        std::lock_guard<std::recursive_mutex> lock(r.mutex);
+        for (auto it = this->my_members.begin(); it != this->my_members.end();
+                ++it) {
+            std::vector<Object_Collection *> &collections = r.members[*it];
+            for (std::size_t i = 0; i < collections.size(); ++i)
+                if (collections[i] == this) {
+                    collections.erase(collections.begin() + i);
+                    break;
+                }
+            if (collections.empty())
+                r.leave(*it);
+        }
+        if (--r.collections == 0)
+            Object::remove_change_hook(&Object_Collection::on_change);
+    }
+
+    /**
+     *  \brief Adds member and files it in the indexes. The collection
+     *  refers to member, which leaves it when destroyed.
+     *  @return false if member was already in the collection
+     */
+    bool add(Object &member) {
+        Registry &r = Object_Collection::registry();
+        std::lock_guard<std::recursive_mutex> lock(r.mutex);
+        if (!this->my_members.insert(&member).second)
+            return false;
+        r.enter(member, this);
+        this->insert_all(member, member);
+        return true;
+    }
+
+    /**
+     *  \brief Removes member from the collection and its indexes.
+     *  @return false if member was not in the collection
+     */
+    bool remove(Object &member) {
+        Registry &r = Object_Collection::registry();
+        std::lock_guard<std::recursive_mutex> lock(r.mutex);
+        if (this->my_members.erase(&member) == 0)
+            return false;
+        this->erase_all(member);
+        std::vector<Object_Collection *> &collections = r.members[&member];
+        for (std::size_t i = 0; i < collections.size(); ++i)
+            if (collections[i] == this) {
+                collections.erase(collections.begin() + i);
+                break;
+            }
+        if (collections.empty())
+            r.leave(&member);
+        return true;
+    }
+
+    bool contains(const Object &member) const {
+        return this->my_members.count(const_cast<Object *> (&member)) != 0;
+    }
+
+    std::size_t size() const {
+        return this->my_members.size();
+    }
+
+    /**
+     *  \brief Indexes the members whose own property name holds a Type,
+     *  for find. Type needs std::hash and operator ==. Does nothing if the
+     *  index exists.
+     */
+    template <class Type> void add_hash_index(const std::string &name) {
+        this->add_index(name, new Hash_Index<Type>());
+    }
+
+    /**
+     *  \brief Indexes the members whose own property name holds a Type,
+     *  in order, for range. Type needs operator <. Does nothing if the
+     *  index exists.
+     */
+    template <class Type> void add_ordered_index(const std::string &name) {
+        this->add_index(name, new Ordered_Index<Type>());
+    }
+
+    /**
+     *  \brief The members whose own property name holds a Type equal to
+     *  value, in no particular order. Throws -1 if there is no hash index
+     *  of Type on name.
+     */
+    template <class Type> Hash_Range find(const std::string &name,
+            const Type &value) const {
+        static const std::unordered_set<Object *> none;
+        const Hash_Index<Type> * index =
+                this->find_index<Type, Hash_Index<Type> >(name, false);
+        if (index == nullptr)
+            fail("find", name, "there is no hash index of this type on the "
+                "property", __LINE__);
+        auto found = index->members.find(value);
+        if (found == index->members.end())
+            return Hash_Range(none.begin(), none.end());
+        return Hash_Range(found->second.begin(), found->second.end());
+    }
+
+    /**
+     *  \brief The members whose own property name holds a Type from low to
+     *  high, both included, in the order of their values. Throws -1 if there
+     *  is no ordered index of Type on name.
+     */
+    template <class Type> typename Ordered<Type>::Range range
+    (const std::string &name, const Type &low, const Type &high) const {
+        const Ordered_Index<Type> * index =
+                this->find_index<Type, Ordered_Index<Type> >(name, true);
+        if (index == nullptr)
+            fail("range", name, "there is no ordered index of this type on "
+                "the property", __LINE__);
+        if (high < low)
+            return typename Ordered<Type>::Range(index->members.end(),
+                index->members.end());
+        return typename Ordered<Type>::Range(index->members.lower_bound(low),
+                index->members.upper_bound(high));
+    }
+};
+#endif    // PROTOTYPAL_C_OBJECT_COLLECTION_H_
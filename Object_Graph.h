@@ -0,0 +1,352 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+/*
+ * File:   Object_Graph.h
+ * Created on October 18, 2026
+ */
+
+#ifndef PROTOTYPAL_C_OBJECT_GRAPH_H_
+#define PROTOTYPAL_C_OBJECT_GRAPH_H_
+
+#include "Prototypal_Cpp.h"
+#include "Thread_Pool.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**  \brief The Objects reachable from a root, numbered on a Thread_Pool.
+ *
+ *  The graph is walked level by level: the Objects found in one level are
+ *  split into chunks that the pool's workers visit in parallel, so wide
+ *  subtrees spread over every worker. Each Object is numbered once, by the
+ *  first worker to reach it, whatever the number of properties holding it.
+ *  The root is number 0; the numbers of the other Objects depend on the
+ *  order the workers reach them. Lazy values are built on the way.
+ *
+ *  Used by deep_clone and parallel_save. The Objects must not be modified
+ *  while they are walked.
+ */
+class Object_Graph {
+public:
+
+    /**  \brief The Objects found by one chunk of a level.
+     */
+    struct Found {
+        std::vector<std::pair<uint64_t, const Object *> > objects;
+        /** numbers of the Objects held by a property */
+        std::vector<uint64_t> owned;
+        std::vector<std::pair<const Object::Type_Descriptor *,
+        const std::string *> > types;
+    };
+
+    /** the Objects, in the order of their numbers */
+    std::vector<const Object *> objects;
+    /** Object::snapshot_owned and Object::snapshot_frozen of each Object */
+    std::vector<unsigned char> flags;
+    /** the types of the values, when saving */
+    std::vector<const Object::Type_Descriptor *> types;
+    std::unordered_map<const Object::Type_Descriptor *, uint64_t> type_numbers;
+
+private:
+
+    static const std::size_t stripe_count = 256;
+    /** Levels smaller than this are walked on the calling thread. */
+    static const std::size_t serial_level = 64;
+
+    /**  \brief A share of the Object numbers, locked on its own so that
+     *  workers rarely wait for each other.
+     */
+    struct Stripe {
+        std::mutex mutex;
+        std::unordered_map<const Object *, uint64_t> numbers;
+    };
+
+    Thread_Pool &my_pool;
+    bool my_saving;
+    std::atomic<uint64_t> my_count;
+    Stripe my_stripes[stripe_count];
+
+    Stripe & stripe(const Object * o) {
+        return this->my_stripes[Object_Graph::stripe_index(o)];
+    }
+
+    static std::size_t stripe_index(const Object * o) {
+        return (std::size_t) (((uint64_t) (uintptr_t) o
+                * 0x9E3779B97F4A7C15ULL) >> 56) % stripe_count;
+    }
+
+    /**
+     *  \brief Returns the number of o, numbering it and adding it to found
+     *  if no worker reached it before.
+     */
+    uint64_t claim(const Object * o, Found &found) {
+        Stripe &s = this->stripe(o);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        auto inserted = s.numbers.insert(std::make_pair(o, (uint64_t) 0));
+        if (inserted.second) {
+            inserted.first->second = this->my_count.fetch_add(1,
+                    std::memory_order_relaxed);
+            found.objects.push_back(std::make_pair(inserted.first->second, o));
+        }
+        return inserted.first->second;
+    }
+
+    /**
+     *  \brief Numbers the nested Objects of o, and its parent when saving,
+     *  and lists the types of its values when saving.
+     */
+    void visit(const Object &o, Found &found) {
+        if (this->my_saving && o.my_parent != nullptr)
+            this->claim(o.my_parent, found);
+        std::vector<std::pair<const std::string *,
+                const Object::Shared_Pointer_And_Type *> > slots;
+        o.for_each_slot(Object::Slot_Collector(slots));
+        for (std::size_t i = 0; i < slots.size(); ++i) {
+            const Object::Shared_Pointer_And_Type * slot =
+                    Object::built_slot(slots[i].second);
+            if (slot->p == nullptr || slot->t == nullptr)
+                continue;
+            if (slot->t == Object::descriptor<Object>()) {
+                found.owned.push_back(this->claim(static_cast<const Object *>
+                        (slot->p.get()), found));
+            } else if (this->my_saving) {
+                std::size_t j = 0;
+                while (j < found.types.size() && found.types[j].first != slot->t)
+                    ++j;
+                if (j == found.types.size())
+                    found.types.push_back(std::make_pair(slot->t,
+                        slots[i].first));
+            }
+        }
+    }
+
+    /**
+     *  \brief Numbers the type t of the property name. Throws -1 if its
+     *  values cannot be saved.
+     */
+    void add_type(const Object::Type_Descriptor * t, const std::string &name) {
+        if (this->type_numbers.count(t) != 0)
+            return;
+        if (Object::registered_id(t) == 0 || t->serialize == nullptr
+                || t->is_object) {
+            printf("In parallel_save, property \"%s\" holds a type that is "
+                    "not registered or cannot be serialized.\n  "
+                    "See line number %d in file %s\n\n",
+                    name.c_str(), __LINE__, __FILE__);
+            throw -1;
+        }
+        this->type_numbers[t] = this->types.size();
+        this->types.push_back(t);
+    }
+
+    /**
+     *  \brief Adds the Objects and types found by a level to the graph and
+     *  returns the Objects of the next level in next.
+     */
+    void merge(std::vector<Found> &found, std::vector<const Object *> &next) {
+        this->objects.resize((std::size_t) this->my_count.load());
+        this->flags.resize(this->objects.size(), 0);
+        for (std::size_t c = 0; c < found.size(); ++c) {
+            for (std::size_t i = 0; i < found[c].objects.size(); ++i) {
+                const Object * o = found[c].objects[i].second;
+                this->objects[(std::size_t) found[c].objects[i].first] = o;
+                if (o->frozen_table() != nullptr)
+                    this->flags[(std::size_t) found[c].objects[i].first] |=
+                        Object::snapshot_frozen;
+                next.push_back(o);
+            }
+            for (std::size_t i = 0; i < found[c].owned.size(); ++i)
+                this->flags[(std::size_t) found[c].owned[i]] |=
+                    Object::snapshot_owned;
+            for (std::size_t i = 0; i < found[c].types.size(); ++i)
+                this->add_type(found[c].types[i].first,
+                    *found[c].types[i].second);
+        }
+    }
+
+    /**
+     *  \brief Replaces a slot of a clone holding an Object of the graph by
+     *  one holding the clone of that Object.
+     */
+    void relink(Object::Shared_Pointer_And_Type &slot,
+            const std::vector<std::shared_ptr<Object> > &clones) const {
+        const Object::Shared_Pointer_And_Type * built =
+                Object::built_slot(&slot);
+        if (built->p == nullptr || built->t != Object::descriptor<Object>())
+            return;
+        slot = Object::Shared_Pointer_And_Type(clones[(std::size_t)
+                this->object_number(static_cast<const Object *>
+                (built->p.get()))], Object::descriptor<Object>());
+    }
+
+    /**
+     *  \brief Points the properties and parent of clone, a copy of the
+     *  Object numbered n, at the clones of the Objects of the graph.
+     */
+    void relink(std::size_t n,
+            const std::vector<std::shared_ptr<Object> > &clones) const {
+        Object &clone = *clones[n];
+        const Object * parent = this->objects[n]->my_parent;
+        if (parent != nullptr) {
+            const Stripe &s = this->my_stripes[Object_Graph::stripe_index(parent)];
+            auto found = s.numbers.find(parent);
+            if (found != s.numbers.end())
+                clone.my_parent = clones[(std::size_t) found->second].get();
+        }
+        if (clone.frozen_table() != nullptr) {
+            std::shared_ptr<Object::Frozen_Table> table =
+                    std::make_shared<Object::Frozen_Table>(*clone.frozen_table());
+            for (std::size_t i = 0; i < table->entries.size(); ++i)
+                this->relink(table->entries[i].second, clones);
+            clone.my_extension->frozen = table;
+            return;
+        }
+        for (auto it = clone.my_contents.begin();
+                it != clone.my_contents.end(); ++it)
+            this->relink(it->second, clones);
+    }
+
+public:
+
+    /**
+     *  \brief Numbers the Objects reachable from root through properties,
+     *  and through parents when saving. When saving, also numbers the types
+     *  of their values and throws -1 on one that cannot be saved.
+     */
+    Object_Graph(Thread_Pool &pool, const Object &root, bool saving)
+    : objects(), flags(), types(), type_numbers(), my_pool(pool),
+    my_saving(saving), my_count(0) {
+        std::vector<Found> found(1);
+        this->claim(&root, found[0]);
+        std::vector<const Object *> level;
+        this->merge(found, level);
+        while (!level.empty()) {
+            const std::size_t n = level.size();
+            const std::size_t chunk = n < serial_level ? n
+                    : n / (4 * this->my_pool.size()) + 1;
+            found.assign((n + chunk - 1) / chunk, Found());
+            if (n < serial_level) {
+                for (std::size_t i = 0; i < n; ++i)
+                    this->visit(*level[i], found[0]);
+            } else {
+                this->my_pool.parallel_for(n, chunk,
+                        [&](std::size_t begin, std::size_t end) {
+                            Found &f = found[begin / chunk];
+                            for (std::size_t i = begin; i < end; ++i)
+                                this->visit(*level[i], f);
+                        });
+            }
+            level.clear();
+            this->merge(found, level);
+        }
+    }
+
+    Object_Graph(const Object_Graph &) = delete;
+    Object_Graph& operator =(const Object_Graph &) = delete;
+
+    uint64_t object_number(const Object * o) const {
+        const Stripe &s = this->my_stripes[Object_Graph::stripe_index(o)];
+        return s.numbers.find(o)->second;
+    }
+
+    uint64_t type_number(const Object::Type_Descriptor * t) const {
+        return this->type_numbers.find(t)->second;
+    }
+
+    /**
+     *  \brief See deep_clone.
+     */
+    static std::shared_ptr<Object> clone(Thread_Pool &pool, const Object &root) {
+        Object_Graph graph(pool, root, false);
+        const std::size_t n = graph.objects.size();
+        std::vector<std::shared_ptr<Object> > clones(n);
+        pool.parallel_for(n, 0, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i)
+                clones[i] = std::allocate_shared<Object>
+                        (Object::Allocator<Object>(), *graph.objects[i]);
+        });
+        pool.parallel_for(n, 0, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i)
+                graph.relink(i, clones);
+        });
+        return clones[0];
+    }
+
+    /**
+     *  \brief See parallel_save.
+     */
+    static void save(Thread_Pool &pool, const Object &root, std::ostream &out) {
+        Object_Graph graph(pool, root, true);
+        const std::size_t n = graph.objects.size();
+        const std::size_t chunk = n / (4 * pool.size()) + 1;
+        std::vector<std::string> parts((n + chunk - 1) / chunk);
+        pool.parallel_for(n, chunk, [&](std::size_t begin, std::size_t end) {
+            std::string &part = parts[begin / chunk];
+            for (std::size_t i = begin; i < end; ++i)
+                Object::write_snapshot_object(*graph.objects[i], graph, part);
+        });
+        std::vector<const std::string *> pointers;
+        for (std::size_t i = 0; i < parts.size(); ++i)
+            pointers.push_back(&parts[i]);
+        Object::write_snapshot(graph, pointers, out);
+    }
+};
+
+/**
+ * \brief Copies root and every Object reachable from it through properties,
+ * spread over pool. An Object held by several properties is copied once and
+ * the copies share it, like the originals. Parents that are copied are
+ * replaced by their copies; the others, such as prototypes outside the
+ * tree, are kept. Values other than Objects are shared with the originals,
+ * as Object's copy constructor does. Subclasses of Object held as values
+ * are not walked.
+ * @return the copy of root, which owns the other copies
+ */
+inline std::shared_ptr<Object> deep_clone(Thread_Pool &pool, const Object &root) {
+    return Object_Graph::clone(pool, root);
+}
+
+/**
+ * \brief deep_clone on Thread_Pool::shared()
+ */
+inline std::shared_ptr<Object> deep_clone(const Object &root) {
+    return Object_Graph::clone(Thread_Pool::shared(), root);
+}
+
+/**
+ * \brief Writes the same snapshot as root.save(out), which Object::load
+ * reads, with the graph walked and the Objects encoded over pool. The
+ * Objects may be numbered in another order than Object::save numbers them.
+ * Throws -1 like Object::save.
+ */
+inline void parallel_save(Thread_Pool &pool, const Object &root,
+        std::ostream &out) {
+    Object_Graph::save(pool, root, out);
+}
+
+/**
+ * \brief parallel_save on Thread_Pool::shared()
+ */
+inline void parallel_save(const Object &root, std::ostream &out) {
+    Object_Graph::save(Thread_Pool::shared(), root, out);
+}
+#endif    // PROTOTYPAL_C_OBJECT_GRAPH_H_
@@ -0,0 +1,966 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+/*
+ * File:   Object_Journal.h
+ * Created on October 18, 2026
+ */
+
+#ifndef PROTOTYPAL_C_OBJECT_JOURNAL_H_
+#define PROTOTYPAL_C_OBJECT_JOURNAL_H_
+
+#include "Prototypal_Cpp.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**  \brief Write-ahead log of the changes to an Object and everything
+ *  reachable from it, for recovery after a crash.
+ *
+ *  The journal keeps two files: path holds a snapshot written by
+ *  Object::save, and path + ".log" the changes made since. Every set,
+ *  remove, clear, setParent, pass_contents, assignment and freeze of an
+ *  Object reachable from the root appends a compact binary record to the
+ *  log before the change is made: the Object's number, the property name
+ *  (a number after its first use in the log) and the serialized value. An
+ *  Object met for the first time, as a new value, parent or source of
+ *  pass_contents, is numbered and written in full once.
+ *
+ *  Records are collected in memory and written by a background thread, one
+ *  checksummed frame per batch, so that many changes share one write and
+ *  one fsync (group commit). The Sync_Policy says when a change is durable.
+ *  When the log grows past compact_bytes, the next change copies the
+ *  properties of every journaled Object, the records before it are
+ *  dropped, and the writer thread encodes the copy, replaces the snapshot
+ *  file and starts an empty log. Only the copy is made under the lock;
+ *  values are shared with the Objects, so they must not be changed in
+ *  place, which would not be journaled either.
+ *
+ *  Journal::recover loads the snapshot and replays the complete frames of
+ *  the log on top of it. Values must be of registered types, as for
+ *  Object::save, and functions are not journaled. One Journal may be open
+ *  in a process. Objects must not be changed while it is being destroyed,
+ *  and lazy values built while a change is recorded must not change
+ *  journaled Objects.
+ */
+class Journal {
+public:
+
+    /**  \brief When a recorded change reaches the disk.
+     */
+    enum Sync_Policy {
+        /** records are written every interval or batch, and the operating
+         * system decides when they reach the disk */
+        sync_none,
+        /** records are written and synced every interval or batch, so a
+         * crash loses about one interval of changes */
+        sync_interval,
+        /** every change waits until its record is synced. Changes made by
+         * other threads in the meantime share the next fsync. */
+        sync_commit
+    };
+
+    /**  \brief Counters of a Journal, returned by Journal::statistics.
+     */
+    struct Statistics {
+        /** changes recorded */
+        uint64_t changes;
+        /** bytes of their records, with the Objects and types they define */
+        uint64_t record_bytes;
+        /** bytes written to logs, with headers of logs and frames */
+        uint64_t log_bytes;
+        /** bytes of snapshots written */
+        uint64_t snapshot_bytes;
+        uint64_t frames;
+        uint64_t fsyncs;
+        uint64_t compactions;
+
+        /** record bytes per change, the write amplification of the log */
+        double bytes_per_change() const {
+            return changes == 0 ? 0.0 : (double) record_bytes / (double) changes;
+        }
+    };
+
+private:
+
+    /**  \brief Both files start with a magic number, the version and the
+     *  generation, which pairs a log with its snapshot. Then the snapshot
+     *  file holds Object::save output, and the log file frames of a 32-bit
+     *  length, a 32-bit FNV-1a checksum and that many bytes of records.
+     */
+    static const uint32_t snapshot_magic = 0x534a4350; // "PCJS"
+    static const uint32_t log_magic = 0x4c4a4350; // "PCJL"
+    static const uint32_t journal_version = 1;
+    static const std::size_t header_bytes = 16;
+    static const std::size_t frame_header_bytes = 8;
+    /** pending bytes that wake the writer before the interval is over */
+    static const std::size_t batch_bytes = 1 << 20;
+    /** names after this many in a log are written in full every time */
+    static const std::size_t max_names = 1 << 16;
+
+    /**  \brief Record kinds. Every record starts with its kind and, except
+     *  for definitions, the number of the changed Object.
+     *  set: name, value tag as in Object::save, Object number or value.
+     *  remove: name. parent: parent number plus one, or 0.
+     *  contents: number of the Object whose properties are copied.
+     *  objects: count, a flags byte each, then each as in Object::save;
+     *  they take the next numbers. type: the 64-bit id of the next type.
+     *  A name is its number plus one, or 0 followed by its length and
+     *  characters, which gives it the next number.
+     */
+    static const unsigned char record_set = 1;
+    static const unsigned char record_remove = 2;
+    static const unsigned char record_clear = 3;
+    static const unsigned char record_parent = 4;
+    static const unsigned char record_contents = 5;
+    static const unsigned char record_freeze = 6;
+    static const unsigned char record_objects = 7;
+    static const unsigned char record_type = 8;
+
+    Object * my_root;
+    std::string my_path;
+    Sync_Policy my_policy;
+    std::chrono::milliseconds my_interval;
+    uint64_t my_compact_bytes;
+    std::mutex my_mutex;
+    /**
+     *   \brief The writer thread waits here for work
+     */
+    std::condition_variable my_wake;
+    /**
+     *   \brief Changes and flushes wait here for the writer
+     */
+    std::condition_variable my_written;
+    /**
+     *   \brief Numbers of the journaled Objects and value types. Entries
+     *   of destroyed Objects are nullptr.
+     */
+    Object::Snapshot_Index my_index;
+    /**
+     *   \brief The Objects numbered in my_index, read without the lock to
+     *   skip the changes of other Objects
+     */
+    Object::Watch_Filter my_watched;
+    std::unordered_map<std::string, uint64_t> my_names;
+    /**
+     *   \brief Records not yet taken by the writer
+     */
+    std::string my_pending;
+    /**
+     *  \brief What a snapshot needs of the journaled Objects, copied
+     *  under the lock for the writer thread to encode without it: their
+     *  numbers, and the parent and properties of each. A set replaces a
+     *  value rather than change it, so the values are shared rather than
+     *  copied.
+     */
+    struct Snapshot_Copy {
+        Object::Snapshot_Index index;
+        std::vector<const Object *> parents;
+        /** properties of Object i are numbered ends[i - 1] to ends[i] */
+        std::vector<std::string> names;
+        std::vector<Object::Shared_Pointer_And_Type> values;
+        std::vector<std::size_t> ends;
+        uint64_t generation;
+
+        Snapshot_Copy(const Object::Snapshot_Index &index, uint64_t generation)
+        : index(index), parents(), names(), values(), ends(),
+        generation(generation) {
+            std::vector<std::pair<const std::string *,
+                    const Object::Shared_Pointer_And_Type *> > slots;
+            this->parents.reserve(index.objects.size());
+            this->ends.reserve(index.objects.size());
+            for (std::size_t i = 0; i < index.objects.size(); ++i) {
+                index.objects[i]->for_each_slot(Object::Slot_Collector(slots));
+                this->parents.push_back(index.objects[i]->my_parent);
+                this->ends.push_back(slots.size());
+            }
+            this->names.reserve(slots.size());
+            this->values.reserve(slots.size());
+            for (std::size_t i = 0; i < slots.size(); ++i) {
+                this->names.push_back(*slots[i].first);
+                this->values.push_back(*Object::built_slot(slots[i].second));
+                // Objects are only numbered, and not kept alive: the
+                // destructor of an Object takes the lock, which may be held
+                // when a copy is replaced.
+                Object::Shared_Pointer_And_Type &value = this->values.back();
+                if (value.t == Object::descriptor<Object>())
+                    value.p = std::shared_ptr<void>(std::shared_ptr<void>(),
+                        value.p.get());
+            }
+        }
+
+        /**
+         *  \brief The snapshot file: a header, then the Objects as written
+         *  by Object::save.
+         */
+        std::string encode() const {
+            std::string objects;
+            std::vector<std::pair<const std::string *,
+                    const Object::Shared_Pointer_And_Type *> > own;
+            std::size_t begin = 0;
+            for (std::size_t i = 0; i < this->parents.size(); ++i) {
+                own.clear();
+                for (std::size_t j = begin; j < this->ends[i]; ++j)
+                    own.push_back(std::make_pair(&this->names[j],
+                        &this->values[j]));
+                Object::write_snapshot_slots(this->parents[i], own,
+                        this->index, objects);
+                begin = this->ends[i];
+            }
+            std::string header;
+            put_header(header, snapshot_magic, this->generation);
+            std::ostringstream out;
+            out.write(header.data(), (std::streamsize) header.size());
+            Object::write_snapshot(this->index,
+                    std::vector<const std::string *>(1, &objects), out);
+            return out.str();
+        }
+    };
+
+    /**
+     *   \brief Snapshot not yet taken by the writer, nullptr if none
+     */
+    std::unique_ptr<Snapshot_Copy> my_snapshot;
+    uint64_t my_generation;
+    /**
+     *   \brief Record bytes since the last snapshot
+     */
+    uint64_t my_log_size;
+    /**
+     *   \brief Record bytes ever appended, and how many of them the writer
+     *   has made durable
+     */
+    uint64_t my_appended;
+    uint64_t my_durable;
+    uint64_t my_flush_requested;
+    uint64_t my_flush_done;
+    bool my_stopping;
+    bool my_failed;
+    Statistics my_statistics;
+    /**
+     *   \brief Log file, only used by the writer thread
+     */
+    int my_log;
+    bool my_log_unsynced;
+    std::thread my_writer;
+
+    static void fail(const char *caller, const std::string &name,
+            const char *problem, int line) {
+        printf("In Journal.%s(\"%s\"), %s.\n  "
+                "See line number %d in file %s\n\n",
+                caller, name.c_str(), problem, line, __FILE__);
+        throw -1;
+    }
+
+    static Journal *& active() {
+        static Journal * journal = nullptr;
+        return journal;
+    }
+
+    /**
+     *  \brief Added with Object::add_change_hook while a Journal is open.
+     */
+    static void on_change(Object &object, Object::Change change,
+            const std::string * name, const void * value,
+            const Object::Type_Descriptor * type) {
+        Journal * journal = Journal::active();
+        if (journal != nullptr)
+            journal->record(object, change, name, value, type);
+    }
+
+    static uint32_t checksum(const char *p, std::size_t n) {
+        uint32_t h = 2166136261u;
+        for (std::size_t i = 0; i < n; ++i) {
+            h ^= (unsigned char) p[i];
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    static void put_header(std::string &out, uint32_t magic,
+            uint64_t generation) {
+        uint32_t words[2] = {magic, journal_version};
+        out.append(reinterpret_cast<const char *> (words), sizeof (words));
+        out.append(reinterpret_cast<const char *> (&generation),
+                sizeof (generation));
+    }
+
+    /**
+     *  \brief Reads a header written by put_header.
+     *  @return false if it is short or has another magic or version
+     */
+    static bool get_header(const char *p, std::size_t n, uint32_t magic,
+            uint64_t &generation) {
+        if (n < header_bytes)
+            return false;
+        uint32_t words[2];
+        std::copy(p, p + 8, reinterpret_cast<char *> (words));
+        std::copy(p + 8, p + 16, reinterpret_cast<char *> (&generation));
+        return words[0] == magic && words[1] == journal_version;
+    }
+
+    static bool write_all(int fd, const char *p, std::size_t n) {
+        while (n > 0) {
+            ssize_t written = ::write(fd, p, n);
+            if (written < 0 && errno == EINTR)
+                continue;
+            if (written <= 0)
+                return false;
+            p += written;
+            n -= (std::size_t) written;
+        }
+        return true;
+    }
+
+    /**
+     *  \brief Adds the Objects of my_index from number first on to
+     *  my_watched.
+     */
+    void watch(std::size_t first) {
+        for (std::size_t i = first; i < this->my_index.objects.size(); ++i)
+            this->my_watched.add(this->my_index.objects[i]);
+        if (this->my_watched.crowded())
+            this->my_watched.rebuild(this->my_index.objects);
+    }
+
+    /**
+     *  \brief Drops the number of an Object being destroyed.
+     */
+    void forget(const Object * o) {
+        auto found = this->my_index.object_numbers.find(o);
+        if (found == this->my_index.object_numbers.end())
+            return;
+        this->my_index.objects[found->second] = nullptr;
+        this->my_index.object_numbers.erase(found);
+        this->my_watched.remove(o);
+        if (o == this->my_root)
+            this->my_root = nullptr;
+    }
+
+    /**
+     *  \brief Number of o. An Object without one is numbered with the new
+     *  Objects and types it reaches, and their definitions are appended to
+     *  out. Throws -1, numbering nothing, if one of them holds a value that
+     *  cannot be saved.
+     */
+    uint64_t define(const Object * o, std::string &out) {
+        auto found = this->my_index.object_numbers.find(o);
+        if (found != this->my_index.object_numbers.end())
+            return found->second;
+        Object::Snapshot_Index &index = this->my_index;
+        const std::size_t first = index.objects.size();
+        const std::size_t first_type = index.types.size();
+        try {
+            index.add(o);
+            index.expand(first);
+        } catch (...) {
+            for (std::size_t i = first; i < index.objects.size(); ++i)
+                index.object_numbers.erase(index.objects[i]);
+            for (std::size_t i = first_type; i < index.types.size(); ++i)
+                index.type_numbers.erase(index.types[i]);
+            index.objects.resize(first);
+            index.flags.resize(first);
+            index.types.resize(first_type);
+            throw;
+        }
+        this->watch(first);
+        for (std::size_t i = first_type; i < index.types.size(); ++i)
+            this->put_type(index.types[i], out);
+        out.push_back((char) record_objects);
+        Object::put_varint(out, index.objects.size() - first);
+        for (std::size_t i = first; i < index.objects.size(); ++i)
+            out.push_back((char) (index.flags[i] & Object::snapshot_frozen));
+        for (std::size_t i = first; i < index.objects.size(); ++i)
+            Object::write_snapshot_object(*index.objects[i], index, out);
+        return first;
+    }
+
+    static void put_type(const Object::Type_Descriptor * t, std::string &out) {
+        out.push_back((char) record_type);
+        out.append(reinterpret_cast<const char *> (&t->id), sizeof (uint64_t));
+    }
+
+    void put_name(const std::string &name, std::string &out) {
+        auto found = this->my_names.find(name);
+        if (found != this->my_names.end()) {
+            Object::put_varint(out, found->second + 1);
+            return;
+        }
+        Object::put_varint(out, 0);
+        Object::put_varint(out, name.size());
+        out.append(name);
+        if (this->my_names.size() < max_names) {
+            uint64_t n = this->my_names.size();
+            this->my_names[name] = n;
+        }
+    }
+
+    /**
+     *  \brief Appends the record of one change to my_pending, and waits
+     *  for it to be synced under sync_commit. Changes to Objects that are
+     *  not journaled return at once, mostly without taking the lock.
+     */
+    void record(Object &object, Object::Change change,
+            const std::string * name, const void * value,
+            const Object::Type_Descriptor * type) {
+        if (!this->my_watched.may_contain(&object))
+            return;
+        std::unique_lock<std::mutex> lock(this->my_mutex);
+        if (change == Object::change_destroy) {
+            this->forget(&object);
+            return;
+        }
+        if (this->my_index.object_numbers.find(&object) ==
+                this->my_index.object_numbers.end())
+            return;
+        if (change == Object::change_set && type != nullptr && type->is_lazy) {
+            // Built without the lock, since building may change other
+            // journaled Objects.
+            lock.unlock();
+            const Object::Shared_Pointer_And_Type &built =
+                    static_cast<Object::Lazy_Cell *> (const_cast<void *> (value))
+                    ->force();
+            value = built.p.get();
+            type = built.t;
+            lock.lock();
+        }
+        if (this->my_failed)
+            fail("record", name == nullptr ? "" : *name,
+                "the log could not be written", __LINE__);
+        if (this->my_compact_bytes != 0 &&
+                this->my_log_size >= this->my_compact_bytes)
+            this->compact_locked();
+        auto found = this->my_index.object_numbers.find(&object);
+        if (found == this->my_index.object_numbers.end())
+            return;
+        const uint64_t number = found->second;
+        std::string definitions, r;
+        switch (change) {
+            case Object::change_set:
+            {
+                uint64_t tag = Object::snapshot_empty, other = 0;
+                if (value != nullptr && type == Object::descriptor<Object>()) {
+                    other = this->define(static_cast<const Object *> (value),
+                            definitions);
+                    tag = Object::snapshot_object;
+                } else if (value != nullptr && type != nullptr) {
+                    const std::size_t types = this->my_index.types.size();
+                    tag = this->my_index.add_type(type, *name) + 2;
+                    if (this->my_index.types.size() != types)
+                        this->put_type(type, definitions);
+                }
+                r.push_back((char) record_set);
+                Object::put_varint(r, number);
+                this->put_name(*name, r);
+                Object::put_varint(r, tag);
+                if (tag == Object::snapshot_object)
+                    Object::put_varint(r, other);
+                else if (tag != Object::snapshot_empty)
+                    type->serialize(value, r);
+                break;
+            }
+            case Object::change_remove:
+                r.push_back((char) record_remove);
+                Object::put_varint(r, number);
+                this->put_name(*name, r);
+                break;
+            case Object::change_clear:
+                r.push_back((char) record_clear);
+                Object::put_varint(r, number);
+                break;
+            case Object::change_parent:
+            {
+                uint64_t parent = value == nullptr ? 0 : this->define
+                        (static_cast<const Object *> (value), definitions) + 1;
+                r.push_back((char) record_parent);
+                Object::put_varint(r, number);
+                Object::put_varint(r, parent);
+                break;
+            }
+            case Object::change_contents:
+            {
+                uint64_t other = this->define(static_cast<const Object *>
+                        (value), definitions);
+                r.push_back((char) record_contents);
+                Object::put_varint(r, number);
+                Object::put_varint(r, other);
+                break;
+            }
+            case Object::change_freeze:
+                r.push_back((char) record_freeze);
+                Object::put_varint(r, number);
+                break;
+            default:
+                return;
+        }
+        this->my_pending.append(definitions);
+        this->my_pending.append(r);
+        const uint64_t bytes = definitions.size() + r.size();
+        this->my_log_size += bytes;
+        this->my_appended += bytes;
+        this->my_statistics.changes += 1;
+        this->my_statistics.record_bytes += bytes;
+        if (this->my_policy == sync_commit) {
+            const uint64_t end = this->my_appended;
+            this->my_wake.notify_one();
+            this->my_written.wait(lock, [this, end] {
+                return this->my_durable >= end || this->my_failed;
+            });
+            if (this->my_durable < end)
+                fail("record", name == nullptr ? "" : *name,
+                    "the log could not be written", __LINE__);
+        } else if (this->my_pending.size() >= batch_bytes) {
+            this->my_wake.notify_one();
+        }
+    }
+
+    /**
+     *  \brief Copies a snapshot of the root for the writer and starts a
+     *  new generation of the log. Records not yet written are dropped,
+     *  since the snapshot holds their changes. Encoding is left to the
+     *  writer thread, so that changes wait for the copy only.
+     */
+    void compact_locked() {
+        if (this->my_root == nullptr)
+            return;
+        Object::Snapshot_Index index(*this->my_root);
+        this->my_snapshot.reset(new Snapshot_Copy(index,
+                this->my_generation + 1));
+        this->my_generation += 1;
+        this->my_pending.clear();
+        this->my_log_size = 0;
+        this->my_names.clear();
+        for (std::size_t i = 0; i < this->my_index.objects.size(); ++i)
+            if (this->my_index.objects[i] != nullptr)
+                this->my_watched.remove(this->my_index.objects[i]);
+        this->my_index = std::move(index);
+        this->watch(0);
+        this->my_statistics.compactions += 1;
+        this->my_wake.notify_one();
+    }
+
+    /**
+     *  \brief Replaces the snapshot file with snapshot, through a
+     *  temporary file, and starts an empty log of generation.
+     */
+    bool write_snapshot(const std::string &snapshot, uint64_t generation) {
+        const std::string temporary = this->my_path + ".tmp";
+        int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+            return false;
+        bool written = write_all(fd, snapshot.data(), snapshot.size()) &&
+                ::fsync(fd) == 0;
+        if (::close(fd) != 0 || !written ||
+                ::rename(temporary.c_str(), this->my_path.c_str()) != 0)
+            return false;
+        std::string::size_type slash = this->my_path.rfind('/');
+        std::string directory = slash == std::string::npos ? "." :
+                this->my_path.substr(0, slash + 1);
+        int dir = ::open(directory.c_str(), O_RDONLY);
+        if (dir >= 0) {
+            ::fsync(dir);
+            ::close(dir);
+        }
+        if (this->my_log >= 0)
+            ::close(this->my_log);
+        this->my_log = ::open((this->my_path + ".log").c_str(),
+                O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (this->my_log < 0)
+            return false;
+        std::string header;
+        put_header(header, log_magic, generation);
+        this->my_log_unsynced = true;
+        return write_all(this->my_log, header.data(), header.size());
+    }
+
+    /**
+     *  \brief The writer thread: takes the pending snapshot and records,
+     *  writes them without holding the lock, then wakes the changes and
+     *  flushes they made durable.
+     */
+    void write_loop() {
+        std::unique_lock<std::mutex> lock(this->my_mutex);
+        std::chrono::steady_clock::time_point due =
+                std::chrono::steady_clock::now() + this->my_interval;
+        while (true) {
+            const bool flushing = this->my_flush_done != this->my_flush_requested;
+            const bool work = this->my_snapshot != nullptr || flushing ||
+                    (!this->my_pending.empty() && (this->my_stopping ||
+                    this->my_policy == sync_commit ||
+                    this->my_pending.size() >= batch_bytes ||
+                    std::chrono::steady_clock::now() >= due));
+            if (!work) {
+                if (this->my_stopping)
+                    break;
+                if (this->my_pending.empty())
+                    this->my_wake.wait(lock);
+                else
+                    this->my_wake.wait_until(lock, due);
+                continue;
+            }
+            std::unique_ptr<Snapshot_Copy> copy(std::move(this->my_snapshot));
+            std::string pending;
+            pending.swap(this->my_pending);
+            const uint64_t generation = this->my_generation;
+            const uint64_t end = this->my_appended;
+            const uint64_t flush = this->my_flush_requested;
+            const bool sync = this->my_policy != sync_none || flushing ||
+                    this->my_stopping;
+            bool ok = !this->my_failed;
+            lock.unlock();
+            Statistics written = Statistics();
+            if (ok && copy != nullptr) {
+                std::string snapshot;
+                try {
+                    snapshot = copy->encode();
+                } catch (...) {
+                    ok = false;
+                }
+                copy.reset();
+                ok = ok && this->write_snapshot(snapshot, generation);
+                written.snapshot_bytes += snapshot.size();
+                written.log_bytes += header_bytes;
+                written.fsyncs += 2;
+            }
+            if (ok && !pending.empty()) {
+                uint32_t frame[2] = {(uint32_t) pending.size(),
+                    checksum(pending.data(), pending.size())};
+                ok = write_all(this->my_log, reinterpret_cast<const char *>
+                        (frame), sizeof (frame)) &&
+                        write_all(this->my_log, pending.data(), pending.size());
+                this->my_log_unsynced = true;
+                written.log_bytes += frame_header_bytes + pending.size();
+                written.frames += 1;
+            }
+            if (ok && sync && this->my_log_unsynced) {
+                ok = ::fsync(this->my_log) == 0;
+                this->my_log_unsynced = false;
+                written.fsyncs += 1;
+            }
+            lock.lock();
+            if (!ok && !this->my_failed) {
+                this->my_failed = true;
+                printf("In Journal, %s could not be written.\n  "
+                        "See line number %d in file %s\n\n",
+                        this->my_path.c_str(), __LINE__, __FILE__);
+            }
+            this->my_statistics.snapshot_bytes += written.snapshot_bytes;
+            this->my_statistics.log_bytes += written.log_bytes;
+            this->my_statistics.frames += written.frames;
+            this->my_statistics.fsyncs += written.fsyncs;
+            if (ok)
+                this->my_durable = end;
+            this->my_flush_done = flush;
+            this->my_written.notify_all();
+            due = std::chrono::steady_clock::now() + this->my_interval;
+        }
+    }
+
+    /**
+     *  \brief Applies the records of one frame to objects.
+     */
+    static void replay(const char *p, const char *end,
+            std::vector<std::shared_ptr<Object> > &objects,
+            std::vector<const Object::Type_Descriptor *> &types,
+            std::vector<std::string> &names) {
+        std::string name;
+        while (p != end) {
+            const unsigned char kind = (unsigned char) *p++;
+            uint64_t n, m;
+            if (kind == record_type) {
+                uint64_t id;
+                if (end - p < (std::ptrdiff_t) sizeof (id))
+                    corrupt(__LINE__);
+                std::copy(p, p + sizeof (id), reinterpret_cast<char *> (&id));
+                p += sizeof (id);
+                const Object::Type_Descriptor * t = Object::find_type(id);
+                if (t == nullptr || t->deserialize == nullptr)
+                    fail("recover", "", "the log holds a type that is not "
+                        "registered", __LINE__);
+                types.push_back(t);
+                continue;
+            }
+            if (kind == record_objects) {
+                if (!Object::get_varint(p, end, n) || n > (uint64_t) (end - p))
+                    corrupt(__LINE__);
+                const std::size_t first = objects.size();
+                const char * flags = p;
+                p += n;
+                for (uint64_t i = 0; i < n; ++i)
+                    objects.push_back(std::allocate_shared<Object>
+                        (Object::Allocator<Object>()));
+                for (std::size_t i = first; i < objects.size(); ++i)
+                    Object::read_snapshot_object(*objects[i], p, end, objects,
+                        types);
+                for (std::size_t i = first; i < objects.size(); ++i) {
+                    if (flags[i - first] & Object::snapshot_frozen)
+                        objects[i]->freeze();
+                }
+                continue;
+            }
+            if (!Object::get_varint(p, end, n) || n >= objects.size())
+                corrupt(__LINE__);
+            Object &o = *objects[(std::size_t) n];
+            switch (kind) {
+                case record_set:
+                {
+                    get_name(p, end, names, name);
+                    Object::Shared_Pointer_And_Type slot;
+                    if (!Object::get_varint(p, end, m) || m >= types.size() + 2)
+                        corrupt(__LINE__);
+                    if (m == Object::snapshot_object) {
+                        uint64_t other;
+                        if (!Object::get_varint(p, end, other) ||
+                                other >= objects.size())
+                            corrupt(__LINE__);
+                        slot = Object::Shared_Pointer_And_Type
+                                (objects[(std::size_t) other],
+                                Object::descriptor<Object>());
+                    } else if (m != Object::snapshot_empty) {
+                        const Object::Type_Descriptor * t = types[m - 2];
+                        slot = Object::Shared_Pointer_And_Type
+                                (t->deserialize(p, end), t);
+                        if (slot.p == nullptr)
+                            corrupt(__LINE__);
+                    }
+                    if (slot.p != nullptr)
+                        Object::call_slot_hook(slot.p, slot.t);
+                    o.store(name, slot);
+                    break;
+                }
+                case record_remove:
+                    get_name(p, end, names, name);
+                    o.remove(name);
+                    break;
+                case record_clear:
+                    o.clear();
+                    break;
+                case record_parent:
+                    if (!Object::get_varint(p, end, m) || m > objects.size())
+                        corrupt(__LINE__);
+                    if (m == 0)
+                        o.my_parent = nullptr;
+                    else
+                        o.setParent(*objects[(std::size_t) m - 1]);
+                    break;
+                case record_contents:
+                {
+                    if (!Object::get_varint(p, end, m) || m >= objects.size())
+                        corrupt(__LINE__);
+                    Object * parent = o.my_parent;
+                    o = *objects[(std::size_t) m];
+                    o.my_parent = parent;
+                    break;
+                }
+                case record_freeze:
+                    o.freeze();
+                    break;
+                default:
+                    corrupt(__LINE__);
+            }
+        }
+    }
+
+    static void get_name(const char *&p, const char *end,
+            std::vector<std::string> &names, std::string &name) {
+        uint64_t n, length;
+        if (!Object::get_varint(p, end, n) || n > names.size())
+            corrupt(__LINE__);
+        if (n != 0) {
+            name = names[(std::size_t) n - 1];
+            return;
+        }
+        if (!Object::get_varint(p, end, length) || length > (uint64_t) (end - p))
+            corrupt(__LINE__);
+        name.assign(p, (std::size_t) length);
+        p += length;
+        if (names.size() < max_names)
+            names.push_back(name);
+    }
+
+    static void corrupt(int line) {
+        fail("recover", "", "a frame of the log is corrupt", line);
+    }
+
+public:
+
+    /**
+     *  \brief Journals root and everything reachable from it in path and
+     *  path + ".log". Writes a snapshot of root first, replacing those
+     *  files. Throws -1 if another Journal is open, if root holds a value
+     *  that cannot be saved, or if the snapshot cannot be written.
+     *  @param interval - longest wait before pending records are written
+     *  @param compact_bytes - log size that starts a new snapshot, 0 never
+     */
+    Journal(const std::string &path, Object &root,
+            Sync_Policy policy = sync_interval,
+            std::chrono::milliseconds interval = std::chrono::milliseconds(50),
+            uint64_t compact_bytes = 64 << 20)
+    : my_root(&root), my_path(path), my_policy(policy), my_interval(interval),
+    my_compact_bytes(compact_bytes), my_mutex(), my_wake(), my_written(),
+    my_index(root), my_watched(), my_names(), my_pending(), my_snapshot(),
+    my_generation((uint64_t) std::chrono::system_clock::now()
+    .time_since_epoch().count()), my_log_size(0), my_appended(0),
+    my_durable(0), my_flush_requested(0), my_flush_done(0),
+    my_stopping(false), my_failed(false), my_statistics(), my_log(-1),
+    my_log_unsynced(false), my_writer() {
+        if (Journal::active() != nullptr)
+            fail("Journal", path, "another Journal is open", __LINE__);
+        this->watch(0);
+        this->my_snapshot.reset(new Snapshot_Copy(this->my_index,
+                this->my_generation));
+        this->my_writer = std::thread(&Journal::write_loop, this);
+        Journal::active() = this;
+        Object::add_change_hook(&Journal::on_change);
+        try {
+            this->flush();
+        } catch (...) {
+            this->close();
+            throw;
+        }
+    }
+
+    Journal(const Journal &) = delete;
+    Journal& operator =(const Journal &) = delete;
+
+    /**
+     *  \brief Writes and syncs the pending records, then closes the log.
+     */
+    ~Journal() {
+        this->close();
+    }
+
+    /**
+     *  \brief Stops journaling. Pending records are written and synced.
+     *  Later changes are not recorded.
+     */
+    void close() {
+        if (Journal::active() == this) {
+            Object::remove_change_hook(&Journal::on_change);
+            Journal::active() = nullptr;
+        }
+        {
+            std::lock_guard<std::mutex> lock(this->my_mutex);
+            this->my_stopping = true;
+        }
+        this->my_wake.notify_one();
+        if (this->my_writer.joinable())
+            this->my_writer.join();
+        if (this->my_log >= 0)
+            ::close(this->my_log);
+        this->my_log = -1;
+    }
+
+    /**
+     *  \brief Blocks until every change recorded so far is synced, whatever
+     *  the policy. Throws -1 if the log could not be written.
+     */
+    void flush() {
+        std::unique_lock<std::mutex> lock(this->my_mutex);
+        const uint64_t target = ++this->my_flush_requested;
+        this->my_wake.notify_one();
+        this->my_written.wait(lock, [this, target] {
+            return this->my_flush_done >= target;
+        });
+        if (this->my_failed || this->my_durable < this->my_appended)
+            fail("flush", this->my_path, "the log could not be written",
+                __LINE__);
+    }
+
+    /**
+     *  \brief Copies a snapshot of the root now and drops the log; the
+     *  writer thread encodes it and replaces the files. Objects must not be
+     *  changed by other threads meanwhile.
+     */
+    void compact() {
+        std::lock_guard<std::mutex> lock(this->my_mutex);
+        this->compact_locked();
+    }
+
+    /**
+     *  \brief Counters since the Journal was opened.
+     */
+    Statistics statistics() {
+        std::lock_guard<std::mutex> lock(this->my_mutex);
+        return this->my_statistics;
+    }
+
+    /**
+     *  \brief Rebuilds the Object journaled in path: loads the snapshot,
+     *  then replays the log frames written after it, up to the first frame
+     *  that is incomplete or fails its checksum, as left by a crash.
+     *  Objects that are parents but not held by a property are kept alive
+     *  by the returned pointer, as with Object::load.
+     *  Throws -1 if the snapshot cannot be read or a type is not registered.
+     */
+    static std::shared_ptr<Object> recover(const std::string &path) {
+        std::ifstream in(path.c_str(), std::ios::binary);
+        char header[header_bytes];
+        uint64_t generation, log_generation;
+        if (!in.read(header, sizeof (header)) ||
+                !get_header(header, sizeof (header), snapshot_magic, generation))
+            fail("recover", path, "the file is not a journal snapshot",
+                __LINE__);
+        std::vector<std::shared_ptr<Object> > objects;
+        std::vector<const Object::Type_Descriptor *> types;
+        std::shared_ptr<Object> root = Object::read_snapshot(in, objects, types);
+        std::ifstream log_in((path + ".log").c_str(), std::ios::binary);
+        std::string log((std::istreambuf_iterator<char>(log_in)),
+                std::istreambuf_iterator<char>());
+        if (get_header(log.data(), log.size(), log_magic, log_generation) &&
+                log_generation == generation) {
+            std::vector<std::string> names;
+            const char * p = log.data() + header_bytes;
+            const char * end = log.data() + log.size();
+            while ((std::size_t) (end - p) >= frame_header_bytes) {
+                uint32_t frame[2];
+                std::copy(p, p + sizeof (frame), reinterpret_cast<char *> (frame));
+                p += sizeof (frame);
+                if (frame[0] > (uint64_t) (end - p) ||
+                        checksum(p, frame[0]) != frame[1])
+                    break;
+                replay(p, p + frame[0], objects, types, names);
+                p += frame[0];
+            }
+        }
+        Object::Snapshot_Index reachable(*root);
+        std::unordered_map<const Object *, std::size_t> numbers;
+        for (std::size_t i = 0; i < objects.size(); ++i)
+            numbers[objects[i].get()] = i;
+        std::shared_ptr<std::vector<std::shared_ptr<Object> > > roots =
+                std::make_shared<std::vector<std::shared_ptr<Object> > >();
+        for (std::size_t i = 0; i < reachable.objects.size(); ++i) {
+            if (i == 0 || !(reachable.flags[i] & Object::snapshot_owned))
+                roots->push_back(objects[numbers.find
+                    (reachable.objects[i])->second]);
+        }
+        return std::shared_ptr<Object>(roots, root.get());
+    }
+};
+#endif    // PROTOTYPAL_C_OBJECT_JOURNAL_H_
@@ -0,0 +1,769 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+/*
+ * File:   Object_Json.h
+ * Created on October 18, 2026
+ */
+
+#ifndef PROTOTYPAL_C_OBJECT_JSON_H_
+#define PROTOTYPAL_C_OBJECT_JSON_H_
+
+#include "Prototypal_Cpp.h"
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <clocale>
+#include <cmath>
+#include <algorithm>
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/**
+ * \brief Parent of every Object that json_read builds from a JSON array.
+ * Such an Object has the properties "0", "1", ... and "length", a long
+ * long, and json_write writes it back as an array.
+ */
+inline Object & json_array_prototype() {
+    static Object prototype;
+    return prototype;
+}
+
+/**
+ * \brief The decimal point of the C library's current locale, which
+ * strtod reads and snprintf writes. JSON numbers always use '.'.
+ */
+inline char json_decimal_point() {
+    return *localeconv()->decimal_point;
+}
+
+/**  \brief Event driven JSON parser. Reads its input in blocks and calls
+ *  the Handler for every value as it is read, without building a document:
+ *
+ *  begin_object(), key(std::string &), end_object(), begin_array(),
+ *  end_array(), null_value(), bool_value(bool), integer_value(long long),
+ *  double_value(double) and string_value(std::string &).
+ *
+ *  Integers that do not fit in a long long are passed to double_value.
+ *  Strings are passed unescaped, in UTF-8, and the handler may move them.
+ *  Nesting is tracked on an explicit stack, so deep documents do not
+ *  exhaust the call stack. Throws -1 on malformed input.
+ */
+template <class Handler> class Json_Parser {
+    std::istream &my_in;
+    Handler &my_handler;
+    std::vector<char> my_buffer;
+    std::size_t my_position;
+    std::size_t my_end;
+    /** bytes of input before my_buffer */
+    long long my_offset;
+
+    void fail(const char *problem, int line) {
+        printf("In json_read, %s at byte %lld.\n  "
+                "See line number %d in file %s\n\n", problem,
+                this->my_offset + (long long) this->my_position, line, __FILE__);
+        throw -1;
+    }
+
+    bool refill() {
+        this->my_offset += (long long) this->my_end;
+        this->my_in.read(this->my_buffer.data(),
+                (std::streamsize) this->my_buffer.size());
+        this->my_position = 0;
+        this->my_end = (std::size_t) this->my_in.gcount();
+        return this->my_end != 0;
+    }
+
+    /**
+     *  \brief The next byte without consuming it, -1 at the end.
+     */
+    int peek() {
+        if (this->my_position == this->my_end && !this->refill())
+            return -1;
+        return (unsigned char) this->my_buffer[this->my_position];
+    }
+
+    int next() {
+        int c = this->peek();
+        if (c >= 0)
+            ++this->my_position;
+        return c;
+    }
+
+    /**
+     *  \brief Skips white space and returns the next byte, not consumed.
+     */
+    int skip_space() {
+        while (true) {
+            int c = this->peek();
+            if (c != ' ' && c != '\n' && c != '\r' && c != '\t')
+                return c;
+            ++this->my_position;
+        }
+    }
+
+    void expect(const char *word) {
+        for (; *word != '\0'; ++word) {
+            if (this->next() != *word)
+                this->fail("invalid literal", __LINE__);
+        }
+    }
+
+    static void put_utf8(std::string &s, uint32_t c) {
+        if (c < 0x80) {
+            s.push_back((char) c);
+        } else if (c < 0x800) {
+            s.push_back((char) (0xC0 | (c >> 6)));
+            s.push_back((char) (0x80 | (c & 0x3F)));
+        } else if (c < 0x10000) {
+            s.push_back((char) (0xE0 | (c >> 12)));
+            s.push_back((char) (0x80 | ((c >> 6) & 0x3F)));
+            s.push_back((char) (0x80 | (c & 0x3F)));
+        } else {
+            s.push_back((char) (0xF0 | (c >> 18)));
+            s.push_back((char) (0x80 | ((c >> 12) & 0x3F)));
+            s.push_back((char) (0x80 | ((c >> 6) & 0x3F)));
+            s.push_back((char) (0x80 | (c & 0x3F)));
+        }
+    }
+
+    uint32_t hex4() {
+        uint32_t v = 0;
+        for (int i = 0; i < 4; ++i) {
+            int c = this->next();
+            v <<= 4;
+            if (c >= '0' && c <= '9')
+                v |= (uint32_t) (c - '0');
+            else if (c >= 'a' && c <= 'f')
+                v |= (uint32_t) (c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F')
+                v |= (uint32_t) (c - 'A' + 10);
+            else
+                this->fail("invalid \\u escape", __LINE__);
+        }
+        return v;
+    }
+
+    /**
+     *  \brief Reads a string after its opening quote into s. Runs without
+     *  escapes are appended a block at a time.
+     */
+    void read_string(std::string &s) {
+        s.clear();
+        while (true) {
+            std::size_t start = this->my_position;
+            while (this->my_position < this->my_end) {
+                char c = this->my_buffer[this->my_position];
+                if (c == '"' || c == '\\' || (unsigned char) c < 0x20)
+                    break;
+                ++this->my_position;
+            }
+            s.append(this->my_buffer.data() + start, this->my_position - start);
+            int c = this->next();
+            if (c == '"')
+                return;
+            if (c < 0)
+                this->fail("unterminated string", __LINE__);
+            if (c != '\\') {
+                if (c < 0x20)
+                    this->fail("control character in string", __LINE__);
+                continue;
+            }
+            c = this->next();
+            switch (c) {
+                case '"': s.push_back('"');
+                    break;
+                case '\\': s.push_back('\\');
+                    break;
+                case '/': s.push_back('/');
+                    break;
+                case 'b': s.push_back('\b');
+                    break;
+                case 'f': s.push_back('\f');
+                    break;
+                case 'n': s.push_back('\n');
+                    break;
+                case 'r': s.push_back('\r');
+                    break;
+                case 't': s.push_back('\t');
+                    break;
+                case 'u':
+                {
+                    uint32_t u = this->hex4();
+                    if (u >= 0xD800 && u < 0xDC00) {
+                        if (this->next() != '\\' || this->next() != 'u')
+                            this->fail("unpaired surrogate", __LINE__);
+                        uint32_t low = this->hex4();
+                        if (low < 0xDC00 || low >= 0xE000)
+                            this->fail("unpaired surrogate", __LINE__);
+                        u = 0x10000 + ((u - 0xD800) << 10) + (low - 0xDC00);
+                    } else if (u >= 0xDC00 && u < 0xE000) {
+                        this->fail("unpaired surrogate", __LINE__);
+                    }
+                    put_utf8(s, u);
+                    break;
+                }
+                default:
+                    this->fail("invalid escape", __LINE__);
+            }
+        }
+    }
+
+    /**
+     *  \brief Appends the digits that follow to text.
+     *  @return false if there are none
+     */
+    bool read_digits(std::string &text) {
+        std::size_t before = text.size();
+        for (int c = this->peek(); c >= '0' && c <= '9'; c = this->peek()) {
+            text.push_back((char) c);
+            ++this->my_position;
+        }
+        return text.size() != before;
+    }
+
+    /**
+     *  \brief Reads a number spelled as JSON allows,
+     *  -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?, whatever the locale.
+     */
+    void read_number(std::string &text) {
+        text.clear();
+        bool integer = true;
+        if (this->peek() == '-')
+            text.push_back((char) this->next());
+        if (this->peek() == '0') {
+            text.push_back((char) this->next());
+            int c = this->peek();
+            if (c >= '0' && c <= '9')
+                this->fail("leading zero in number", __LINE__);
+        } else if (!this->read_digits(text)) {
+            this->fail("invalid number", __LINE__);
+        }
+        if (this->peek() == '.') {
+            integer = false;
+            text.push_back(json_decimal_point());
+            ++this->my_position;
+            if (!this->read_digits(text))
+                this->fail("invalid number", __LINE__);
+        }
+        if (this->peek() == 'e' || this->peek() == 'E') {
+            integer = false;
+            text.push_back((char) this->next());
+            if (this->peek() == '+' || this->peek() == '-')
+                text.push_back((char) this->next());
+            if (!this->read_digits(text))
+                this->fail("invalid number", __LINE__);
+        }
+        char * end = nullptr;
+        if (integer) {
+            errno = 0;
+            long long v = strtoll(text.c_str(), &end, 10);
+            if (errno != ERANGE) {
+                this->my_handler.integer_value(v);
+                return;
+            }
+        }
+        this->my_handler.double_value(strtod(text.c_str(), &end));
+    }
+
+public:
+
+    Json_Parser(std::istream &in, Handler &handler) : my_in(in),
+    my_handler(handler), my_buffer(1 << 16), my_position(0), my_end(0),
+    my_offset(0) {
+    }
+
+    /**
+     *  \brief Parses one JSON value, which must be followed only by white
+     *  space.
+     */
+    void run() {
+        // '{' or '[' for every open container
+        std::vector<char> open;
+        std::string text;
+        bool want_value = true;
+        while (true) {
+            int c = this->skip_space();
+            if (want_value) {
+                ++this->my_position;
+                switch (c) {
+                    case '{':
+                        this->my_handler.begin_object();
+                        if (this->skip_space() == '}') {
+                            ++this->my_position;
+                            this->my_handler.end_object();
+                            want_value = false;
+                            break;
+                        }
+                        open.push_back('{');
+                        if (this->next() != '"')
+                            this->fail("expected a key", __LINE__);
+                        this->read_string(text);
+                        this->my_handler.key(text);
+                        if (this->skip_space() != ':')
+                            this->fail("expected ':'", __LINE__);
+                        ++this->my_position;
+                        continue;
+                    case '[':
+                        this->my_handler.begin_array();
+                        if (this->skip_space() == ']') {
+                            ++this->my_position;
+                            this->my_handler.end_array();
+                            want_value = false;
+                            break;
+                        }
+                        open.push_back('[');
+                        continue;
+                    case '"':
+                        this->read_string(text);
+                        this->my_handler.string_value(text);
+                        break;
+                    case 't':
+                        this->expect("rue");
+                        this->my_handler.bool_value(true);
+                        break;
+                    case 'f':
+                        this->expect("alse");
+                        this->my_handler.bool_value(false);
+                        break;
+                    case 'n':
+                        this->expect("ull");
+                        this->my_handler.null_value();
+                        break;
+                    default:
+                        if (c != '-' && (c < '0' || c > '9'))
+                            this->fail("expected a value", __LINE__);
+                        --this->my_position;
+                        this->read_number(text);
+                }
+                want_value = false;
+                continue;
+            }
+            if (open.empty()) {
+                if (c >= 0)
+                    this->fail("unexpected data after the value", __LINE__);
+                return;
+            }
+            ++this->my_position;
+            if (c == ',') {
+                want_value = true;
+                if (open.back() == '{') {
+                    if (this->skip_space() != '"')
+                        this->fail("expected a key", __LINE__);
+                    ++this->my_position;
+                    this->read_string(text);
+                    this->my_handler.key(text);
+                    if (this->skip_space() != ':')
+                        this->fail("expected ':'", __LINE__);
+                    ++this->my_position;
+                }
+            } else if (c == '}' && open.back() == '{') {
+                open.pop_back();
+                this->my_handler.end_object();
+            } else if (c == ']' && open.back() == '[') {
+                open.pop_back();
+                this->my_handler.end_array();
+            } else {
+                this->fail(c < 0 ? "unexpected end of input"
+                        : "expected ',' or the end of a container", __LINE__);
+            }
+        }
+    }
+};
+
+/**  \brief Json_Parser handler that builds Objects as values arrive. Each
+ *  nested Object is stored in its parent when it begins and filled in
+ *  place. Numbers become long long or double, strings std::string, and
+ *  null a property without a value.
+ */
+class Json_Builder {
+
+    struct Level {
+        Object * object;
+        /** next index of an array, -1 for an object */
+        long long index;
+    };
+
+    std::vector<Level> my_stack;
+    std::string my_key;
+    std::shared_ptr<Object> my_root;
+
+    /**
+     *  \brief Stores slot under the pending key, or the next index of the
+     *  array being built.
+     */
+    void add(const Object::Shared_Pointer_And_Type &slot) {
+        if (this->my_stack.empty()) {
+            printf("In json_read, the document is not an object or an array."
+                    "\n  See line number %d in file %s\n\n", __LINE__, __FILE__);
+            throw -1;
+        }
+        Level &top = this->my_stack.back();
+        if (top.index >= 0)
+            top.object->store(std::to_string(top.index++), slot);
+        else
+            top.object->store(this->my_key, slot);
+    }
+
+    template <class Type> void add_value(Type &&value) {
+        typedef typename std::decay<Type>::type Value;
+        this->add(Object::Shared_Pointer_And_Type(std::allocate_shared<Value>
+                (Object::Allocator<Value>(), std::forward<Type>(value)),
+                Object::descriptor<Value>()));
+    }
+
+    void begin(long long index) {
+        std::shared_ptr<Object> child = std::allocate_shared<Object>
+                (Object::Allocator<Object>());
+        // Most JSON objects are small; skip the first rehashes.
+        child->my_contents.reserve(8);
+        if (index >= 0)
+            child->setParent(json_array_prototype());
+        if (this->my_stack.empty())
+            this->my_root = child;
+        else
+            this->add(Object::Shared_Pointer_And_Type(child,
+                Object::descriptor<Object>()));
+        Level level = {child.get(), index};
+        this->my_stack.push_back(level);
+    }
+
+public:
+
+    Json_Builder() : my_stack(), my_key(), my_root() {
+    }
+
+    /**
+     *  \brief The Object built from the document.
+     */
+    std::shared_ptr<Object> result() const {
+        return this->my_root;
+    }
+
+    void begin_object() {
+        this->begin(-1);
+    }
+
+    void begin_array() {
+        this->begin(0);
+    }
+
+    void end_object() {
+        this->my_stack.pop_back();
+    }
+
+    void end_array() {
+        Object &array = *this->my_stack.back().object;
+        array.set("length", this->my_stack.back().index);
+        this->my_stack.pop_back();
+    }
+
+    void key(std::string &name) {
+        this->my_key.swap(name);
+    }
+
+    void null_value() {
+        this->add(Object::Shared_Pointer_And_Type());
+    }
+
+    void bool_value(bool value) {
+        this->add_value(value);
+    }
+
+    void integer_value(long long value) {
+        this->add_value(value);
+    }
+
+    void double_value(double value) {
+        this->add_value(value);
+    }
+
+    void string_value(std::string &value) {
+        this->add_value(std::move(value));
+    }
+};
+
+/**  \brief Writes Objects as JSON, appending to a string and, when given a
+ *  stream, passing the text on in blocks. Nesting is tracked on an
+ *  explicit stack, like Json_Parser, so deep trees do not exhaust the call
+ *  stack.
+ */
+class Json_Writer {
+
+    /**  \brief An Object being written.
+     */
+    struct Level {
+        const Object * object;
+        /** number of elements of an array, -1 for an object */
+        long long length;
+        /** the properties of an object */
+        std::vector<std::pair<const std::string *,
+                const Object::Shared_Pointer_And_Type *> > slots;
+        /** index of the next element or property */
+        std::size_t next;
+    };
+
+    std::string &my_out;
+    std::ostream * my_stream;
+    std::vector<Level> my_stack;
+    /** the Objects of my_stack, to find cycles */
+    std::unordered_set<const Object *> my_open;
+
+    static void fail(const char *problem, const std::string &name, int line) {
+        printf("In json_write, property \"%s\" %s.\n  "
+                "See line number %d in file %s\n\n", name.c_str(), problem,
+                line, __FILE__);
+        throw -1;
+    }
+
+    void flush_if_full() {
+        if (this->my_stream != nullptr && this->my_out.size() >= (1 << 16))
+            this->flush();
+    }
+
+    void write_string(const std::string &s) {
+        static const char hex[] = "0123456789abcdef";
+        this->my_out.push_back('"');
+        std::size_t start = 0;
+        for (std::size_t i = 0; i < s.size(); ++i) {
+            unsigned char c = (unsigned char) s[i];
+            if (c >= 0x20 && c != '"' && c != '\\')
+                continue;
+            this->my_out.append(s, start, i - start);
+            start = i + 1;
+            this->my_out.push_back('\\');
+            switch (c) {
+                case '"': this->my_out.push_back('"');
+                    break;
+                case '\\': this->my_out.push_back('\\');
+                    break;
+                case '\n': this->my_out.push_back('n');
+                    break;
+                case '\r': this->my_out.push_back('r');
+                    break;
+                case '\t': this->my_out.push_back('t');
+                    break;
+                default:
+                    this->my_out.append("u00");
+                    this->my_out.push_back(hex[c >> 4]);
+                    this->my_out.push_back(hex[c & 15]);
+            }
+        }
+        this->my_out.append(s, start, s.size() - start);
+        this->my_out.push_back('"');
+    }
+
+    template <class Type> bool write_integer(const Object::Shared_Pointer_And_Type &v) {
+        if (v.t != Object::descriptor<Type>())
+            return false;
+        char text[32];
+        int n = std::is_signed<Type>::value ?
+                snprintf(text, sizeof (text), "%lld",
+                (long long) *static_cast<const Type *> (v.p.get())) :
+                snprintf(text, sizeof (text), "%llu",
+                (unsigned long long) *static_cast<const Type *> (v.p.get()));
+        this->my_out.append(text, (std::size_t) n);
+        return true;
+    }
+
+    template <class Type> bool write_real(const Object::Shared_Pointer_And_Type &v) {
+        if (v.t != Object::descriptor<Type>())
+            return false;
+        double d = (double) *static_cast<const Type *> (v.p.get());
+        if (!std::isfinite(d)) {
+            this->my_out.append("null");
+            return true;
+        }
+        char text[32];
+        int n = snprintf(text, sizeof (text), "%.17g", d);
+        char point = json_decimal_point();
+        if (point != '.')
+            std::replace(text, text + n, point, '.');
+        this->my_out.append(text, (std::size_t) n);
+        return true;
+    }
+
+    /**
+     *  \brief Writes the value of slot, unless it is an Object.
+     *  @return the Object, to be written next, or nullptr
+     */
+    const Object * write_value(const std::string &name,
+            const Object::Shared_Pointer_And_Type * slot) {
+        if (slot == nullptr) {
+            this->my_out.append("null");
+            return nullptr;
+        }
+        const Object::Shared_Pointer_And_Type &v = *Object::built_slot(slot);
+        if (v.p == nullptr || v.t == nullptr)
+            this->my_out.append("null");
+        else if (v.t == Object::descriptor<Object>())
+            return static_cast<const Object *> (v.p.get());
+        else if (v.t == Object::descriptor<std::string>())
+            this->write_string(*static_cast<const std::string *> (v.p.get()));
+        else if (v.t == Object::descriptor<bool>())
+            this->my_out.append(*static_cast<const bool *> (v.p.get()) ?
+                "true" : "false");
+        else if (!this->write_integer<long long>(v) && !this->write_integer<int>(v)
+                && !this->write_real<double>(v) && !this->write_integer<long>(v)
+                && !this->write_integer<unsigned long long>(v)
+                && !this->write_integer<unsigned long>(v)
+                && !this->write_integer<unsigned int>(v)
+                && !this->write_integer<short>(v)
+                && !this->write_integer<unsigned short>(v)
+                && !this->write_integer<signed char>(v)
+                && !this->write_integer<unsigned char>(v)
+                && !this->write_integer<char>(v)
+                && !this->write_real<float>(v) && !this->write_real<long double>(v))
+            fail("holds a type that cannot be written as JSON", name, __LINE__);
+        return nullptr;
+    }
+
+    /**
+     *  \brief Writes the start of o and pushes it on the stack.
+     */
+    void open(const Object &o, const std::string &name) {
+        if (!this->my_open.insert(&o).second)
+            fail("is part of a cycle", name, __LINE__);
+        Level level;
+        level.object = &o;
+        level.length = -1;
+        level.next = 0;
+        if (o.getParent() == &json_array_prototype()) {
+            const Object::Shared_Pointer_And_Type * length = o.find_slot("length");
+            level.length = length != nullptr && length->t ==
+                    Object::descriptor<long long>() ?
+                    *static_cast<const long long *> (length->p.get()) : 0;
+            if (level.length < 0)
+                level.length = 0;
+        } else
+            o.for_each_slot(Object::Slot_Collector(level.slots));
+        this->my_out.push_back(level.length >= 0 ? '[' : '{');
+        this->my_stack.push_back(std::move(level));
+    }
+
+public:
+
+    /**
+     *  \brief Appends to out. With a stream, out is used as the buffer and
+     *  written to stream whenever it fills and on flush.
+     */
+    explicit Json_Writer(std::string &out, std::ostream * stream = nullptr)
+    : my_out(out), my_stream(stream), my_stack(), my_open() {
+    }
+
+    void flush() {
+        if (this->my_stream == nullptr)
+            return;
+        this->my_stream->write(this->my_out.data(),
+                (std::streamsize) this->my_out.size());
+        this->my_out.clear();
+    }
+
+    /**
+     *  \brief Writes the own properties of o, and the Objects it holds.
+     *  Objects whose parent is json_array_prototype() are written as
+     *  arrays. Throws -1 on a cycle or a value that is not a bool, a
+     *  number, a std::string or an Object.
+     */
+    void write(const Object &o) {
+        this->my_stack.clear();
+        this->my_open.clear();
+        this->open(o, "");
+        std::string index;
+        while (!this->my_stack.empty()) {
+            Level &top = this->my_stack.back();
+            bool array = top.length >= 0;
+            if (top.next == (array ? (std::size_t) top.length : top.slots.size())) {
+                this->my_out.push_back(array ? ']' : '}');
+                this->my_open.erase(top.object);
+                this->my_stack.pop_back();
+                continue;
+            }
+            if (top.next != 0)
+                this->my_out.push_back(',');
+            const std::string * name;
+            const Object::Shared_Pointer_And_Type * slot;
+            if (array) {
+                index = std::to_string((long long) top.next);
+                name = &index;
+                slot = top.object->find_slot(index);
+            } else {
+                name = top.slots[top.next].first;
+                slot = top.slots[top.next].second;
+                this->write_string(*name);
+                this->my_out.push_back(':');
+            }
+            ++top.next;
+            const Object * child = this->write_value(*name, slot);
+            if (child != nullptr)
+                this->open(*child, *name);
+            this->flush_if_full();
+        }
+    }
+};
+
+/**
+ * \brief Calls handler for every value of the JSON document in in, as it
+ * is read. See Json_Parser for the handler's functions.
+ */
+template <class Handler> void json_parse(std::istream &in, Handler &handler) {
+    Json_Parser<Handler> parser(in, handler);
+    parser.run();
+}
+
+/**
+ * \brief Builds an Object from the JSON object or array in in, reading it
+ * in blocks, so memory use is bounded by the result. Objects become
+ * Objects, arrays Objects with json_array_prototype() as parent, numbers
+ * long long or double, strings std::string, booleans bool and null a
+ * property without a value.
+ * Throws -1 on malformed JSON or a document that is a single scalar.
+ */
+inline std::shared_ptr<Object> json_read(std::istream &in) {
+    Json_Builder builder;
+    json_parse(in, builder);
+    if (builder.result() == nullptr) {
+        printf("In json_read, the document is not an object or an array.\n  "
+                "See line number %d in file %s\n\n", __LINE__, __FILE__);
+        throw -1;
+    }
+    return builder.result();
+}
+
+/**
+ * \brief Appends o to out as JSON. See Json_Writer::write.
+ */
+inline void json_write(const Object &o, std::string &out) {
+    Json_Writer writer(out);
+    writer.write(o);
+}
+
+/**
+ * \brief Writes o to out as JSON through a 64 KB buffer.
+ */
+inline void json_write(const Object &o, std::ostream &out) {
+    std::string buffer;
+    buffer.reserve(1 << 17);
+    Json_Writer writer(buffer, &out);
+    writer.write(o);
+    writer.flush();
+}
+#endif    // PROTOTYPAL_C_OBJECT_JSON_H_
@@ -0,0 +1,233 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+/*
+ * File:   Parallel_Exec.h
+ * Created on October 18, 2026
+ */
+
+#ifndef PROTOTYPAL_C_PARALLEL_EXEC_H_
+#define PROTOTYPAL_C_PARALLEL_EXEC_H_
+
+#include "Prototypal_Cpp.h"
+#include "Thread_Pool.h"
+#include <stdio.h>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+/**  \brief Finds the callable Object for one function name over many
+ *  Objects. Objects without an own property of that name are resolved
+ *  through their parent, and the answer is kept per parent, so the parent
+ *  tree of each distinct prototype is searched once.
+ *  Not thread safe. parallel_exec uses one Exec_Resolver per chunk.
+ */
+class Exec_Resolver {
+public:
+
+    /**  \brief What o.exec(name, ...) amounts to for one Object o.
+     */
+    struct Target {
+        /** the Object whose call function is performed */
+        Object * callable;
+        /** the Object whose memo the call goes through, see
+         * Object::findMemoized; if set, exec is called on it instead */
+        Object * memoized;
+    };
+
+private:
+
+    const std::string &my_name;
+    std::unordered_map<Object *, Target> my_cache;
+    Object * my_last_parent;
+    Target my_last;
+
+public:
+
+    explicit Exec_Resolver(const std::string &function_name)
+    : my_name(function_name), my_cache(), my_last_parent(nullptr),
+    my_last() {
+    }
+
+    /**
+     * \brief Returns what o.exec(name, ...) would call.
+     * Throws -1 like Object.exec when there is nothing to call.
+     */
+    Target resolve(Object &o) {
+        Target target = {nullptr, nullptr};
+        if (o.isMemoized(this->my_name)) {
+            target.memoized = &o;
+            return target;
+        }
+        target.callable = o.findCallable(this->my_name, false);
+        if (target.callable != nullptr)
+            return target;
+        Object * parent = o.getParent();
+        if (parent != nullptr && parent == this->my_last_parent)
+            return this->my_last;
+        if (parent != nullptr) {
+            auto pair = this->my_cache.find(parent);
+            if (pair != this->my_cache.end())
+                target = pair->second;
+            else {
+                target.memoized = parent->findMemoized(this->my_name);
+                if (target.memoized == nullptr)
+                    target.callable = parent->findCallable(this->my_name);
+                this->my_cache[parent] = target;
+            }
+        }
+        if (target.callable == nullptr && target.memoized == nullptr) {
+            printf("Function pointer named \"%s\" referenced by "
+                    "parallel_exec cannot be found.\n  "
+                    "See line number %d in file %s\n\n",
+                    this->my_name.c_str(), __LINE__, __FILE__);
+            throw -1;
+        }
+        this->my_last_parent = parent;
+        this->my_last = target;
+        return target;
+    }
+
+    /**
+     * \brief Performs o.exec(name, Parameters...), through the memo it
+     * would use, if any.
+     */
+    template <class Return_Type, class ...A> Return_Type exec(Object &o,
+            A... Parameters) {
+        Target target = this->resolve(o);
+        if (target.memoized != nullptr)
+            return target.memoized->exec<Return_Type>(this->my_name,
+                    Parameters...);
+        return target.callable->call<Return_Type>(Parameters...);
+    }
+};
+
+/**  \brief Runs the calls of parallel_exec and stores their results.
+ */
+template <class Return_Type> struct Parallel_Exec {
+
+    static_assert(!std::is_same<Return_Type, bool>::value,
+            "std::vector<bool> cannot be written from several threads, "
+            "return char or int instead");
+
+    typedef std::vector<Return_Type> Results;
+
+    template <class ...A> static Results run(Thread_Pool &pool,
+            const std::vector<Object *> &objects, std::size_t chunk,
+            const std::string &function_name, A... Parameters) {
+        Results results(objects.size());
+        pool.parallel_for(objects.size(), chunk,
+                [&](std::size_t begin, std::size_t end) {
+                    Exec_Resolver resolver(function_name);
+                    for (std::size_t i = begin; i < end; ++i)
+                        results[i] = resolver.exec<Return_Type>(*objects[i],
+                        Parameters...);
+                });
+        return results;
+    }
+};
+
+template <> struct Parallel_Exec<void> {
+
+    typedef void Results;
+
+    template <class ...A> static void run(Thread_Pool &pool,
+            const std::vector<Object *> &objects, std::size_t chunk,
+            const std::string &function_name, A... Parameters) {
+        pool.parallel_for(objects.size(), chunk,
+                [&](std::size_t begin, std::size_t end) {
+                    Exec_Resolver resolver(function_name);
+                    for (std::size_t i = begin; i < end; ++i)
+                        resolver.exec<void>(*objects[i], Parameters...);
+                });
+    }
+};
+
+/**
+ * \brief Converts an element of a range passed to parallel_exec to an
+ * Object pointer. Ranges may hold Objects, Object pointers or shared
+ * pointers to Objects, and subclasses of Object.
+ */
+inline Object * parallel_exec_object(Object &o) {
+    return &o;
+}
+
+inline Object * parallel_exec_object(Object *o) {
+    return o;
+}
+
+template <class Type> Object * parallel_exec_object
+(const std::shared_ptr<Type> &o) {
+    return o.get();
+}
+
+/**
+ * \brief Calls exec(function_name, Parameters...) on every Object of
+ * objects, spread over pool in chunks. The callable of each distinct
+ * prototype is found once per chunk. Functions called this way must be
+ * safe to run on several threads at once, and objects must not be
+ * modified during the call.
+ * A call that exec would make through a memo, on the Object itself or
+ * on a prototype, goes through that memo, see Object::findMemoized.
+ * Throws after every call finished if any of them threw.
+ * @param Return_Type - specified in <>, void if omitted. Must be default
+ * constructible.
+ * @param chunk - Objects per task, 0 picks about 4 tasks per worker
+ * @return Return_Type results in the order of objects, nothing for void
+ */
+template <class Return_Type = void, class Range, class ...A>
+typename Parallel_Exec<Return_Type>::Results parallel_exec(Thread_Pool &pool,
+        Range &objects, const std::string &function_name, A... Parameters) {
+    std::vector<Object *> targets;
+    for (auto it = objects.begin(); it != objects.end(); ++it)
+        targets.push_back(parallel_exec_object(*it));
+    return Parallel_Exec<Return_Type>::run(pool, targets, 0, function_name,
+            Parameters...);
+}
+
+/**
+ * \brief parallel_exec on Thread_Pool::shared()
+ */
+template <class Return_Type = void, class Range, class ...A>
+typename Parallel_Exec<Return_Type>::Results parallel_exec(Range &objects,
+        const std::string &function_name, A... Parameters) {
+    return parallel_exec<Return_Type>(Thread_Pool::shared(), objects,
+            function_name, Parameters...);
+}
+
+/**
+ * \brief Calls exec(function_name, Parameters...) on every Object that is a
+ * property of parent, like parallel_exec.
+ * @return Return_Type results in the order of parent.getOwnObjects(),
+ * nothing for void
+ */
+template <class Return_Type = void, class ...A>
+typename Parallel_Exec<Return_Type>::Results for_each_member_exec
+(Thread_Pool &pool, const Object &parent, const std::string &function_name,
+        A... Parameters) {
+    return Parallel_Exec<Return_Type>::run(pool, parent.getOwnObjects(), 0,
+            function_name, Parameters...);
+}
+
+/**
+ * \brief for_each_member_exec on Thread_Pool::shared()
+ */
+template <class Return_Type = void, class ...A>
+typename Parallel_Exec<Return_Type>::Results for_each_member_exec
+(const Object &parent, const std::string &function_name, A... Parameters) {
+    return for_each_member_exec<Return_Type>(Thread_Pool::shared(), parent,
+            function_name, Parameters...);
+}
+#endif    // PROTOTYPAL_C_PARALLEL_EXEC_H_
@@ -27,94 +27,2533 @@ limitations under the License.
 #include <memory>
 #include <string>
 #include <climits>
+#include <stdint.h>
+#include <cstddef>
+#include <atomic>
+#include <new>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+#include <initializer_list>
+#include <algorithm>
+#include <mutex>
+#include <tuple>
+#include <list>
+#include <utility>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <random>
+#include <chrono>
 /** 
  *   \brief type pcast produces a function that takes in an arbitrary # of
  *   args and returns a void pointer. 
  */
 typedef void * (*pcast) (...);
-/** 
- * \brief Magic number used for type identification 
+/**
+ * \brief Define PROTOTYPAL_CPP_STATISTICS before including this header to
+ * keep process-wide counts of live Objects, live properties and bytes
+ * allocated by the library. See Object::statistics().
+ */
+#ifdef PROTOTYPAL_CPP_STATISTICS
+#define ____OBJECT_COUNT(counter, amount) \
+    (Object::counters().counter.fetch_add((amount), std::memory_order_relaxed))
+#else
+#define ____OBJECT_COUNT(counter, amount) ((void) sizeof (amount))
+#endif
+/**
+ * \brief Keeps a function out of line, so that it does not add its locals
+ * to the frame of its caller.
+ */
+#if defined(__GNUC__)
+#define ____OBJECT_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define ____OBJECT_NOINLINE __declspec(noinline)
+#else
+#define ____OBJECT_NOINLINE
+#endif
+
+/**  \brief Dynamic object which is capable of adding static function pointers, 
+ *  std::function lambads, and values to itself
  */
-#define ____OBJECT_TYPE 9223372036854775807LL
+class Object {
+public:
+
+    /**  \brief Bytes used by an Object, by category. Returned by
+     *  Object::memory_usage. Sizes of library nodes and shared_ptr control
+     *  blocks are estimates for a typical standard library.
+     */
+    struct Memory_Usage {
+        /** sizeof(Object): vtable pointer, hash table header, function,
+         * parent and extension pointers, plus the extension block holding
+         * the frozen table, method table, memo and version table pointers
+         * of an Object that has one */
+        std::size_t header;
+        /** my_contents bucket array */
+        std::size_t buckets;
+        /** property names, including their heap buffers */
+        std::size_t keys;
+        /** hash nodes holding the Shared_Pointer_And_Type of each property,
+         * and the method table */
+        std::size_t slots;
+        /** shared_ptr control blocks */
+        std::size_t control_blocks;
+        /** stored values, plus the heap buffers of std::string values */
+        std::size_t values;
+        /** Objects stored as property values, counted once each */
+        std::size_t nested_objects;
+
+        std::size_t total() const {
+            return header + buckets + keys + slots + control_blocks + values
+                    + nested_objects;
+        }
+    };
+
+    /**  \brief Process-wide counters kept when PROTOTYPAL_CPP_STATISTICS is
+     *  defined. Returned by Object::statistics.
+     */
+    struct Statistics {
+        long long live_objects;
+        long long live_properties;
+        /** bytes currently allocated through Object::Allocator */
+        long long bytes_allocated;
+        /** number of allocations made through Object::Allocator */
+        long long allocations;
+    };
+
+    /**  \brief Cache counts of one memoized function, returned by
+     *  Object::memo_statistics.
+     */
+    struct Memo_Statistics {
+        long long hits;
+        long long misses;
+        /** results dropped to stay within the capacity */
+        long long evictions;
+        /** results currently cached */
+        std::size_t size;
+    };
+
+    /**  \brief Sharing of the values set with Object::set_interned,
+     *  returned by Object::intern_statistics.
+     */
+    struct Intern_Statistics {
+        /** calls to set_interned */
+        long long calls;
+        /** calls that shared an equal value instead of copying theirs */
+        long long hits;
+        /** sizeof plus heap bytes of the values those calls did not copy */
+        long long bytes_saved;
+        /** distinct values currently interned */
+        std::size_t size;
+
+        /** values set per copy allocated, 1 when nothing was shared */
+        double dedup_ratio() const {
+            return this->calls == this->hits ? 1.0
+                    : (double) this->calls / (double) (this->calls - this->hits);
+        }
+    };
+
+    /**  \brief Raw counters behind Object::statistics.
+     */
+    struct Counters {
+        std::atomic<long long> live_objects;
+        std::atomic<long long> live_properties;
+        std::atomic<long long> bytes_allocated;
+        std::atomic<long long> allocations;
+    };
+
+    /**  \brief Process-wide counters. Only updated when
+     *  PROTOTYPAL_CPP_STATISTICS is defined.
+     */
+    static Counters & counters() {
+        static Counters c = {
+            {0}, {0}, {0}, {0}
+        };
+        return c;
+    }
+
+    /**  \brief Snapshot of the process-wide counters. All zero unless
+     *  PROTOTYPAL_CPP_STATISTICS is defined.
+     */
+    static Statistics statistics() {
+        Counters &c = counters();
+        Statistics s = {
+            c.live_objects.load(std::memory_order_relaxed),
+            c.live_properties.load(std::memory_order_relaxed),
+            c.bytes_allocated.load(std::memory_order_relaxed),
+            c.allocations.load(std::memory_order_relaxed)
+        };
+        return s;
+    }
+
+    /**  \brief Allocator for property values and hash nodes. Counts bytes in
+     *  Object::counters() when PROTOTYPAL_CPP_STATISTICS is defined.
+     */
+    template <class Type> struct Allocator {
+        typedef Type value_type;
+
+        Allocator() {
+        }
+
+        template <class Other> Allocator(const Allocator<Other> &) {
+        }
+
+        Type * allocate(std::size_t n) {
+            ____OBJECT_COUNT(bytes_allocated, (long long) (n * sizeof (Type)));
+            ____OBJECT_COUNT(allocations, 1);
+            return static_cast<Type *> (::operator new(n * sizeof (Type)));
+        }
+
+        void deallocate(Type *pointer, std::size_t n) {
+            ____OBJECT_COUNT(bytes_allocated, -(long long) (n * sizeof (Type)));
+            ____OBJECT_COUNT(allocations, -1);
+            ::operator delete(pointer);
+        }
+
+        template <class Other> bool operator ==(const Allocator<Other> &) const {
+            return true;
+        }
+
+        template <class Other> bool operator !=(const Allocator<Other> &) const {
+            return false;
+        }
+    };
+
+    /**  \brief Per-type information shared by every property of that type.
+     *  Each Shared_Pointer_And_Type points at the descriptor of its value's
+     *  type, so a type check is a pointer comparison.
+     */
+    struct Type_Descriptor {
+        std::type_index index;
+        std::size_t size;
+        std::size_t align;
+        /** true for Object and classes derived from Object. Object.exec uses
+         * this to identify callable properties. */
+        bool is_object;
+        /** true for properties set with Object::set_lazy that may not be
+         * built yet. Their value is reached through the Lazy_Cell. */
+        bool is_lazy;
+        /** heap bytes owned by a value, beyond sizeof */
+        std::size_t(*owned_bytes)(const void *);
+        /** name given by Object::register_type, empty if not registered */
+        std::string name;
+        /** Object::type_id of name, stable across processes and builds.
+         * 0 if not registered. */
+        uint64_t id;
+        /** The operations below are nullptr when Type does not support
+         * them. copy and move construct into uninitialized storage. */
+        void (*copy)(void *to, const void *from);
+        void (*move)(void *to, void *from);
+        void (*destroy)(void *value);
+        /** a new shared copy of value, allocated with Object::Allocator */
+        std::shared_ptr<void> (*clone)(const void *value);
+        bool (*equal)(const void *a, const void *b);
+        std::size_t (*hash)(const void *value);
+        /** appends value to out. Arithmetic types and other trivially
+         * copyable types are written as their bytes, std::string as a
+         * 64-bit length and its characters. */
+        void (*serialize)(const void *value, std::string &out);
+        /** reads a value written by serialize from [in, end) and advances
+         * in. Returns nullptr if the input is too short or malformed. */
+        std::shared_ptr<void> (*deserialize)(const char *&in, const char *end);
+        /** deserialize into uninitialized storage of size and align bytes.
+         * Returns false, with nothing constructed, on malformed input. */
+        bool (*deserialize_into)(void *to, const char *&in, const char *end);
+    };
+
+    /**  \brief Function called with every value stored in an Object,
+     *  when installed with Object::slot_hook. Used by Cycle_Collector.
+     */
+    typedef void (*Slot_Hook)(const std::shared_ptr<void> &value,
+            const Type_Descriptor * type);
+
+    /**  \brief The installed Slot_Hook, nullptr by default. Atomic, so
+     *  that a collector can be enabled or disabled while other threads
+     *  store values.
+     */
+    static std::atomic<Slot_Hook>& slot_hook() {
+        static std::atomic<Slot_Hook> hook(nullptr);
+        return hook;
+    }
+
+    /**  \brief Calls the installed Slot_Hook, if any, loading it once.
+     */
+    static void call_slot_hook(const std::shared_ptr<void> &value,
+            const Type_Descriptor * type) {
+        Slot_Hook hook = Object::slot_hook().load(std::memory_order_acquire);
+        if (hook != nullptr)
+            hook(value, type);
+    }
+
+    /**  \brief Kinds of change reported to a Change_Hook.
+     */
+    enum Change {
+        /** the property name is stored, value and type are the new value */
+        change_set,
+        /** the existing property name is removed */
+        change_remove,
+        change_clear,
+        /** value is the new parent Object, nullptr if the parent is cleared */
+        change_parent,
+        /** the properties are replaced by those of the Object value, by
+         * pass_contents or operator = */
+        change_contents,
+        change_freeze,
+        change_destroy
+    };
+
+    /**  \brief Function called before every change to an Object, when
+     *  installed with Object::change_hook or Object::add_change_hook. name
+     *  is nullptr unless the change is change_set or change_remove. Used by
+     *  Journal and Object_Collection.
+     */
+    typedef void (*Change_Hook)(Object &object, Change change,
+            const std::string * name, const void * value,
+            const Type_Descriptor * type);
+
+    /**  \brief The installed Change_Hook, nullptr by default. Loaded on
+     *  every change, so hooks can be added and removed while other threads
+     *  change Objects.
+     */
+    static std::atomic<Change_Hook> & change_hook() {
+        static std::atomic<Change_Hook> hook(nullptr);
+        return hook;
+    }
+
+    /**  \brief Most hooks added with Object::add_change_hook at once.
+     */
+    static const std::size_t max_change_hooks = 8;
+
+    /**  \brief The hooks added with Object::add_change_hook; removed ones
+     *  are nullptr. Zero-initialized as a static array.
+     */
+    static std::atomic<Change_Hook> * change_hooks() {
+        static std::atomic<Change_Hook> hooks[max_change_hooks];
+        return hooks;
+    }
+
+    /**  \brief Serializes Object::add_change_hook and remove_change_hook.
+     *  Changes to Objects never take it.
+     */
+    static std::mutex & change_hooks_mutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    /**  \brief Installed as the Change_Hook while several hooks are added.
+     *  Calls them in the order of their slots.
+     */
+    static void call_change_hooks(Object &object, Change change,
+            const std::string * name, const void * value,
+            const Type_Descriptor * type) {
+        std::atomic<Change_Hook> *hooks = Object::change_hooks();
+        for (std::size_t i = 0; i < max_change_hooks; ++i) {
+            Change_Hook hook = hooks[i].load(std::memory_order_acquire);
+            if (hook != nullptr)
+                hook(object, change, name, value, type);
+        }
+    }
+
+    /**  \brief Installs the single added hook, call_change_hooks for
+     *  several, nullptr for none. Called under change_hooks_mutex.
+     */
+    static void install_change_hooks() {
+        std::atomic<Change_Hook> *hooks = Object::change_hooks();
+        Change_Hook installed = nullptr;
+        for (std::size_t i = 0; i < max_change_hooks; ++i) {
+            Change_Hook hook = hooks[i].load(std::memory_order_relaxed);
+            if (hook != nullptr)
+                installed = installed == nullptr ? hook
+                        : &Object::call_change_hooks;
+        }
+        Object::change_hook().store(installed, std::memory_order_release);
+    }
+
+    /**  \brief Adds hook to the Change_Hooks called on every change, so
+     *  that Journal and Object_Collection can be used together. Safe while
+     *  other threads change Objects; their changes see the hook from some
+     *  point on. Throws -1 past max_change_hooks hooks.
+     */
+    static void add_change_hook(Change_Hook hook) {
+        std::lock_guard<std::mutex> lock(Object::change_hooks_mutex());
+        std::atomic<Change_Hook> *hooks = Object::change_hooks();
+        std::size_t i = 0;
+        while (i < max_change_hooks
+                && hooks[i].load(std::memory_order_relaxed) != nullptr)
+            ++i;
+        if (i == max_change_hooks) {
+            printf("In Object.add_change_hook, more than %d hooks.\n  "
+                    "See line number %d in file %s\n\n",
+                    (int) max_change_hooks, __LINE__, __FILE__);
+            throw -1;
+        }
+        hooks[i].store(hook, std::memory_order_release);
+        Object::install_change_hooks();
+    }
+
+    /**  \brief Removes a hook added with Object::add_change_hook. A change
+     *  that started before this returns may still call hook, so whatever
+     *  hook reads must outlive such changes.
+     */
+    static void remove_change_hook(Change_Hook hook) {
+        std::lock_guard<std::mutex> lock(Object::change_hooks_mutex());
+        std::atomic<Change_Hook> *hooks = Object::change_hooks();
+        for (std::size_t i = 0; i < max_change_hooks; ++i)
+            if (hooks[i].load(std::memory_order_relaxed) == hook) {
+                hooks[i].store(nullptr, std::memory_order_release);
+                break;
+            }
+        Object::install_change_hooks();
+    }
+
+    /**  \brief Calls the installed Change_Hook, if any, on this Object.
+     *  Loads it once, so a concurrent remove_change_hook cannot leave a
+     *  nullptr to call.
+     */
+    void call_change_hook(Change change, const std::string * name,
+            const void * value, const Type_Descriptor * type) {
+        Change_Hook hook = Object::change_hook().load(std::memory_order_acquire);
+        if (hook != nullptr)
+            hook(*this, change, name, value, type);
+    }
+
+    /**  \brief Lock-free first test of whether a Change_Hook watches an
+     *  Object: a table of counters indexed by a hash of the Object's
+     *  address. A zero counter proves that the Object is not watched, so
+     *  the hook can return before taking its lock. The owner adds and
+     *  removes Objects under its own lock, and rebuilds the table when
+     *  crowded() says it is more than one sixteenth full, so that about
+     *  one change in sixteen to other Objects reaches the hook's own
+     *  lookup, however many Objects are watched. Replaced tables are kept
+     *  until the filter is destroyed, since readers may still use them;
+     *  each is at most half the size of the next.
+     */
+    class Watch_Filter {
+
+        struct Table {
+            unsigned shift;
+            std::size_t size;
+            std::unique_ptr<std::atomic<unsigned char>[]> counts;
+
+            explicit Table(unsigned log_size) : shift(64 - log_size),
+            size((std::size_t) 1 << log_size),
+            counts(new std::atomic<unsigned char>[(std::size_t) 1 << log_size]()) {
+            }
+
+            std::atomic<unsigned char> & count(const Object * o) const {
+                uint64_t a = (uint64_t) reinterpret_cast<uintptr_t> (o);
+                return this->counts[(std::size_t) ((a * 0x9E3779B97F4A7C15ULL)
+                        >> this->shift)];
+            }
+
+            /**  \brief Counters stop at 255 and are not decremented from
+             *  there, so a crowded counter stays set rather than wrap.
+             */
+            void add(const Object * o) {
+                std::atomic<unsigned char> &c = this->count(o);
+                unsigned char n = c.load(std::memory_order_relaxed);
+                if (n != 255)
+                    c.store((unsigned char) (n + 1), std::memory_order_relaxed);
+            }
+
+            void remove(const Object * o) {
+                std::atomic<unsigned char> &c = this->count(o);
+                unsigned char n = c.load(std::memory_order_relaxed);
+                if (n != 0 && n != 255)
+                    c.store((unsigned char) (n - 1), std::memory_order_relaxed);
+            }
+        };
+
+        std::atomic<Table *> my_table;
+        std::vector<std::unique_ptr<Table> > my_tables;
+        std::size_t my_count;
+
+    public:
+
+        Watch_Filter() : my_table(), my_tables(), my_count(0) {
+            this->my_tables.emplace_back(new Table(12));
+            this->my_table.store(this->my_tables.back().get(),
+                    std::memory_order_release);
+        }
+
+        Watch_Filter(const Watch_Filter &) = delete;
+        Watch_Filter& operator =(const Watch_Filter &) = delete;
+
+        /**
+         *  \brief Adds o, which must not be in the filter. Called under
+         *  the owner's lock.
+         */
+        void add(const Object * o) {
+            this->my_tables.back()->add(o);
+            this->my_count += 1;
+        }
+
+        /**
+         *  \brief Removes o, which must be in the filter. Called under
+         *  the owner's lock.
+         */
+        void remove(const Object * o) {
+            this->my_tables.back()->remove(o);
+            this->my_count -= 1;
+        }
+
+        /**
+         *  \brief True if the owner should call rebuild.
+         */
+        bool crowded() const {
+            return this->my_count > this->my_tables.back()->size / 16;
+        }
+
+        /**
+         *  \brief Replaces the table by one at most a thirty-second full
+         *  that holds objects, which must be every Object in the filter.
+         *  nullptr entries are skipped.
+         */
+        void rebuild(const std::vector<const Object *> &objects) {
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < objects.size(); ++i)
+                if (objects[i] != nullptr)
+                    ++count;
+            unsigned log_size = 12;
+            while (((std::size_t) 1 << log_size) / 32 < count)
+                ++log_size;
+            std::unique_ptr<Table> table(new Table(log_size));
+            for (std::size_t i = 0; i < objects.size(); ++i)
+                if (objects[i] != nullptr)
+                    table->add(objects[i]);
+            this->my_table.store(table.get(), std::memory_order_release);
+            this->my_tables.push_back(std::move(table));
+            this->my_count = count;
+        }
+
+        /**
+         *  \brief False if o is not in the filter.
+         */
+        bool may_contain(const Object * o) const {
+            return this->my_table.load(std::memory_order_acquire)->count(o)
+                    .load(std::memory_order_relaxed) != 0;
+        }
+    };
+
+    /**  \brief The descriptor of Type.
+     */
+    template <class Type> static const Type_Descriptor * descriptor() {
+        return Object::mutable_descriptor<Type>();
+    }
+
+    /**
+     *  \brief Stable 64-bit id of a type name: its FNV-1a hash.
+     */
+    static uint64_t type_id(const std::string &name) {
+        uint64_t h = 14695981039346656037ull;
+        for (std::size_t i = 0; i < name.size(); ++i) {
+            h ^= (unsigned char) name[i];
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    /**
+     *  \brief Gives Type the name name and the id type_id(name), so that its
+     *  values can be identified outside of this process, for example by
+     *  snapshots. Call it at startup, before other threads use Type.
+     *  Arithmetic types, std::string and Object are registered under their
+     *  C++ names ("int", "unsigned long", "std::string", "Object", ...).
+     *  Throws -1 if name or Type is already registered to something else.
+     *  @return Type's descriptor
+     */
+    template <class Type> static const Type_Descriptor * register_type
+    (const std::string &name) {
+        Type_Registry &registry = Object::type_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        Object::add_type<Type>(registry, name);
+        return Object::descriptor<Type>();
+    }
+
+    /**
+     *  \brief register_type with functions to serialize values of a type
+     *  that is not trivially copyable. read gets a default constructed
+     *  value, advances in past what write wrote and returns false if the
+     *  input is malformed.
+     */
+    template <class Type> static const Type_Descriptor * register_type
+    (const std::string &name, void (*write)(const Type &value, std::string &out),
+            bool (*read)(Type &value, const char *&in, const char *end)) {
+        Type_Registry &registry = Object::type_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        Object::add_type<Type>(registry, name);
+        Custom_Serializer<Type>::write() = write;
+        Custom_Serializer<Type>::read() = read;
+        Type_Descriptor * d = Object::mutable_descriptor<Type>();
+        d->serialize = &Custom_Serializer<Type>::serialize;
+        d->deserialize = &Custom_Serializer<Type>::deserialize;
+        d->deserialize_into = &Custom_Serializer<Type>::deserialize_into;
+        return d;
+    }
+
+    /**
+     *  \brief Gives Type a hash function, for Object::set_interned, when
+     *  std::hash has no specialization for it. Call it at startup, before
+     *  other threads use Type.
+     */
+    template <class Type> static void register_hash
+    (std::size_t (*hash)(const Type &value)) {
+        Custom_Hash<Type>::function() = hash;
+        Object::mutable_descriptor<Type>()->hash = &Custom_Hash<Type>::hash;
+    }
+
+    /**
+     *  \brief The descriptor registered with id, nullptr if there is none.
+     */
+    static const Type_Descriptor * find_type(uint64_t id) {
+        Type_Registry &registry = Object::type_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        auto found = registry.types.find(id);
+        return found == registry.types.end() ? nullptr : found->second;
+    }
+
+    /**
+     *  \brief The descriptor registered as name, nullptr if there is none.
+     */
+    static const Type_Descriptor * find_type(const std::string &name) {
+        const Type_Descriptor * d = Object::find_type(Object::type_id(name));
+        return d != nullptr && d->name == name ? d : nullptr;
+    }
+
+private:
+    friend class Cycle_Collector;
+    friend class Mapped_Object;
+    friend class Shared_Memory_Object;
+    friend class Json_Builder;
+    friend class Json_Writer;
+    friend class Journal;
+    friend class Object_Graph;
+    friend class Object_Collection;
+
+    /**  \brief value is true if Type has an operator ==.
+     */
+    template <class Type> struct Has_Equal {
+
+        template <class T> static auto test(int) -> decltype(
+                std::declval<const T &>() == std::declval<const T &>(),
+                std::true_type());
+
+        template <class T> static std::false_type test(...);
+
+        static const bool value = decltype(test<Type>(0))::value;
+    };
+
+    /**  \brief value is true if std::hash<Type> is defined.
+     */
+    template <class Type> struct Has_Hash {
+
+        template <class T> static auto test(int) -> decltype(
+                std::hash<T>()(std::declval<const T &>()), std::true_type());
+
+        template <class T> static std::false_type test(...);
+
+        static const bool value = decltype(test<Type>(0))::value;
+    };
+
+    /**  \brief value is true if values of Type are serialized as their bytes:
+     *  trivially copyable types other than pointers and Objects.
+     */
+    template <class Type> struct Byte_Serial {
+        static const bool value = std::is_trivially_copyable<Type>::value &&
+                !std::is_pointer<Type>::value &&
+                !std::is_member_pointer<Type>::value &&
+                !std::is_base_of<Object, Type>::value;
+    };
+
+    /**  \brief Default serialization of Type_Descriptor. value is false and
+     *  the functions are not used for types that have none.
+     */
+    template <class Type, bool Enabled = Byte_Serial<Type>::value ||
+    std::is_same<Type, std::string>::value, class Unused = void> struct Serial {
+        static const bool value = true;
+
+        static void serialize(const void *value, std::string &out) {
+            out.append(static_cast<const char *> (value), sizeof (Type));
+        }
+
+        static std::shared_ptr<void> deserialize(const char *&in,
+                const char *end) {
+            if (end - in < (std::ptrdiff_t) sizeof (Type))
+                return nullptr;
+            typename std::aligned_storage<sizeof (Type),
+                    std::alignment_of<Type>::value>::type buffer;
+            std::copy(in, in + sizeof (Type), reinterpret_cast<char *> (&buffer));
+            in += sizeof (Type);
+            return std::allocate_shared<Type>(Object::Allocator<Type>(),
+                    *reinterpret_cast<const Type *> (&buffer));
+        }
+
+        static bool deserialize_into(void *to, const char *&in,
+                const char *end) {
+            if (end - in < (std::ptrdiff_t) sizeof (Type))
+                return false;
+            std::copy(in, in + sizeof (Type), static_cast<char *> (to));
+            in += sizeof (Type);
+            return true;
+        }
+    };
+
+    template <class Unused> struct Serial<std::string, true, Unused> {
+        static const bool value = true;
+
+        static void serialize(const void *value, std::string &out) {
+            const std::string &s = *static_cast<const std::string *> (value);
+            uint64_t n = s.size();
+            out.append(reinterpret_cast<const char *> (&n), sizeof (n));
+            out.append(s);
+        }
+
+        static std::shared_ptr<void> deserialize(const char *&in,
+                const char *end) {
+            uint64_t n;
+            if (end - in < (std::ptrdiff_t) sizeof (n))
+                return nullptr;
+            std::copy(in, in + sizeof (n), reinterpret_cast<char *> (&n));
+            if ((uint64_t) (end - in) - sizeof (n) < n)
+                return nullptr;
+            in += sizeof (n);
+            std::shared_ptr<void> value = std::allocate_shared<std::string>
+                    (Object::Allocator<std::string>(), in, (std::size_t) n);
+            in += n;
+            return value;
+        }
+
+        static bool deserialize_into(void *to, const char *&in,
+                const char *end) {
+            uint64_t n;
+            if (end - in < (std::ptrdiff_t) sizeof (n))
+                return false;
+            std::copy(in, in + sizeof (n), reinterpret_cast<char *> (&n));
+            if ((uint64_t) (end - in) - sizeof (n) < n)
+                return false;
+            in += sizeof (n);
+            new (to) std::string(in, (std::size_t) n);
+            in += n;
+            return true;
+        }
+    };
+
+    template <class Type, class Unused> struct Serial<Type, false, Unused> {
+        static const bool value = false;
+
+        static void serialize(const void *, std::string &) {
+        }
+
+        static std::shared_ptr<void> deserialize(const char *&, const char *) {
+            return nullptr;
+        }
+
+        static bool deserialize_into(void *, const char *&, const char *) {
+            return false;
+        }
+    };
+
+    /**  \brief Serialization functions given to Object::register_type.
+     */
+    template <class Type> struct Custom_Serializer {
+
+        static void (*& write())(const Type &, std::string &) {
+            static void (*f)(const Type &, std::string &) = nullptr;
+            return f;
+        }
+
+        static bool (*& read())(Type &, const char *&, const char *) {
+            static bool (*f)(Type &, const char *&, const char *) = nullptr;
+            return f;
+        }
+
+        static void serialize(const void *value, std::string &out) {
+            write()(*static_cast<const Type *> (value), out);
+        }
+
+        static std::shared_ptr<void> deserialize(const char *&in,
+                const char *end) {
+            std::shared_ptr<Type> value = std::allocate_shared<Type>
+                    (Object::Allocator<Type>());
+            if (!read()(*value, in, end))
+                return nullptr;
+            return value;
+        }
+
+        static bool deserialize_into(void *to, const char *&in,
+                const char *end) {
+            Type * value = new (to) Type();
+            if (read()(*value, in, end))
+                return true;
+            value->~Type();
+            return false;
+        }
+    };
+
+    /**  \brief Hash function given to Object::register_hash.
+     */
+    template <class Type> struct Custom_Hash {
+
+        static std::size_t (*& function())(const Type &) {
+            static std::size_t (*f)(const Type &) = nullptr;
+            return f;
+        }
+
+        static std::size_t hash(const void *value) {
+            return function()(*static_cast<const Type *> (value));
+        }
+    };
+
+    /**  \brief copy and clone of Type_Descriptor. Like Serial, the
+     *  specializations for types without the operation are not used.
+     */
+    template <class Type, bool Enabled = std::is_copy_constructible<Type>::value>
+    struct Copy_Operations {
+        static const bool value = true;
+
+        static void copy(void *to, const void *from) {
+            new (to) Type(*static_cast<const Type *> (from));
+        }
+
+        static std::shared_ptr<void> clone(const void *value) {
+            return std::allocate_shared<Type>(Object::Allocator<Type>(),
+                    *static_cast<const Type *> (value));
+        }
+    };
+
+    template <class Type> struct Copy_Operations<Type, false> {
+        static const bool value = false;
+
+        static void copy(void *, const void *) {
+        }
+
+        static std::shared_ptr<void> clone(const void *) {
+            return nullptr;
+        }
+    };
+
+    template <class Type, bool Enabled = std::is_move_constructible<Type>::value>
+    struct Move_Operation {
+        static const bool value = true;
+
+        static void move(void *to, void *from) {
+            new (to) Type(std::move(*static_cast<Type *> (from)));
+        }
+    };
+
+    template <class Type> struct Move_Operation<Type, false> {
+        static const bool value = false;
+
+        static void move(void *, void *) {
+        }
+    };
+
+    template <class Type, bool Enabled = Has_Equal<Type>::value>
+    struct Equal_Operation {
+        static const bool value = true;
+
+        static bool equal(const void *a, const void *b) {
+            return *static_cast<const Type *> (a) == *static_cast<const Type *> (b);
+        }
+    };
+
+    template <class Type> struct Equal_Operation<Type, false> {
+        static const bool value = false;
+
+        static bool equal(const void *, const void *) {
+            return false;
+        }
+    };
+
+    template <class Type, bool Enabled = Has_Hash<Type>::value>
+    struct Hash_Operation {
+        static const bool value = true;
+
+        static std::size_t hash(const void *value) {
+            return std::hash<Type>()(*static_cast<const Type *> (value));
+        }
+    };
+
+    template <class Type> struct Hash_Operation<Type, false> {
+        static const bool value = false;
+
+        static std::size_t hash(const void *) {
+            return 0;
+        }
+    };
+
+    template <class Type> static void destroy_value(void *value) {
+        static_cast<Type *> (value)->~Type();
+    }
+
+    /**  \brief Registered types by id.
+     */
+    struct Type_Registry {
+        std::mutex mutex;
+        std::unordered_map<uint64_t, Type_Descriptor *> types;
+    };
+
+    /**
+     *  \brief Names Type in registry, whose mutex is held.
+     */
+    template <class Type> static void add_type(Type_Registry &registry,
+            const std::string &name) {
+        Type_Descriptor * d = Object::mutable_descriptor<Type>();
+        uint64_t id = Object::type_id(name);
+        auto found = registry.types.find(id);
+        if ((found != registry.types.end() && found->second != d) ||
+                (d->id != 0 && d->id != id) || name.empty()) {
+            printf("In Object.register_type(\"%s\"), the name or the type is "
+                    "already registered to something else.\n  "
+                    "See line number %d in file %s\n\n",
+                    name.c_str(), __LINE__, __FILE__);
+            throw -1;
+        }
+        d->name = name;
+        d->id = id;
+        registry.types[id] = d;
+    }
+
+    static Type_Registry & type_registry() {
+        static Type_Registry * registry = Object::make_type_registry();
+        return *registry;
+    }
+
+    /**
+     *  \brief Id of t. The built-in types are registered on first use of
+     *  the registry, so their id is 0 until then.
+     */
+    static uint64_t registered_id(const Type_Descriptor * t) {
+        if (t->id == 0)
+            Object::type_registry();
+        return t->id;
+    }
+
+    static Type_Registry * make_type_registry() {
+        Type_Registry * r = new Type_Registry();
+        Object::add_type<bool>(*r, "bool");
+        Object::add_type<char>(*r, "char");
+        Object::add_type<signed char>(*r, "signed char");
+        Object::add_type<unsigned char>(*r, "unsigned char");
+        Object::add_type<short>(*r, "short");
+        Object::add_type<unsigned short>(*r, "unsigned short");
+        Object::add_type<int>(*r, "int");
+        Object::add_type<unsigned int>(*r, "unsigned int");
+        Object::add_type<long>(*r, "long");
+        Object::add_type<unsigned long>(*r, "unsigned long");
+        Object::add_type<long long>(*r, "long long");
+        Object::add_type<unsigned long long>(*r, "unsigned long long");
+        Object::add_type<float>(*r, "float");
+        Object::add_type<double>(*r, "double");
+        Object::add_type<long double>(*r, "long double");
+        Object::add_type<std::string>(*r, "std::string");
+        Object::add_type<Object>(*r, "Object");
+        return r;
+    }
+
+    template <class Type> static Type_Descriptor * mutable_descriptor() {
+        typedef Copy_Operations<Type> Copy;
+        typedef Move_Operation<Type> Move;
+        typedef Equal_Operation<Type> Equal;
+        typedef Hash_Operation<Type> Hash;
+        static Type_Descriptor d = {
+            std::type_index(typeid (Type)), sizeof (Type),
+            std::alignment_of<Type>::value, std::is_base_of<Object, Type>::value,
+            std::is_same<Type, Object::Lazy_Cell>::value,
+            &Object::owned_bytes<Type>,
+            std::string(), 0,
+            Copy::value ? &Copy::copy : nullptr,
+            Move::value ? &Move::move : nullptr,
+            &Object::destroy_value<Type>,
+            Copy::value ? &Copy::clone : nullptr,
+            Equal::value ? &Equal::equal : nullptr,
+            Hash::value ? &Hash::hash : nullptr,
+            Serial<Type>::value ? &Serial<Type>::serialize : nullptr,
+            Serial<Type>::value ? &Serial<Type>::deserialize : nullptr,
+            Serial<Type>::value ? &Serial<Type>::deserialize_into : nullptr
+        };
+        return &d;
+    }
+
+    /**  \brief Stores a pointer to an object of arbitary type and the
+     *  Type_Descriptor corresponding to the stored object. 
+     */
+    struct Shared_Pointer_And_Type {
+        std::shared_ptr<void> p;
+        const Type_Descriptor * t;
+
+        Shared_Pointer_And_Type() : p(nullptr), t(nullptr) {
+        }
+
+        Shared_Pointer_And_Type(const std::shared_ptr<void>pp,
+                const Type_Descriptor * tt) : p(pp), t(tt) {
+        }
+
+        Shared_Pointer_And_Type(const Shared_Pointer_And_Type &other) :
+        p(other.p), t(other.t) {
+        }
+
+        Shared_Pointer_And_Type& operator =
+                (const Shared_Pointer_And_Type &other) {
+            this->p = other.p;
+            this->t = other.t;
+            return *this;
+        }
+    };
+    /**  \brief Value of a property set with Object::set_lazy. The factory
+     *  runs on the first force, under the cell's mutex, and its result is
+     *  kept in value. Later forces cost one acquire load.
+     *  If the factory throws, the cell stays unbuilt and the next force
+     *  tries again.
+     */
+    struct Lazy_Cell {
+        std::atomic<bool> ready;
+        std::mutex mutex;
+        std::function<Shared_Pointer_And_Type()> factory;
+        Shared_Pointer_And_Type value;
+
+        explicit Lazy_Cell(const std::function<Shared_Pointer_And_Type()> &f)
+        : ready(false), mutex(), factory(f), value() {
+        }
+
+        const Shared_Pointer_And_Type & force() {
+            if (!this->ready.load(std::memory_order_acquire)) {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                if (!this->ready.load(std::memory_order_relaxed)) {
+                    this->value = this->factory();
+                    this->factory = nullptr;
+                    this->ready.store(true, std::memory_order_release);
+                }
+            }
+            return this->value;
+        }
+
+        /**
+         *  \brief The built value, nullptr if it is not built yet.
+         */
+        const Shared_Pointer_And_Type * built() const {
+            return this->ready.load(std::memory_order_acquire) ? &this->value
+                    : nullptr;
+        }
+    };
+
+    /**
+     *   \brief Hash table type of my_contents
+     */
+    typedef std::unordered_map<std::string, Object::Shared_Pointer_And_Type,
+    std::hash<std::string>, std::equal_to<std::string>,
+    Object::Allocator<std::pair<const std::string,
+    Object::Shared_Pointer_And_Type> > > Contents;
+    /** 
+     *   \brief Stores persistent variables, std::function types, and Objects 
+     */
+    Contents my_contents;
+    /**  \brief Re-assignable function pointer.
+     *  Set with Object::setFunc and called with Object::call<Return_Type>.
+     */
+    pcast execute_me;
+    /** 
+     *  \brief Re-assignable pointer to parent of this object.
+     * Function in this class will use this pointer to go 
+     * up the inheritance hierarchy.
+     */
+    Object * my_parent;
+
+    /**  \brief Immutable property table built by Object::freeze. Keys are
+     *  placed with a minimal perfect hash (hash and displace): a key's hash
+     *  picks a bucket, the bucket's seed moves the hash to the key's own entry.
+     *  A lookup is one hash, one seed load and one key comparison, and the
+     *  table has exactly one entry per property.
+     */
+    struct Frozen_Table {
+        /** displacement seed of each bucket */
+        std::vector<uint32_t> seeds;
+        /** one entry per property, at the position its key hashes to */
+        std::vector<std::pair<std::string, Shared_Pointer_And_Type> > entries;
+
+        Frozen_Table() : seeds(), entries() {
+        }
+
+        /**
+         *  \brief Copies the table, for deep_clone, which then replaces the
+         *  nested Objects of the copy.
+         */
+        Frozen_Table(const Frozen_Table &other) : seeds(other.seeds),
+        entries(other.entries) {
+            ____OBJECT_COUNT(live_properties, (long long) this->entries.size());
+        }
+
+        ~Frozen_Table() {
+            ____OBJECT_COUNT(live_properties, -(long long) this->entries.size());
+        }
+
+        /**
+         *  \brief Maps x to [0, n) with a multiply instead of a division.
+         */
+        static std::size_t reduce(uint64_t x, std::size_t n) {
+#ifdef __SIZEOF_INT128__
+            // __extension__ keeps -pedantic from warning about __int128.
+            __extension__ typedef unsigned __int128 Wide;
+            return (std::size_t) (((Wide) x * n) >> 64);
+#else
+            return (std::size_t) (x % n);
+#endif
+        }
+
+        static std::size_t bucket(std::size_t hash, std::size_t n) {
+            return reduce((uint64_t) hash * 0x9E3779B97F4A7C15ULL, n);
+        }
+
+        static std::size_t position(std::size_t hash, uint32_t seed,
+                std::size_t n) {
+            uint64_t x = (uint64_t) hash ^ ((uint64_t) seed *
+                    0x9E3779B97F4A7C15ULL);
+            x ^= x >> 33;
+            x *= 0xff51afd7ed558ccdULL;
+            x ^= x >> 33;
+            return reduce(x, n);
+        }
+
+        const Shared_Pointer_And_Type * find(const std::string &name) const {
+            if (this->entries.empty())
+                return nullptr;
+            std::size_t h = std::hash<std::string>()(name);
+            uint32_t seed = this->seeds[bucket(h, this->seeds.size())];
+            const std::pair<std::string, Shared_Pointer_And_Type> &entry =
+                    this->entries[position(h, seed, this->entries.size())];
+            return entry.first == name ? &entry.second : nullptr;
+        }
+
+        /**
+         *  \brief Finds a seed for every bucket so that position sends each
+         *  of hashes to its own entry. Buckets are placed largest first,
+         *  each with the first seed that moves all of its keys to free
+         *  entries. Equal hashes can never be separated, so they are
+         *  found by sorting first rather than by trying every seed.
+         *  @param positions - set to the entry of each hash
+         *  @return false if two hashes are equal and cannot be separated
+         */
+        static bool place(const std::vector<std::size_t> &hashes,
+                std::vector<uint32_t> &seeds, std::vector<std::size_t> &positions) {
+            const std::size_t n = hashes.size();
+            positions.assign(n, 0);
+            seeds.clear();
+            if (n == 0)
+                return true;
+            std::vector<std::size_t> sorted(hashes);
+            std::sort(sorted.begin(), sorted.end());
+            if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end())
+                return false;
+            const std::size_t bucket_count = n / 2 + 1;
+            seeds.assign(bucket_count, 0);
+            std::vector<std::vector<Key> > buckets(bucket_count);
+            for (std::size_t k = 0; k < n; ++k)
+                buckets[bucket(hashes[k], bucket_count)].push_back(Key(hashes[k], k));
+            std::vector<std::size_t> order(bucket_count);
+            for (std::size_t b = 0; b < bucket_count; ++b)
+                order[b] = b;
+            std::sort(order.begin(), order.end(), Bucket_Larger(buckets));
+            std::vector<char> used(n, 0);
+            std::vector<std::size_t> placed;
+            for (std::size_t i = 0; i < bucket_count; ++i) {
+                const std::vector<Key> &bucket = buckets[order[i]];
+                if (bucket.empty())
+                    break;
+                for (uint32_t seed = 0;; ++seed) {
+                    if (seed == UINT32_MAX)
+                        return false;
+                    placed.clear();
+                    bool fits = true;
+                    for (std::size_t k = 0; k < bucket.size() && fits; ++k) {
+                        std::size_t pos = position(bucket[k].first, seed, n);
+                        fits = !used[pos] && std::find(placed.begin(),
+                                placed.end(), pos) == placed.end();
+                        placed.push_back(pos);
+                    }
+                    if (!fits)
+                        continue;
+                    for (std::size_t k = 0; k < bucket.size(); ++k) {
+                        used[placed[k]] = 1;
+                        positions[bucket[k].second] = placed[k];
+                    }
+                    seeds[order[i]] = seed;
+                    break;
+                }
+            }
+            return true;
+        }
+
+        /**
+         *  \brief Places every property of contents with Frozen_Table::place.
+         *  @return false if two keys have the same hash and cannot be separated
+         */
+        bool build(const Contents &contents) {
+            const std::size_t n = contents.size();
+            this->entries.assign(n,
+                    std::pair<std::string, Shared_Pointer_And_Type>());
+            std::vector<std::size_t> hashes;
+            std::vector<const Contents::value_type *> items;
+            hashes.reserve(n);
+            items.reserve(n);
+            for (auto it = contents.begin(); it != contents.end(); ++it) {
+                hashes.push_back(std::hash<std::string>()(it->first));
+                items.push_back(&*it);
+            }
+            std::vector<std::size_t> positions;
+            if (!place(hashes, this->seeds, positions))
+                return false;
+            for (std::size_t k = 0; k < n; ++k)
+                this->entries[positions[k]] = *items[k];
+            ____OBJECT_COUNT(live_properties, (long long) n);
+            return true;
+        }
+
+        /**  \brief A key's hash and its index in the keys being placed.
+         */
+        typedef std::pair<std::size_t, std::size_t> Key;
+
+        /**  \brief Orders bucket indices by descending bucket size.
+         */
+        struct Bucket_Larger {
+            const std::vector<std::vector<Key> > &buckets;
+
+            explicit Bucket_Larger(const std::vector<std::vector<Key> > &b)
+            : buckets(b) {
+            }
+
+            bool operator()(std::size_t a, std::size_t b) const {
+                return buckets[a].size() > buckets[b].size();
+            }
+        };
+    };
+
+    /**  \brief A cached result: the arguments and result of one call, in a
+     *  std::pair<std::tuple<A...>, Return_Type> whose descriptor is type.
+     */
+    struct Memo_Entry {
+        std::size_t hash;
+        const Type_Descriptor * type;
+        std::shared_ptr<void> value;
+    };
+
+    /**  \brief Bounded cache of one memoized function. entries is kept in
+     *  least recently used order, most recent first. mutex guards entries,
+     *  index and statistics, so that exec may be called from many threads.
+     *  It is not held while the function runs.
+     */
+    struct Memo_Function {
+        std::size_t capacity;
+        std::vector<std::string> dependencies;
+        std::list<Memo_Entry> entries;
+        std::unordered_map<std::size_t, std::list<Memo_Entry>::iterator> index;
+        Memo_Statistics statistics;
+        std::mutex mutex;
+
+        Memo_Function(std::size_t c, const std::vector<std::string> &d)
+        : capacity(c == 0 ? 1 : c), dependencies(d), entries(), index(),
+        statistics(Memo_Statistics()), mutex() {
+        }
+
+        /**
+         *  \brief Copies the settings, not the cached results.
+         */
+        Memo_Function(const Memo_Function &other)
+        : capacity(other.capacity), dependencies(other.dependencies),
+        entries(), index(), statistics(Memo_Statistics()), mutex() {
+        }
+
+        void invalidate() {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->entries.clear();
+            this->index.clear();
+            this->statistics.size = 0;
+        }
+
+        bool depends_on(const std::string &name, const std::string &self) const {
+            if (name == self)
+                return true;
+            for (std::size_t i = 0; i < this->dependencies.size(); ++i)
+                if (this->dependencies[i] == name)
+                    return true;
+            return false;
+        }
+    };
+
+    typedef std::unordered_map<std::string, Memo_Function> Memo_Table;
+
+    /**  \brief Versions of the properties of an Object, kept once
+     *  Object::track_versions is called, so that Object::diff finds the
+     *  properties changed since a replica's version without visiting the
+     *  others. Removed properties are kept as tombstones until there are
+     *  about half as many of them as properties.
+     */
+    struct Version_Table {
+        struct Slot_Version;
+        typedef std::pair<const std::string, Slot_Version> Entry;
+
+        struct Slot_Version {
+            uint64_t version;
+            bool removed;
+            /** neighbours in the order of change */
+            Entry * older;
+            Entry * newer;
+        };
+
+        /** random lineage of this Object, never 0 */
+        uint64_t id;
+        /** counts the changes of this Object */
+        uint64_t version;
+        /** the changes up to floor are not known one by one */
+        uint64_t floor;
+        /** the Object and version this Object last matched through
+         * Object::apply, 0 after a change of its own */
+        uint64_t source;
+        uint64_t source_version;
+        bool applying;
+        std::unordered_map<std::string, Slot_Version> slots;
+        /** least and most recently changed entries of slots */
+        Entry * oldest;
+        Entry * newest;
+        std::size_t tombstones;
+
+        Version_Table() : id(Version_Table::new_id()), version(0), floor(0),
+        source(0), source_version(0), applying(false), slots(),
+        oldest(nullptr), newest(nullptr), tombstones(0) {
+        }
+
+        Version_Table(const Version_Table &) = delete;
+        Version_Table& operator =(const Version_Table &) = delete;
+
+        void unlink(Entry * e) {
+            (e->second.older == nullptr ? this->oldest :
+                    e->second.older->second.newer) = e->second.newer;
+            (e->second.newer == nullptr ? this->newest :
+                    e->second.newer->second.older) = e->second.older;
+        }
+
+        void link_newest(Entry * e) {
+            e->second.older = this->newest;
+            e->second.newer = nullptr;
+            (this->newest == nullptr ? this->oldest :
+                    this->newest->second.newer) = e;
+            this->newest = e;
+        }
+
+        /**
+         *  \brief A random lineage. Each thread seeds its generator once
+         *  from std::random_device, which may cost a system call. A forked
+         *  process inherits the generator, so the clock is mixed in as
+         *  well, so that Objects of processes forked from one another do
+         *  not share a lineage.
+         */
+        static uint64_t new_id() {
+            static thread_local std::mt19937_64 generator(Version_Table::seed());
+            uint64_t id = generator() ^ ((uint64_t) std::chrono::steady_clock
+                    ::now().time_since_epoch().count() * 0x9E3779B97F4A7C15ULL);
+            return id == 0 ? 1 : id;
+        }
+
+        static uint64_t seed() {
+            std::random_device random;
+            return ((uint64_t) random() << 32) ^ (uint64_t) random();
+        }
+
+        void changed() {
+            this->version += 1;
+            if (!this->applying)
+                this->source = 0;
+        }
+
+        void touch(const std::string &name, bool removed) {
+            this->changed();
+            auto found = this->slots.find(name);
+            if (found == this->slots.end()) {
+                found = this->slots.insert(std::make_pair(name,
+                        Slot_Version())).first;
+            } else {
+                if (found->second.removed)
+                    this->tombstones -= 1;
+                this->unlink(&*found);
+            }
+            this->link_newest(&*found);
+            found->second.version = this->version;
+            found->second.removed = removed;
+            if (removed && ++this->tombstones > 64 + this->slots.size() / 2)
+                this->drop_tombstones();
+        }
+
+        /**
+         *  \brief Forgets the oldest half of the tombstones. A replica older
+         *  than the newest of them gets a full comparison from Object::diff.
+         */
+        void drop_tombstones() {
+            std::size_t keep = this->tombstones / 2;
+            Entry * e = this->oldest;
+            while (this->tombstones > keep && e != nullptr) {
+                Entry * next = e->second.newer;
+                if (e->second.removed) {
+                    this->floor = e->second.version;
+                    this->unlink(e);
+                    this->slots.erase(e->first);
+                    this->tombstones -= 1;
+                }
+                e = next;
+            }
+        }
+
+        /**
+         *  \brief Forgets every version, after a change of all properties.
+         */
+        void reset() {
+            this->changed();
+            this->floor = this->version;
+            this->slots.clear();
+            this->oldest = nullptr;
+            this->newest = nullptr;
+            this->tombstones = 0;
+        }
+    };
+
+    /**  \brief State that most Objects never have, kept out of line so
+     *  that it costs a plain Object a single pointer. Created by the first
+     *  Object::freeze, setMethod, setBatchFunc, memoize or track_versions.
+     */
+    struct Extension {
+        /** Table of a frozen Object, nullptr until Object::freeze. Shared
+         * by copies, since it never changes. */
+        std::shared_ptr<const Frozen_Table> frozen;
+        /** Methods set with Object::setMethod, indexed by method slot.
+         * Shared by copies until one of them sets a method. */
+        std::shared_ptr<std::vector<pcast> > methods;
+        /** Kernel set with Object::setBatchFunc, nullptr if none. Cast to
+         * the generic function pointer type void (*)(). */
+        void (*batch)();
+        /** Descriptor of the kernel's real function pointer type. */
+        const Type_Descriptor * batch_type;
+        /** Memoized functions, nullptr until Object::memoize. */
+        std::unique_ptr<Memo_Table> memo;
+        /** Versions of the properties, nullptr until Object::track_versions
+         * or Object::apply. Not copied. */
+        std::unique_ptr<Version_Table> versions;
+
+        Extension() : frozen(), methods(), batch(nullptr),
+        batch_type(nullptr), memo(), versions() {
+        }
+
+        /**
+         *  \brief Out of line so that ~Object does not inline the memo and
+         *  version tables, which keeps the frames of deeply nested
+         *  destructions small.
+         */
+        ____OBJECT_NOINLINE ~Extension() {
+        }
+    };
+
+    /**
+     *  \brief The rarely used state of this object, nullptr until it has
+     *  some.
+     */
+    std::unique_ptr<Extension> my_extension;
+
+    /**
+     *  \brief The extension of this object, created if it has none.
+     */
+    Extension & extension() {
+        if (this->my_extension == nullptr)
+            this->my_extension.reset(new Extension());
+        return *this->my_extension;
+    }
+
+    const Frozen_Table * frozen_table() const {
+        return this->my_extension == nullptr ? nullptr
+                : this->my_extension->frozen.get();
+    }
+
+    const std::vector<pcast> * method_table() const {
+        return this->my_extension == nullptr ? nullptr
+                : this->my_extension->methods.get();
+    }
+
+    Memo_Table * memo_table() const {
+        return this->my_extension == nullptr ? nullptr
+                : this->my_extension->memo.get();
+    }
+
+    Version_Table * version_table() const {
+        return this->my_extension == nullptr ? nullptr
+                : this->my_extension->versions.get();
+    }
+
+    /**
+     *  \brief The extension of a copy of o: the frozen and method tables
+     *  are shared, the memo is copied and versions are not kept.
+     *  @return nullptr if the copy needs none
+     */
+    static std::unique_ptr<Extension> copy_extension(const Object &o) {
+        const Extension * e = o.my_extension.get();
+        if (e == nullptr || (e->frozen == nullptr && e->methods == nullptr &&
+                e->batch == nullptr && e->memo == nullptr))
+            return std::unique_ptr<Extension>();
+        std::unique_ptr<Extension> copy(new Extension());
+        copy->frozen = e->frozen;
+        copy->methods = e->methods;
+        copy->batch = e->batch;
+        copy->batch_type = e->batch_type;
+        if (e->memo != nullptr)
+            copy->memo.reset(new Memo_Table(*e->memo));
+        return copy;
+    }
+
+    /**
+     *  \brief Drops the cached results that depend on the property name
+     *  and updates its version, after it was set or removed.
+     */
+    void extension_changed(const std::string &name, bool removed) {
+        Memo_Table * memo = this->my_extension->memo.get();
+        if (memo != nullptr)
+            for (auto it = memo->begin(); it != memo->end(); ++it)
+                if (it->second.depends_on(name, it->first))
+                    it->second.invalidate();
+        if (this->my_extension->versions != nullptr)
+            this->my_extension->versions->touch(name, removed);
+    }
+
+    /**
+     *  \brief Empties this object as clear does, frozen or not, but moves
+     *  its properties and frozen table into contents and frozen instead of
+     *  destroying them. Used by Cycle_Collector, which destroys them only
+     *  once every garbage Object is empty.
+     */
+    void release_contents(Contents &contents,
+            std::shared_ptr<const Frozen_Table> &frozen) {
+        if (Object::change_hook() != nullptr)
+            this->call_change_hook(change_clear, nullptr, nullptr, nullptr);
+        ____OBJECT_COUNT(live_properties, -(long long) this->my_contents.size());
+        contents.swap(this->my_contents);
+        if (this->my_extension == nullptr)
+            return;
+        frozen.swap(this->my_extension->frozen);
+        this->invalidate();
+        if (this->my_extension->versions != nullptr)
+            this->my_extension->versions->reset();
+    }
+
+    /**
+     *  \brief Hash of a list of arguments, combining std::hash of each.
+     */
+    template <class ...A> static std::size_t hash_arguments(const A &...a) {
+        std::size_t h = 0;
+        int expand[] = {0, (h = h * 1000003u ^ std::hash<A>()(a), 0)...};
+        (void) expand;
+        return h;
+    }
+
+    /**
+     *  \brief value is true if Type has a std::hash and an operator ==.
+     */
+    template <class Type> struct Memo_Key {
+        static const bool value = Has_Hash<Type>::value &&
+                Has_Equal<Type>::value;
+    };
+
+    template <class ...A> struct Memo_Keys : std::true_type {
+    };
+
+    template <class First, class ...Rest> struct Memo_Keys<First, Rest...>
+    : std::integral_constant<bool, Memo_Key<First>::value &&
+    Memo_Keys<Rest...>::value> {
+    };
+
+    /**
+     *  \brief Returns the cached result of a memoized call, or computes it
+     *  with compute() and caches it. Cacheable is false for void or
+     *  uncopyable results and for arguments without std::hash or ==; such
+     *  calls are computed every time.
+     */
+    template <bool Cacheable, class Unused = void> struct Memoized {
+
+        template <class Return_Type, class Compute, class ...A>
+        static Return_Type get(Memo_Function &m, Compute compute,
+                const A &...Parameters) {
+            typedef std::pair<std::tuple<A...>, Return_Type> Value;
+            const Type_Descriptor * type = Object::descriptor<Value>();
+            std::size_t hash = Object::hash_arguments(Parameters...);
+            std::shared_ptr<void> hit;
+            {
+                std::lock_guard<std::mutex> lock(m.mutex);
+                auto found = m.index.find(hash);
+                if (found != m.index.end() && found->second->type == type &&
+                        static_cast<const Value *> (found->second->value.get())
+                        ->first == std::tie(Parameters...)) {
+                    ++m.statistics.hits;
+                    m.entries.splice(m.entries.begin(), m.entries, found->second);
+                    hit = found->second->value;
+                } else
+                    ++m.statistics.misses;
+            }
+            // The result is copied out of the lock, the entry is kept alive
+            // by hit if another thread drops it meanwhile.
+            if (hit != nullptr)
+                return static_cast<const Value *> (hit.get())->second;
+            Return_Type result = compute();
+            Memo_Entry entry = {hash, type, std::static_pointer_cast<void>
+                (std::allocate_shared<Value>(Object::Allocator<Value>(),
+                        std::make_tuple(Parameters...), result))};
+            std::lock_guard<std::mutex> lock(m.mutex);
+            auto found = m.index.find(hash);
+            if (found != m.index.end()) {
+                // Same hash, other arguments or types: replace that entry.
+                *found->second = entry;
+                m.entries.splice(m.entries.begin(), m.entries, found->second);
+                return result;
+            }
+            if (m.entries.size() >= m.capacity) {
+                m.index.erase(m.entries.back().hash);
+                m.entries.pop_back();
+                ++m.statistics.evictions;
+            }
+            m.entries.push_front(entry);
+            m.index[hash] = m.entries.begin();
+            m.statistics.size = m.entries.size();
+            return result;
+        }
+    };
+
+    template <class Unused> struct Memoized<false, Unused> {
+
+        template <class Return_Type, class Compute, class ...A>
+        static Return_Type get(Memo_Function &, Compute compute, const A &...) {
+            return compute();
+        }
+    };
+
+    template <class Return_Type, class ...A> struct Cacheable
+    : std::integral_constant<bool, !std::is_void<Return_Type>::value &&
+    std::is_copy_constructible<Return_Type>::value &&
+    Memo_Keys<A...>::value> {
+    };
+
+    /**
+     *  \brief The memo of function_name, nullptr if it is not memoized.
+     */
+    Memo_Function * find_memo(const std::string &function_name) {
+        Memo_Table * memo = this->memo_table();
+        if (memo == nullptr)
+            return nullptr;
+        auto found = memo->find(function_name);
+        return found == memo->end() ? nullptr : &found->second;
+    }
+
+    /**  \brief Process-wide names of method slots.
+     */
+    struct Method_Registry {
+        std::mutex mutex;
+        std::unordered_map<std::string, std::size_t> slots;
+        std::vector<std::string> names;
+    };
+
+    static Method_Registry & method_registry() {
+        static Method_Registry registry;
+        return registry;
+    }
+
+    /**
+     *  \brief The slot of the property name of this object, ignoring the
+     *  parent tree. A lazy property's slot holds its Lazy_Cell.
+     *  @return the slot, or nullptr when this object has no such property
+     */
+    const Shared_Pointer_And_Type * find_slot(const std::string &name) const {
+        const Frozen_Table * frozen = this->frozen_table();
+        if (frozen != nullptr)
+            return frozen->find(name);
+        auto pair = this->my_contents.find(name);
+        return pair == this->my_contents.end() ? nullptr : &pair->second;
+    }
+
+    /**
+     *  \brief The value of the property name of this object, ignoring the
+     *  parent tree. Builds the value of a lazy property.
+     *  @return the slot, or nullptr when this object has no such property
+     */
+    const Shared_Pointer_And_Type * find_own(const std::string &name) const {
+        const Shared_Pointer_And_Type * found = this->find_slot(name);
+        if (found != nullptr && found->t != nullptr && found->t->is_lazy)
+            return &static_cast<Lazy_Cell *> (found->p.get())->force();
+        return found;
+    }
+
+    /**
+     *  \brief Throws -1 if this object is frozen. Called before every change
+     *  to the properties.
+     */
+    void check_not_frozen(const char *caller, const std::string &name) const {
+        if (this->frozen_table() == nullptr)
+            return;
+        printf("In Object.%s(\"%s\"), Object is frozen and its properties "
+                "cannot be changed.\n  See line number %d in file %s\n\n",
+                caller, name.c_str(), __LINE__, __FILE__);
+        throw -1;
+    }
+
+    /**
+     *  \brief Calls f(name, slot) for every property of this object,
+     *  frozen or not.
+     */
+    template <class Function> void for_each_slot(Function f) const {
+        const Frozen_Table * frozen = this->frozen_table();
+        if (frozen != nullptr) {
+            for (std::size_t i = 0; i < frozen->entries.size(); ++i)
+                f(frozen->entries[i].first, frozen->entries[i].second);
+            return;
+        }
+        for (auto it = this->my_contents.begin();
+                it != this->my_contents.end(); ++it)
+            f(it->first, it->second);
+    }
+
+    /**
+     *  \brief Converts the void pointer returned through execute_me into
+     *  Return_Type. The pointed-to heap value is copied and freed.
+     */
+    template <class Return_Type, class Unused = void> struct Returned {
+
+        static Return_Type take(void *pointer) {
+            Return_Type * rptr = reinterpret_cast<Return_Type *> (pointer);
+            Return_Type ret = *rptr; // copy contents of hash table
+            delete rptr;
+            return ret; // return the copy.
+        }
+    };
+
+    /**
+     *  \brief void functions return nothing to convert.
+     */
+    template <class Unused> struct Returned<void, Unused> {
+
+        static void take(void *) {
+        }
+    };
+
+    /**
+     *  \brief Compile-time list of tuple indices 0 .. N-1, built by
+     *  Make_Indices<N>::type.
+     */
+    template <std::size_t ...I> struct Indices {
+    };
+
+    template <std::size_t N, std::size_t ...I> struct Make_Indices
+    : Make_Indices<N - 1, N - 1, I...> {
+    };
+
+    template <std::size_t ...I> struct Make_Indices<0, I...> {
+        typedef Indices<I...> type;
+    };
+
+    template <class Return_Type, class ...A, std::size_t ...I>
+    static Return_Type call_tuple(Object &callable,
+            const std::tuple<A...> &arguments, Indices<I...>) {
+        return callable.call<Return_Type>(std::get<I>(arguments)...);
+    }
+
+    template <class Return_Type, class ...A, std::size_t ...I>
+    static Return_Type exec_tuple(Object &target,
+            const std::string &function_name,
+            const std::tuple<A...> &arguments, Indices<I...>) {
+        return target.exec<Return_Type>(function_name,
+                std::get<I>(arguments)...);
+    }
+
+    template <class Standard_Function, class Return_Type, class ...A,
+    std::size_t ...I> static Return_Type lexec_tuple(Object &target,
+            const std::string &function_name,
+            const std::tuple<A...> &arguments, Indices<I...>) {
+        return target.lexec<Standard_Function, Return_Type>(function_name,
+                std::get<I>(arguments)...);
+    }
+
+    template <class Return_Type, class Standard_Function, class ...A,
+    std::size_t ...I> static Return_Type lcall_tuple
+    (const Standard_Function &function, const std::tuple<A...> &arguments,
+            Indices<I...>) {
+        return function(std::get<I>(arguments)...);
+    }
+
+    /**
+     *  \brief The per-element loops of exec_batch and lexec_batch. Results
+     *  are stored unless Return_Type is void.
+     */
+    template <class Return_Type, class Unused = void> struct Batch_Loop {
+
+        template <class ...A> static void exec(Object &callable,
+                const std::tuple<A...> *arguments, std::size_t count,
+                Return_Type *results) {
+            for (std::size_t i = 0; i < count; ++i)
+                results[i] = Object::call_tuple<Return_Type>(callable,
+                    arguments[i], typename Make_Indices<sizeof...(A)>::type());
+        }
+
+        template <class Standard_Function, class ...A> static void lexec
+        (const Standard_Function &function, const std::tuple<A...> *arguments,
+                std::size_t count, Return_Type *results) {
+            for (std::size_t i = 0; i < count; ++i)
+                results[i] = Object::lcall_tuple<Return_Type>(function,
+                    arguments[i], typename Make_Indices<sizeof...(A)>::type());
+        }
+
+        template <class ...A> static void exec_each(Object &target,
+                const std::string &function_name,
+                const std::tuple<A...> *arguments, std::size_t count,
+                Return_Type *results) {
+            for (std::size_t i = 0; i < count; ++i)
+                results[i] = Object::exec_tuple<Return_Type>(target,
+                    function_name, arguments[i],
+                    typename Make_Indices<sizeof...(A)>::type());
+        }
+
+        template <class Standard_Function, class ...A> static void lexec_each
+        (Object &target, const std::string &function_name,
+                const std::tuple<A...> *arguments, std::size_t count,
+                Return_Type *results) {
+            for (std::size_t i = 0; i < count; ++i)
+                results[i] = Object::lexec_tuple<Standard_Function,
+                    Return_Type>(target, function_name, arguments[i],
+                    typename Make_Indices<sizeof...(A)>::type());
+        }
+    };
+
+    template <class Unused> struct Batch_Loop<void, Unused> {
+
+        template <class ...A> static void exec(Object &callable,
+                const std::tuple<A...> *arguments, std::size_t count, void *) {
+            for (std::size_t i = 0; i < count; ++i)
+                Object::call_tuple<void>(callable, arguments[i],
+                    typename Make_Indices<sizeof...(A)>::type());
+        }
+
+        template <class Standard_Function, class ...A> static void lexec
+        (const Standard_Function &function, const std::tuple<A...> *arguments,
+                std::size_t count, void *) {
+            for (std::size_t i = 0; i < count; ++i)
+                Object::lcall_tuple<void>(function, arguments[i],
+                    typename Make_Indices<sizeof...(A)>::type());
+        }
+
+        template <class ...A> static void exec_each(Object &target,
+                const std::string &function_name,
+                const std::tuple<A...> *arguments, std::size_t count, void *) {
+            for (std::size_t i = 0; i < count; ++i)
+                Object::exec_tuple<void>(target, function_name, arguments[i],
+                    typename Make_Indices<sizeof...(A)>::type());
+        }
+
+        template <class Standard_Function, class ...A> static void lexec_each
+        (Object &target, const std::string &function_name,
+                const std::tuple<A...> *arguments, std::size_t count, void *) {
+            for (std::size_t i = 0; i < count; ++i)
+                Object::lexec_tuple<Standard_Function, void>(target,
+                    function_name, arguments[i],
+                    typename Make_Indices<sizeof...(A)>::type());
+        }
+    };
+
+    /**
+     *  \brief Copies value into a new shared allocation.
+     */
+    template <class Type> static Shared_Pointer_And_Type make_slot
+    (const Type &value) {
+        std::shared_ptr<Type> shared_pointer =
+                std::allocate_shared<Type>(Object::Allocator<Type>(), value);
+        Shared_Pointer_And_Type slot(std::static_pointer_cast<void>
+                (shared_pointer), Object::descriptor<Type>());
+        Object::call_slot_hook(slot.p, slot.t);
+        return slot;
+    }
+
+    /**  \brief Values set with Object::set_interned, by hash, in stripes
+     *  locked on their own. The table holds weak pointers, so a value is
+     *  freed with the last property holding it. Expired entries are swept
+     *  when a stripe doubles in size.
+     */
+    struct Intern_Table {
+        struct Entry {
+            std::weak_ptr<void> value;
+            const Type_Descriptor * type;
+        };
+
+        struct Stripe {
+            std::mutex mutex;
+            std::unordered_multimap<std::size_t, Entry> entries;
+            std::size_t sweep_at;
+
+            Stripe() : mutex(), entries(), sweep_at(64) {
+            }
+        };
+
+        Stripe stripes[64];
+        std::atomic<long long> calls;
+        std::atomic<long long> hits;
+        std::atomic<long long> bytes_saved;
+
+        Intern_Table() : calls(0), hits(0), bytes_saved(0) {
+        }
+
+        /**
+         *  \brief The interned value of type t equal to value, nullptr if
+         *  there is none. The stripe's mutex is held.
+         */
+        static std::shared_ptr<void> find(Stripe &stripe, std::size_t hash,
+                const Type_Descriptor * t, const void * value) {
+            auto range = stripe.entries.equal_range(hash);
+            for (auto it = range.first; it != range.second; ++it) {
+                if (it->second.type != t)
+                    continue;
+                std::shared_ptr<void> p = it->second.value.lock();
+                if (p != nullptr && t->equal(p.get(), value))
+                    return p;
+            }
+            return nullptr;
+        }
+
+        /**
+         *  \brief Drops the entries of values that were freed. The
+         *  stripe's mutex is held.
+         */
+        static void sweep(Stripe &stripe) {
+            for (auto it = stripe.entries.begin(); it != stripe.entries.end();) {
+                if (it->second.value.expired())
+                    it = stripe.entries.erase(it);
+                else
+                    ++it;
+            }
+            stripe.sweep_at = stripe.entries.size() * 2 > 64
+                    ? stripe.entries.size() * 2 : 64;
+        }
+    };
+
+    static Intern_Table & intern_table() {
+        static Intern_Table table;
+        return table;
+    }
+
+    /**  \brief Deleter of interned values. They are allocated apart from
+     *  their shared_ptr control block, which the table's weak pointers keep
+     *  alive, so that the value's memory is returned as soon as it is freed.
+     */
+    template <class Type> struct Interned_Deleter {
+        void operator()(Type * value) const {
+            value->~Type();
+            Object::Allocator<Type>().deallocate(value, 1);
+        }
+    };
+
+    /**
+     *  \brief The slot set_interned stores: an interned value equal to
+     *  value, or a copy of value that is interned.
+     */
+    template <class Type> static Shared_Pointer_And_Type intern_slot
+    (const std::string &name, const Type &value) {
+        const Type_Descriptor * t = Object::descriptor<Type>();
+        if (t->hash == nullptr || t->equal == nullptr || t->is_object) {
+            printf("In Object.set_interned(\"%s\"), the type has no hash "
+                    "function or no operator ==, or is an Object.\n  "
+                    "See line number %d in file %s\n\n",
+                    name.c_str(), __LINE__, __FILE__);
+            throw -1;
+        }
+        Intern_Table &table = Object::intern_table();
+        table.calls.fetch_add(1, std::memory_order_relaxed);
+        const std::size_t hash = t->hash(&value);
+        Intern_Table::Stripe &stripe = table.stripes[(std::size_t)
+                (((uint64_t) hash * 0x9E3779B97F4A7C15ULL) >> 58)];
+        std::shared_ptr<void> shared;
+        {
+            std::lock_guard<std::mutex> lock(stripe.mutex);
+            shared = Intern_Table::find(stripe, hash, t, &value);
+        }
+        if (shared == nullptr) {
+            Type * copy = Object::Allocator<Type>().allocate(1);
+            try {
+                new (copy) Type(value);
+            } catch (...) {
+                Object::Allocator<Type>().deallocate(copy, 1);
+                throw;
+            }
+            std::shared_ptr<void> created(copy, Interned_Deleter<Type>(),
+                    Object::Allocator<char>());
+            std::lock_guard<std::mutex> lock(stripe.mutex);
+            shared = Intern_Table::find(stripe, hash, t, &value);
+            if (shared == nullptr) {
+                if (stripe.entries.size() >= stripe.sweep_at)
+                    Intern_Table::sweep(stripe);
+                Intern_Table::Entry entry = {created, t};
+                stripe.entries.insert(std::make_pair(hash, entry));
+                Shared_Pointer_And_Type slot(created, t);
+                Object::call_slot_hook(slot.p, slot.t);
+                return slot;
+            }
+        }
+        table.hits.fetch_add(1, std::memory_order_relaxed);
+        table.bytes_saved.fetch_add((long long) (t->size
+                + t->owned_bytes(shared.get())), std::memory_order_relaxed);
+        return Shared_Pointer_And_Type(shared, t);
+    }
+
+    /**
+     *  \brief Adds or replaces the property name. Every property write goes
+     *  through here.
+     */
+    void store(const std::string &name, const Shared_Pointer_And_Type &slot) {
+        this->check_not_frozen("set", name);
+        if (Object::change_hook() != nullptr)
+            this->call_change_hook(change_set, &name, slot.p.get(),
+                slot.t);
+#ifdef PROTOTYPAL_CPP_STATISTICS
+        std::size_t before = this->my_contents.size();
+        this->my_contents[name] = slot;
+        ____OBJECT_COUNT(live_properties,
+                (long long) (this->my_contents.size() - before));
+#else
+        this->my_contents[name] = slot;
+#endif
+        if (this->my_extension != nullptr)
+            this->extension_changed(name, false);
+    }
+
+    /**
+     *  \brief Heap bytes owned by a value, beyond sizeof. Specialized for
+     *  std::string at the end of this file.
+     */
+    template <class Type> static std::size_t owned_bytes(const void *) {
+        return 0;
+    }
+
+    /**
+     *  \brief Heap bytes of a string, zero when it fits in its own buffer.
+     */
+    static std::size_t string_bytes(const std::string &s) {
+        const char * d = s.data();
+        const char * self = reinterpret_cast<const char *> (&s);
+        if (d >= self && d < self + sizeof (std::string))
+            return 0;
+        return s.capacity() + 1;
+    }
+
+    /**
+     *  \brief Estimated size of a make_shared control block, not counting
+     *  the value: a vtable pointer and the use and weak counts.
+     */
+    static const std::size_t control_block_bytes =
+            sizeof (void *) + 2 * sizeof (int);
+
+    /**
+     *  \brief Estimated size of one my_contents node, not counting the key
+     *  and slot: the next pointer and the cached hash code.
+     */
+    static const std::size_t node_bytes =
+            sizeof (void *) + sizeof (std::size_t);
+
+    /**
+     *  \brief Function object for for_each_slot that lists every slot.
+     */
+    struct Slot_Collector {
+        std::vector<std::pair<const std::string *,
+        const Shared_Pointer_And_Type *> > &out;
 
-/**  \brief Dynamic object which is capable of adding static function pointers, 
- *  std::function lambads, and values to itself
- */
-class Object {
-    /** 
-     *  \brief Magic number used for type identification 
+        explicit Slot_Collector(std::vector<std::pair<const std::string *,
+                const Shared_Pointer_And_Type *> > &o) : out(o) {
+        }
+
+        void operator()(const std::string &name,
+                const Shared_Pointer_And_Type &slot) const {
+            out.push_back(std::make_pair(&name, &slot));
+        }
+    };
+
+    /**
+     *  \brief Adds this Object's usage to usage. Nested Objects already in
+     *  visited are not counted again.
      */
-    const int64_t my_type = ____OBJECT_TYPE;
+    void add_memory_usage(Memory_Usage &usage, bool deep,
+            std::unordered_set<const void *> &visited) const {
+        usage.buckets += this->my_contents.bucket_count() * sizeof (void *);
+        std::size_t slot_bytes = sizeof (Shared_Pointer_And_Type) + node_bytes;
+        if (this->my_extension != nullptr)
+            usage.header += sizeof (Extension);
+        const Frozen_Table * frozen = this->frozen_table();
+        if (frozen != nullptr) {
+            usage.buckets += sizeof (Frozen_Table) + control_block_bytes +
+                    frozen->seeds.capacity() * sizeof (uint32_t);
+            slot_bytes = sizeof (Shared_Pointer_And_Type);
+        }
+        const std::vector<pcast> * methods = this->method_table();
+        if (methods != nullptr)
+            usage.slots += sizeof (std::vector<pcast>) + control_block_bytes +
+                methods->capacity() * sizeof (pcast);
+        std::vector<std::pair<const std::string *,
+                const Shared_Pointer_And_Type *> > slots;
+        this->for_each_slot(Slot_Collector(slots));
+        for (std::size_t i = 0; i < slots.size(); ++i) {
+            const Shared_Pointer_And_Type * value = slots[i].second;
+            usage.keys += sizeof (std::string) + string_bytes(*slots[i].first);
+            usage.slots += slot_bytes;
+            if (value->p == nullptr || value->t == nullptr)
+                continue;
+            if (value->t->is_lazy) {
+                usage.control_blocks += control_block_bytes;
+                usage.values += value->t->size;
+                value = static_cast<const Lazy_Cell *> (value->p.get())->built();
+                if (value == nullptr || value->p == nullptr)
+                    continue;
+            }
+            const Shared_Pointer_And_Type &spt = *value;
+            if (spt.t->is_object) {
+                if (!visited.insert(spt.p.get()).second)
+                    continue;
+                usage.control_blocks += control_block_bytes;
+                usage.nested_objects += spt.t->size;
+                if (deep) {
+                    Memory_Usage inner = Memory_Usage();
+                    static_cast<const Object *> (spt.p.get())->add_memory_usage
+                            (inner, deep, visited);
+                    usage.nested_objects += inner.total();
+                }
+            } else {
+                usage.control_blocks += control_block_bytes;
+                usage.values += spt.t->size + spt.t->owned_bytes(spt.p.get());
+            }
+        }
+    }
 
-    /**  \brief Stores a pointer to an object of arbitary type and a typeindex(typeid) 
-     *  corresponding to the stored object. 
+    /**
+     *  \brief The value of slot, building it first if it is lazy.
      */
-    struct Shared_Pointer_And_Type {
-        std::shared_ptr<void> p;
-        std::type_index t;
+    static const Shared_Pointer_And_Type * built_slot
+    (const Shared_Pointer_And_Type * slot) {
+        if (slot->t != nullptr && slot->t->is_lazy)
+            return &static_cast<Lazy_Cell *> (slot->p.get())->force();
+        return slot;
+    }
 
-        Shared_Pointer_And_Type() : p(nullptr), t(typeid (void)) {
+    /**
+     *  \brief Appends v to out in 7-bit groups, low group first.
+     */
+    static void put_varint(std::string &out, uint64_t v) {
+        while (v >= 0x80) {
+            out.push_back((char) (v | 0x80));
+            v >>= 7;
         }
+        out.push_back((char) v);
+    }
 
-        Shared_Pointer_And_Type(const std::shared_ptr<void>pp,
-                const std::type_index tt) : p(pp), t(tt) {
+    /**
+     *  \brief Reads a put_varint number from [in, end) and advances in.
+     *  @return false if the input ends first
+     */
+    static bool get_varint(const char *&in, const char *end, uint64_t &v) {
+        v = 0;
+        for (unsigned shift = 0; in != end && shift < 64; shift += 7) {
+            unsigned char byte = (unsigned char) *in++;
+            v |= (uint64_t) (byte & 0x7f) << shift;
+            if (byte < 0x80)
+                return true;
         }
+        return false;
+    }
 
-        Shared_Pointer_And_Type(const Shared_Pointer_And_Type &other) :
-        p(other.p), t(other.t) {
+    /**  \brief Snapshot format written by Object::save: the magic and
+     *  version, then a byte order mark and the payload length, all in host
+     *  byte order, then the payload.
+     */
+    static const uint32_t snapshot_magic = 0x534f4350; // "PCOS"
+    static const uint32_t snapshot_version = 1;
+    static const uint32_t snapshot_byte_order = 0x01020304;
+    static const std::size_t snapshot_header_bytes = 20;
+    /** object flags: held by a property of another saved Object, frozen */
+    static const unsigned char snapshot_owned = 1;
+    static const unsigned char snapshot_frozen = 2;
+    /** value tags before the type numbers: an empty slot, an Object */
+    static const uint64_t snapshot_empty = 0;
+    static const uint64_t snapshot_object = 1;
+
+    /**  \brief Objects and value types of a snapshot, numbered in the order
+     *  they are found from the saved Object.
+     */
+    struct Snapshot_Index {
+        std::vector<const Object *> objects;
+        std::vector<unsigned char> flags;
+        std::unordered_map<const Object *, uint64_t> object_numbers;
+        std::vector<const Type_Descriptor *> types;
+        std::unordered_map<const Type_Descriptor *, uint64_t> type_numbers;
+
+        uint64_t add(const Object * o) {
+            auto found = this->object_numbers.find(o);
+            if (found != this->object_numbers.end())
+                return found->second;
+            uint64_t n = this->objects.size();
+            this->object_numbers[o] = n;
+            this->objects.push_back(o);
+            this->flags.push_back(o->frozen_table() != nullptr ? snapshot_frozen
+                    : 0);
+            return n;
         }
 
-        Shared_Pointer_And_Type& operator =
-                (const Shared_Pointer_And_Type &other) {
-            this->p = other.p;
-            this->t = other.t;
-            return *this;
+        /**
+         *  \brief Numbers every Object reachable from root through
+         *  properties and parents, and the types of their values. Builds
+         *  lazy values. Throws -1 on a value that cannot be saved.
+         */
+        explicit Snapshot_Index(const Object &root) : objects(), flags(),
+        object_numbers(), types(), type_numbers() {
+            this->add(&root);
+            this->expand(0);
+        }
+
+        /**
+         *  \brief Numbers the Objects and types reachable from the Objects
+         *  numbered first and after, which Journal uses to add the Objects
+         *  it meets to its index.
+         */
+        void expand(std::size_t first) {
+            std::vector<std::pair<const std::string *,
+                    const Shared_Pointer_And_Type *> > slots;
+            for (std::size_t i = first; i < this->objects.size(); ++i) {
+                const Object &o = *this->objects[i];
+                if (o.my_parent != nullptr)
+                    this->add(o.my_parent);
+                slots.clear();
+                o.for_each_slot(Slot_Collector(slots));
+                for (std::size_t j = 0; j < slots.size(); ++j) {
+                    const Shared_Pointer_And_Type * slot =
+                            Object::built_slot(slots[j].second);
+                    if (slot->p == nullptr || slot->t == nullptr)
+                        continue;
+                    if (slot->t == Object::descriptor<Object>()) {
+                        this->flags[this->add(static_cast<const Object *>
+                                (slot->p.get()))] |= snapshot_owned;
+                    } else {
+                        this->add_type(slot->t, *slots[j].first);
+                    }
+                }
+            }
+        }
+
+        /**
+         *  \brief Numbers the type t of the property name. Throws -1 if its
+         *  values cannot be saved.
+         */
+        uint64_t add_type(const Type_Descriptor * t, const std::string &name) {
+            auto found = this->type_numbers.find(t);
+            if (found != this->type_numbers.end())
+                return found->second;
+            if (Object::registered_id(t) == 0 || t->serialize == nullptr
+                    || t->is_object) {
+                printf("In Object.save, property \"%s\" holds a type "
+                        "that is not registered or cannot be "
+                        "serialized.\n  See line number %d in file %s\n\n",
+                        name.c_str(), __LINE__, __FILE__);
+                throw -1;
+            }
+            uint64_t n = this->types.size();
+            this->type_numbers[t] = n;
+            this->types.push_back(t);
+            return n;
+        }
+
+        uint64_t object_number(const Object * o) const {
+            return this->object_numbers.find(o)->second;
+        }
+
+        uint64_t type_number(const Type_Descriptor * t) const {
+            return this->type_numbers.find(t)->second;
         }
     };
-    /** 
-     *   \brief Stores persistent variables, std::function types, and Objects 
+
+    /**
+     *  \brief Appends the parent and properties of o to out: the parent's
+     *  number plus one, or 0, then the property count and for every
+     *  property its name, a value tag, and the Object number or the
+     *  length-prefixed serialized value. index is a Snapshot_Index or
+     *  an Object_Graph.
      */
-    std::unordered_map<std::string, Object::Shared_Pointer_And_Type>
-    my_contents;
-    /**  \brief Re-assignable function pointer.
-     *  Set with Object::setFunc and called with Object::call<Return_Type>.
+    template <class Index> static void write_snapshot_object(const Object &o,
+            const Index &index, std::string &out) {
+        std::vector<std::pair<const std::string *,
+                const Shared_Pointer_And_Type *> > slots;
+        o.for_each_slot(Slot_Collector(slots));
+        Object::write_snapshot_slots(o.my_parent, slots, index, out);
+    }
+
+    /**
+     *  \brief write_snapshot_object for an Object with parent and the
+     *  properties slots, which need not be held by an Object.
      */
-    pcast execute_me;
-    /** 
-     *  \brief Re-assignable pointer to parent of this object.
-     * Function in this class will use this pointer to go 
-     * up the inheritance hierarchy.
+    template <class Index> static void write_snapshot_slots
+    (const Object * parent, const std::vector<std::pair<const std::string *,
+            const Shared_Pointer_And_Type *> > &slots, const Index &index,
+            std::string &out) {
+        put_varint(out, parent == nullptr ? 0 :
+                index.object_number(parent) + 1);
+        put_varint(out, slots.size());
+        std::string value;
+        for (std::size_t i = 0; i < slots.size(); ++i) {
+            const Shared_Pointer_And_Type * slot =
+                    Object::built_slot(slots[i].second);
+            put_varint(out, slots[i].first->size());
+            out.append(*slots[i].first);
+            if (slot->p == nullptr || slot->t == nullptr) {
+                put_varint(out, snapshot_empty);
+            } else if (slot->t == Object::descriptor<Object>()) {
+                put_varint(out, snapshot_object);
+                put_varint(out, index.object_number
+                        (static_cast<const Object *> (slot->p.get())));
+            } else {
+                put_varint(out, index.type_number(slot->t) + 2);
+                value.clear();
+                slot->t->serialize(slot->p.get(), value);
+                put_varint(out, value.size());
+                out.append(value);
+            }
+        }
+    }
+
+    static void corrupt_snapshot(int line) {
+        printf("In Object.load, the snapshot is truncated or corrupt.\n  "
+                "See line number %d in file %s\n\n", line, __FILE__);
+        throw -1;
+    }
+
+    /**
+     *  \brief Reads the length bytes of a snapshot after its header. The
+     *  length comes from the stream itself, so in a seekable stream it is
+     *  checked against the bytes left before anything is allocated. Other
+     *  streams are read in chunks, so that a corrupt length costs no more
+     *  memory than the stream holds.
+     *  @return false if the stream ends first
      */
-    Object * my_parent;
+    static bool read_snapshot_payload(std::istream &in, uint64_t length,
+            std::string &payload) {
+        const std::istream::pos_type none(-1);
+        std::istream::pos_type here = in.tellg();
+        if (here != none && in.seekg(0, std::ios::end)) {
+            std::istream::pos_type last = in.tellg();
+            in.seekg(here);
+            if (last != none && in) {
+                if (length > (uint64_t) (last - here))
+                    return false;
+                payload.assign((std::size_t) length, '\0');
+                return (bool) in.read(&payload[0], (std::streamsize) length);
+            }
+        }
+        in.clear();
+        const uint64_t chunk = 1 << 20;
+        payload.clear();
+        while (payload.size() < length) {
+            std::size_t read = payload.size();
+            payload.resize(read + (std::size_t) std::min(chunk,
+                    length - read));
+            if (!in.read(&payload[read], (std::streamsize)
+                    (payload.size() - read)))
+                return false;
+        }
+        return true;
+    }
+
+    /**  \brief Storage for the values of one Object read by Object::load,
+     *  allocated at once. Every value shares ownership of the block, which
+     *  is freed with the last of them.
+     */
+    struct Value_Block {
+        char * data;
+        std::size_t bytes;
+        /** values constructed in data, destroyed with the block */
+        std::vector<std::pair<void *, const Type_Descriptor *> > values;
+
+        explicit Value_Block(std::size_t n) : data(Allocator<char>().allocate(n)),
+        bytes(n), values() {
+        }
+
+        Value_Block(const Value_Block &) = delete;
+        Value_Block& operator =(const Value_Block &) = delete;
+
+        ~Value_Block() {
+            for (std::size_t i = 0; i < this->values.size(); ++i)
+                this->values[i].second->destroy(this->values[i].first);
+            Allocator<char>().deallocate(this->data, this->bytes);
+        }
+    };
+
+    /**
+     *  \brief True if values of t are placed in a Value_Block. Over-aligned
+     *  types are allocated one by one.
+     */
+    static bool in_value_block(const Type_Descriptor * t) {
+        return t->align <= std::alignment_of<std::max_align_t>::value;
+    }
+
+    /**
+     *  \brief Reads one property written by write_snapshot_object. With a
+     *  null block, only checks it and adds the bytes its value needs in a
+     *  Value_Block to bytes.
+     */
+    static void read_snapshot_property(const char *&in, const char *end,
+            const std::vector<std::shared_ptr<Object> > &objects,
+            const std::vector<const Type_Descriptor *> &types,
+            const std::shared_ptr<Value_Block> &block, std::size_t &bytes,
+            std::string &name, Shared_Pointer_And_Type &slot) {
+        uint64_t length, tag;
+        if (!get_varint(in, end, length) || length > (uint64_t) (end - in))
+            corrupt_snapshot(__LINE__);
+        if (block != nullptr)
+            name.assign(in, (std::size_t) length);
+        in += length;
+        if (!get_varint(in, end, tag) || tag >= types.size() + 2)
+            corrupt_snapshot(__LINE__);
+        slot = Shared_Pointer_And_Type();
+        if (tag == snapshot_object) {
+            uint64_t n;
+            if (!get_varint(in, end, n) || n >= objects.size())
+                corrupt_snapshot(__LINE__);
+            slot = Shared_Pointer_And_Type(objects[n],
+                    Object::descriptor<Object>());
+            return;
+        }
+        if (tag == snapshot_empty)
+            return;
+        const Type_Descriptor * t = types[tag - 2];
+        if (!get_varint(in, end, length) || length > (uint64_t) (end - in))
+            corrupt_snapshot(__LINE__);
+        const char * value_end = in + length;
+        if (!in_value_block(t)) {
+            if (block != nullptr)
+                slot = Shared_Pointer_And_Type(t->deserialize(in, value_end), t);
+            else
+                in = value_end;
+            if (block != nullptr && slot.p == nullptr)
+                corrupt_snapshot(__LINE__);
+        } else {
+            bytes = (bytes + t->align - 1) / t->align * t->align;
+            if (block == nullptr) {
+                bytes += t->size;
+                in = value_end;
+                return;
+            }
+            void * to = block->data + bytes;
+            bytes += t->size;
+            if (!t->deserialize_into(to, in, value_end))
+                corrupt_snapshot(__LINE__);
+            block->values.push_back(std::make_pair(to, t));
+            slot = Shared_Pointer_And_Type(std::shared_ptr<void>(block, to), t);
+        }
+        if (in != value_end)
+            corrupt_snapshot(__LINE__);
+    }
+
+    /**
+     *  \brief Reads the parent and properties of o written by
+     *  write_snapshot_object. A first pass over the length-prefixed
+     *  properties sizes one Value_Block for all values and the property
+     *  table; the second constructs the values in place.
+     */
+    static void read_snapshot_object(Object &o, const char *&in,
+            const char *end, const std::vector<std::shared_ptr<Object> > &objects,
+            const std::vector<const Type_Descriptor *> &types) {
+        uint64_t parent, count;
+        if (!get_varint(in, end, parent) || parent > objects.size() ||
+                !get_varint(in, end, count) || count > (uint64_t) (end - in))
+            corrupt_snapshot(__LINE__);
+        if (parent != 0)
+            o.my_parent = objects[parent - 1].get();
+        std::string name;
+        Shared_Pointer_And_Type slot;
+        std::size_t bytes = 0;
+        const char * properties = in;
+        for (uint64_t i = 0; i < count; ++i)
+            read_snapshot_property(in, end, objects, types, nullptr, bytes,
+                name, slot);
+        std::shared_ptr<Value_Block> block = std::allocate_shared<Value_Block>
+                (Object::Allocator<Value_Block>(), bytes);
+        block->values.reserve((std::size_t) count);
+        o.my_contents.reserve((std::size_t) count);
+        in = properties;
+        bytes = 0;
+        for (uint64_t i = 0; i < count; ++i) {
+            read_snapshot_property(in, end, objects, types, block, bytes, name,
+                    slot);
+            if (slot.p != nullptr)
+                Object::call_slot_hook(slot.p, slot.t);
+            o.my_contents[std::move(name)] = slot;
+        }
+        ____OBJECT_COUNT(live_properties, (long long) o.my_contents.size());
+    }
 
 public:
 
+    /**  \brief A name and value pair, used to build an Object from an
+     *  initializer list: Object o = {{"x", 5}, {"y", 2.5}};
+     */
+    class Property {
+        friend class Object;
+        std::string name;
+        Shared_Pointer_And_Type slot;
+
+    public:
+
+        template <class Type> Property(const std::string &n, const Type &value)
+        : name(n), slot(Object::make_slot(value)) {
+        }
+    };
+
     /** 
      *  \brief Empty default constructor.
      */
-    Object() : my_contents(), execute_me(nullptr), my_parent(nullptr) {
+    Object() : my_contents(), execute_me(nullptr), my_parent(nullptr),
+    my_extension() {
+        ____OBJECT_COUNT(live_objects, 1);
     }
 
     /** 
      *  \brief Standard copy constructor.
      */
     Object(const Object &o) : my_contents(o.my_contents),
-    execute_me(o.execute_me), my_parent(o.my_parent) {
+    execute_me(o.execute_me), my_parent(o.my_parent),
+    my_extension(Object::copy_extension(o)) {
+        ____OBJECT_COUNT(live_objects, 1);
+        ____OBJECT_COUNT(live_properties, (long long) this->my_contents.size());
+    }
+
+    /**
+     *  \brief Builds an Object from name and value pairs. The hash table is
+     *  sized once for all of them. A repeated name keeps its last value.
+     */
+    Object(std::initializer_list<Property> properties) : my_contents(),
+    execute_me(nullptr), my_parent(nullptr), my_extension() {
+        ____OBJECT_COUNT(live_objects, 1);
+        this->my_contents.reserve(properties.size());
+        for (auto it = properties.begin(); it != properties.end(); ++it)
+            this->store(it->name, it->slot);
     }
 
     /** 
-     *  \brief Empty virtual destructor. To be overloaded by derived classes.
+     *  \brief Virtual destructor. To be overloaded by derived classes.
      */
     virtual ~Object() {
+        if (Object::change_hook() != nullptr)
+            this->call_change_hook(change_destroy, nullptr, nullptr,
+                nullptr);
+        ____OBJECT_COUNT(live_objects, -1);
+        ____OBJECT_COUNT(live_properties, -(long long) this->my_contents.size());
     }
 
     /**  \brief Sets the parent of this Object to another Object
      *  @param other_object - new parent
      */
     inline void setParent(Object &other_object) {
-        if (&other_object != this)
+        if (&other_object != this) {
+            if (Object::change_hook() != nullptr)
+                this->call_change_hook(change_parent, nullptr,
+                    &other_object, Object::descriptor<Object>());
             this->my_parent = &other_object;
-        else {
+        } else {
             printf("In Object.setParent, Object is not allowed to set its "
                     "parent pointer to itself.\n  "
                     "See line number %d in file %s\n\n", __LINE__, __FILE__);
@@ -122,62 +2561,401 @@ public:
         }
     }
 
+    /**  \brief Returns the parent of this Object, nullptr if it has none.
+     */
+    inline Object * getParent() const {
+        return this->my_parent;
+    }
+
+    /** 
+     *  \brief Standard assignment operator. Throws -1 if this object is
+     *  frozen. If other is frozen, so is this object afterwards.
+     */
+    Object& operator =(const Object &other) {
+        if (this != &other)
+            this->check_not_frozen("operator =", "");
+        if (Object::change_hook() != nullptr && this != &other) {
+            this->call_change_hook(change_contents, nullptr, &other,
+                    Object::descriptor<Object>());
+            this->call_change_hook(change_parent, nullptr,
+                    other.my_parent, Object::descriptor<Object>());
+        }
+        ____OBJECT_COUNT(live_properties, (long long) other.my_contents.size()
+                - (long long) this->my_contents.size());
+        this->my_contents = other.my_contents;
+        this->my_parent = other.my_parent;
+        this->execute_me = other.execute_me;
+        if (this == &other)
+            return *this;
+        std::unique_ptr<Extension> extension = Object::copy_extension(other);
+        if (this->version_table() != nullptr) {
+            if (extension == nullptr)
+                extension.reset(new Extension());
+            extension->versions.swap(this->my_extension->versions);
+            extension->versions->reset();
+        }
+        this->my_extension.swap(extension);
+        return *this;
+    }
+
+    /** 
+     *   \brief Passes hashtable contents from one Object to another.
+     *   Throws -1 if this object is frozen. If other is frozen, so is this
+     *   object afterwards.
+     */
+    inline void pass_contents(const Object &other) {
+        this->check_not_frozen("pass_contents", "");
+        if (Object::change_hook() != nullptr)
+            this->call_change_hook(change_contents, nullptr, &other,
+                Object::descriptor<Object>());
+        ____OBJECT_COUNT(live_properties, (long long) other.my_contents.size()
+                - (long long) this->my_contents.size());
+        this->my_contents = other.my_contents;
+        if (other.frozen_table() != nullptr)
+            this->extension().frozen = other.my_extension->frozen;
+        this->invalidate();
+        if (this->version_table() != nullptr)
+            this->my_extension->versions->reset();
+    }
+
+    /**
+     *  \brief Sets function pointer execute_me to the address of a static function. 
+     * @param function_pointer - a generic 64-bit function pointer
+     */
+    template <class Type> void setFunc(Type function_pointer) {
+        // Prevents the user from setting function pointer to an object
+        if (function_pointer != nullptr && (sizeof (function_pointer) ==
+                sizeof (this->execute_me))) {
+            this->execute_me = (pcast) function_pointer;
+            return;
+        } else {
+            printf("In Object.setFunc, function pointer is null or function "
+                    "cannot safely be assigned.\n  "
+                    "See line number %d in file %s\n\n", __LINE__, __FILE__);
+            //throw std::bad_function_call();
+            return;
+        }
+    }
+
+    /**
+     *  \brief Returns the slot of the method named name, giving the name
+     *  the next free slot the first time it is seen. Slots are small
+     *  integers shared by every Object in the process.
+     */
+    static std::size_t method_slot(const std::string &name) {
+        Method_Registry &registry = Object::method_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        auto pair = registry.slots.find(name);
+        if (pair != registry.slots.end())
+            return pair->second;
+        std::size_t slot = registry.names.size();
+        registry.slots[name] = slot;
+        registry.names.push_back(name);
+        return slot;
+    }
+
+    /**
+     *  \brief Returns the name that was given slot by method_slot.
+     */
+    static std::string method_name(std::size_t slot) {
+        Method_Registry &registry = Object::method_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        return slot < registry.names.size() ? registry.names[slot] : "";
+    }
+
+    /**
+     *  \brief Sets the method in slot to the address of a static function.
+     *  Objects whose parent tree reaches this object inherit the method.
+     *  Throws -1 if this object is frozen.
+     * @param slot - a slot from Object::method_slot
+     * @param function_pointer - a generic 64-bit function pointer
+     */
+    template <class Type> void setMethod(std::size_t slot,
+            Type function_pointer) {
+        this->check_not_frozen("setMethod", Object::method_name(slot));
+        if (function_pointer == nullptr || (sizeof (function_pointer) !=
+                sizeof (pcast))) {
+            printf("In Object.setMethod, function pointer is null or function "
+                    "cannot safely be assigned.\n  "
+                    "See line number %d in file %s\n\n", __LINE__, __FILE__);
+            return;
+        }
+        std::shared_ptr<std::vector<pcast> > &methods = this->extension().methods;
+        if (methods == nullptr)
+            methods = std::make_shared<std::vector<pcast> >();
+        else if (methods.use_count() > 1)
+            methods = std::make_shared<std::vector<pcast> >(*methods);
+        if (methods->size() <= slot)
+            methods->resize(slot + 1, nullptr);
+        (*methods)[slot] = (pcast) function_pointer;
+    }
+
+    /**
+     *  \brief Sets the method named name, see Object::setMethod.
+     *  @return the method's slot, for Object::invoke
+     */
+    template <class Type> std::size_t setMethod(const std::string &name,
+            Type function_pointer) {
+        std::size_t slot = Object::method_slot(name);
+        this->setMethod(slot, function_pointer);
+        return slot;
+    }
+
+    /**
+     *  \brief Checks to see if this object or its parent tree has a method
+     *  in slot.
+     */
+    bool hasMethod(std::size_t slot) const {
+        for (const Object * o = this; o != nullptr; o = o->my_parent) {
+            const std::vector<pcast> * methods = o->method_table();
+            if (methods != nullptr && slot < methods->size() &&
+                    (*methods)[slot] != nullptr)
+                return true;
+        }
+        return false;
+    }
+
+    /**
+     * Add a single object property to the properties hash table with key 
+     * string::name and generic value. 
+     * Will leak memory if you pass in new int[] allocate array.
+     * @param name - name that will be used to retrieve value
+     * @param value - a generic value to be added
+     */
+    template <class Type> void set(const std::string &name, const Type &value) {
+        this->store(name, Object::make_slot(value));
+        return;
+    }
+
+    /**
+     * \brief set, except that a value equal to one already set with
+     * set_interned, by any Object, is shared instead of copied. Meant for
+     * large values repeated over many Objects, such as strings, vectors and
+     * lookup tables. Values are not modified once set, so sharing them is
+     * safe. Type needs operator == and std::hash or a hash given to
+     * Object::register_hash, otherwise throws -1. The shared value is freed
+     * with the last property holding it.
+     * @param name - name that will be used to retrieve value
+     * @param value - a value to be added, or shared
+     */
+    template <class Type> void set_interned(const std::string &name,
+            const Type &value) {
+        this->store(name, Object::intern_slot(name, value));
+    }
+
+    /**
+     * \brief How much set_interned shared, over the whole process.
+     */
+    static Intern_Statistics intern_statistics() {
+        Intern_Table &table = Object::intern_table();
+        Intern_Statistics s = {
+            table.calls.load(std::memory_order_relaxed),
+            table.hits.load(std::memory_order_relaxed),
+            table.bytes_saved.load(std::memory_order_relaxed), 0
+        };
+        for (std::size_t i = 0; i < 64; ++i) {
+            Intern_Table::Stripe &stripe = table.stripes[i];
+            std::lock_guard<std::mutex> lock(stripe.mutex);
+            for (auto it = stripe.entries.begin(); it != stripe.entries.end();
+                    ++it)
+                if (!it->second.value.expired())
+                    s.size += 1;
+        }
+        return s;
+    }
+
+    /**
+     * \brief Adds a property whose value is built by factory() the first
+     * time it is read through get<Type>, has<Type>, hasOwnProperty<Type>,
+     * exec or lexec, from this object or from a child. The value is then
+     * kept in place. Concurrent first reads build it exactly once; the
+     * other readers wait for it. If factory throws, the exception reaches
+     * the reader and the next read tries again. Copies of this object
+     * share the property and its value. has and hasOwnProperty without a
+     * type do not build the value.
+     * @param name - name that will be used to retrieve value
+     * @param factory - function taking no arguments that returns a Type.
+     * It must not read this property itself.
+     */
+    template <class Type, class Factory> void set_lazy(const std::string &name,
+            Factory factory) {
+        std::function<Shared_Pointer_And_Type()> build = [factory]() {
+            return Object::make_slot<Type>(factory());
+        };
+        this->store(name, Shared_Pointer_And_Type(std::static_pointer_cast<void>
+                (std::allocate_shared<Lazy_Cell>(Object::Allocator<Lazy_Cell>(),
+                build)), Object::descriptor<Lazy_Cell>()));
+    }
     /** 
-     *  \brief Standard assignment operator
+     *  \brief Alias for Object.set
+     */
+    template <typename... Args>
+    auto add(Args&&... args) -> decltype(set(std::forward<Args>(args)...)) {
+        return set(std::forward<Args>(args)...);
+    }
+
+    /**
+     * \brief Removes the property name from this object. The parent tree is
+     * not affected.
+     * @param name - name of the property to remove
+     * @return true if this object had the property
+     */
+    bool remove(const std::string &name) {
+        this->check_not_frozen("remove", name);
+        if (Object::change_hook() != nullptr &&
+                this->my_contents.count(name) != 0)
+            this->call_change_hook(change_remove, &name, nullptr, nullptr);
+        if (this->my_contents.erase(name) == 0)
+            return false;
+        ____OBJECT_COUNT(live_properties, -1);
+        if (this->my_extension != nullptr)
+            this->extension_changed(name, true);
+        return true;
+    }
+
+    /**
+     * \brief Removes every property of this object. The bucket array is kept,
+     * call shrink_to_fit to release it.
+     */
+    void clear() {
+        this->check_not_frozen("clear", "");
+        if (Object::change_hook() != nullptr)
+            this->call_change_hook(change_clear, nullptr, nullptr,
+                nullptr);
+        ____OBJECT_COUNT(live_properties, -(long long) this->my_contents.size());
+        this->my_contents.clear();
+        this->invalidate();
+        if (this->version_table() != nullptr)
+            this->my_extension->versions->reset();
+    }
+
+    /**
+     * \brief Caches the results of exec and lexec calls of function_name on
+     * this object, keyed on the hash of their arguments. Use it for pure
+     * functions only. The cache holds up to capacity results and drops the
+     * least recently used one when full. It is emptied when function_name
+     * or one of the dependencies is set or removed on this object, and by
+     * Object::invalidate. Changes to the parent tree are not tracked.
+     * Calls are cached only if their arguments have a std::hash and an
+     * operator == and their result is copyable and not void.
+     * exec and lexec may use the cache from many threads, as on a frozen
+     * object or through exec_async, parallel_exec and Actor. Call memoize
+     * and unmemoize before the object is shared between threads.
+     * @param dependencies - names of the properties the results depend on
+     */
+    void memoize(const std::string &function_name, std::size_t capacity = 256,
+            const std::vector<std::string> &dependencies =
+            std::vector<std::string>()) {
+        std::unique_ptr<Memo_Table> &memo = this->extension().memo;
+        if (memo == nullptr)
+            memo.reset(new Memo_Table());
+        memo->erase(function_name);
+        memo->insert(std::make_pair(function_name,
+                Memo_Function(capacity, dependencies)));
+    }
+
+    /**
+     * \brief Stops caching function_name and drops its results.
+     */
+    void unmemoize(const std::string &function_name) {
+        Memo_Table * memo = this->memo_table();
+        if (memo != nullptr)
+            memo->erase(function_name);
+    }
+
+    /**
+     * \brief Drops the cached results of function_name.
+     */
+    void invalidate(const std::string &function_name) {
+        Memo_Function * m = this->find_memo(function_name);
+        if (m != nullptr)
+            m->invalidate();
+    }
+
+    /**
+     * \brief Drops every cached result of this object.
+     */
+    void invalidate() {
+        Memo_Table * memo = this->memo_table();
+        if (memo == nullptr)
+            return;
+        for (auto it = memo->begin(); it != memo->end(); ++it)
+            it->second.invalidate();
+    }
+
+    /**
+     * \brief Hit, miss and eviction counts of function_name's cache. All
+     * zero if function_name is not memoized.
+     */
+    Memo_Statistics memo_statistics(const std::string &function_name) {
+        Memo_Function * m = this->find_memo(function_name);
+        if (m == nullptr)
+            return Memo_Statistics();
+        std::lock_guard<std::mutex> lock(m->mutex);
+        return m->statistics;
+    }
+
+    /**
+     *  \brief True if the results of function_name are cached, see
+     *  Object::memoize.
+     */
+    bool isMemoized(const std::string &function_name) const {
+        const Memo_Table * memo = this->memo_table();
+        return memo != nullptr && memo->count(function_name) != 0;
+    }
+
+    /**
+     * \brief Sizes the hash table for n properties so adding them does not
+     * rehash.
      */
-    Object& operator =(const Object &other) {
-        this->my_contents = other.my_contents;
-        this->my_parent = other.my_parent;
-        this->execute_me = other.execute_me;
-        return *this;
+    void reserve(std::size_t n) {
+        this->my_contents.reserve(n);
     }
 
-    /** 
-     *   \brief Passes hashtable contents from one Object to another
+    /**
+     * \brief Rebuilds the hash table with the fewest buckets that hold the
+     * current properties, releasing memory left over from a past peak.
      */
-    inline void pass_contents(const Object &other) {
-        this->my_contents = other.my_contents;
+    void shrink_to_fit() {
+        Contents compacted;
+        compacted.reserve(this->my_contents.size());
+        for (auto it = this->my_contents.begin();
+                it != this->my_contents.end(); ++it)
+            compacted.insert(std::move(*it));
+        this->my_contents.swap(compacted);
     }
 
     /**
-     *  \brief Sets function pointer execute_me to the address of a static function. 
-     * @param function_pointer - a generic 64-bit function pointer
+     * \brief Moves the properties of this object into an immutable table
+     * indexed by a minimal perfect hash. Afterwards get, has and exec find a
+     * property of this object with a single probe, and set, remove, clear
+     * and pass_contents throw -1. A frozen object that is not otherwise
+     * modified may be read from many threads without synchronization.
+     * Freezing a frozen object does nothing.
      */
-    template <class Type> void setFunc(Type function_pointer) {
-        // Prevents the user from setting function pointer to an object
-        if (function_pointer != nullptr && (sizeof (function_pointer) ==
-                sizeof (this->execute_me))) {
-            this->execute_me = (pcast) function_pointer;
-            return;
-        } else {
-            printf("In Object.setFunc, function pointer is null or function "
-                    "cannot safely be assigned.\n  "
-                    "See line number %d in file %s\n\n", __LINE__, __FILE__);
-            //throw std::bad_function_call();
+    void freeze() {
+        if (this->frozen_table() != nullptr)
             return;
+        std::shared_ptr<Frozen_Table> table = std::make_shared<Frozen_Table>();
+        if (!table->build(this->my_contents)) {
+            printf("In Object.freeze, two property names have the same hash "
+                    "and cannot be frozen.\n  See line number %d in file %s\n\n",
+                    __LINE__, __FILE__);
+            throw -1;
         }
+        if (Object::change_hook() != nullptr)
+            this->call_change_hook(change_freeze, nullptr, nullptr,
+                nullptr);
+        ____OBJECT_COUNT(live_properties, -(long long) this->my_contents.size());
+        Contents().swap(this->my_contents);
+        this->extension().frozen = table;
     }
 
     /**
-     * Add a single object property to the properties hash table with key 
-     * string::name and generic value. 
-     * Will leak memory if you pass in new int[] allocate array.
-     * @param name - name that will be used to retrieve value
-     * @param value - a generic value to be added
-     */
-    template <class Type> void set(const std::string &name, const Type &value) {
-        std::shared_ptr<Type> shared_pointer = std::make_shared<Type>(value);
-        Shared_Pointer_And_Type temp(std::static_pointer_cast<void>
-                (shared_pointer), std::type_index(typeid (value)));
-        this->my_contents[name] = temp;
-        return;
-    }
-    /** 
-     *  \brief Alias for Object.set
+     *  \brief True after Object::freeze.
      */
-    template <typename... Args>
-    auto add(Args&&... args) -> decltype(set(std::forward<Args>(args)...)) {
-        return set(std::forward<Args>(args)...);
+    bool isFrozen() const {
+        return this->frozen_table() != nullptr;
     }
 
     /**
@@ -211,7 +2989,27 @@ public:
      * object somewhere in its parent tree.
      */
     bool hasOwnProperty(const std::string &name) {
-        return this->my_contents.count(name);
+        return this->find_slot(name) != nullptr;
+    }
+
+    /**
+     * \brief Lists the properties of this object (not of its parent tree)
+     * that hold an Object or a subclass of Object, in no particular order.
+     * Lazy properties are listed once they are built.
+     */
+    std::vector<Object *> getOwnObjects() const {
+        std::vector<std::pair<const std::string *,
+                const Shared_Pointer_And_Type *> > slots;
+        this->for_each_slot(Slot_Collector(slots));
+        std::vector<Object *> objects;
+        for (std::size_t i = 0; i < slots.size(); ++i) {
+            const Shared_Pointer_And_Type * spt = slots[i].second;
+            if (spt->t != nullptr && spt->t->is_lazy)
+                spt = static_cast<const Lazy_Cell *> (spt->p.get())->built();
+            if (spt != nullptr && spt->t != nullptr && spt->t->is_object)
+                objects.push_back(static_cast<Object *> (spt->p.get()));
+        }
+        return objects;
     }
 
     /**
@@ -224,10 +3022,9 @@ public:
      * object somewhere in its parent tree.
      */
     template <class Element_Type> bool has(const std::string &name) {
-        auto pair = this->my_contents.find(name);
-        if (pair != this->my_contents.end()) {
-            Object::Shared_Pointer_And_Type spt = pair->second;
-            if (spt.t == std::type_index(typeid (Element_Type)))
+        const Shared_Pointer_And_Type * found = this->find_own(name);
+        if (found != nullptr) {
+            if (found->t == Object::descriptor<Element_Type>())
                 return true;
             else
                 return false;
@@ -248,10 +3045,9 @@ public:
      * object somewhere in its parent tree.
      */
     template <class Element_Type> bool hasOwnProperty(const std::string &name) {
-        auto pair = this->my_contents.find(name);
-        if (pair != this->my_contents.end()) {
-            Object::Shared_Pointer_And_Type spt = pair->second;
-            if (spt.t == std::type_index(typeid (Element_Type)))
+        const Shared_Pointer_And_Type * found = this->find_own(name);
+        if (found != nullptr) {
+            if (found->t == Object::descriptor<Element_Type>())
                 return true;
             else
                 return false;
@@ -260,6 +3056,472 @@ public:
         }
     }
 
+    /**
+     * \brief Reports the bytes used by this Object, by category.
+     * @param deep - also count the contents of Objects stored as properties.
+     * A nested Object reachable through several properties is counted once.
+     * @return byte counts, see Object::Memory_Usage
+     */
+    Memory_Usage memory_usage(bool deep = true) const {
+        Memory_Usage usage = Memory_Usage();
+        usage.header = sizeof (*this);
+        std::unordered_set<const void *> visited;
+        visited.insert(this);
+        this->add_memory_usage(usage, deep, visited);
+        return usage;
+    }
+
+    /**
+     * \brief Writes this object to out as a compact binary snapshot, with
+     * every Object reachable from it through properties and parents. An
+     * Object reached several times is written once and referred to by
+     * number. Values must be of types given to Object::register_type (the
+     * built-in ones included) that can be serialized. Lazy values are
+     * built. Function pointers, methods and memoize settings are not saved;
+     * set them again after Object::load.
+     * Throws -1 if a value cannot be saved or out fails.
+     */
+    void save(std::ostream &out) const {
+        Object::write_snapshot(Snapshot_Index(*this), out);
+    }
+
+    /**
+     * \brief Reads a snapshot written by Object::save from in.
+     * The snapshot is read in one block, every property table is sized once
+     * and the values of each Object are placed in one allocation, which is
+     * freed when the last of them is replaced or destroyed. Objects saved because they were parents, but not held by a
+     * property, are kept alive by the returned pointer.
+     * Throws -1 if the snapshot is corrupt, was written on a machine of
+     * another byte order, or holds a type that is not registered.
+     * @return the saved Object
+     */
+    static std::shared_ptr<Object> load(std::istream &in) {
+        std::vector<std::shared_ptr<Object> > objects;
+        std::vector<const Type_Descriptor *> types;
+        return Object::read_snapshot(in, objects, types);
+    }
+
+    /**
+     * \brief Keeps a version for every property of this object from now
+     * on, so that Object::diff against a replica patched by Object::apply
+     * only visits the properties changed since. Costs one hash table
+     * update per set or remove. Copies of this object do not keep versions.
+     */
+    void track_versions() {
+        std::unique_ptr<Version_Table> &versions = this->extension().versions;
+        if (versions == nullptr)
+            versions.reset(new Version_Table());
+    }
+
+    /**
+     *  \brief Number of changes since Object::track_versions, 0 if versions
+     *  are not kept.
+     */
+    uint64_t version() const {
+        const Version_Table * v = this->version_table();
+        return v == nullptr ? 0 : v->version;
+    }
+
+    /**
+     * \brief Returns the changes that turn the properties of base into the
+     * properties of this object: the added and changed properties with
+     * their values, encoded as by Object::save, and the names of the
+     * removed ones. Parents are not compared.
+     * If this object keeps versions and base was last patched from it by
+     * Object::apply, only the properties changed since are visited.
+     * Otherwise every property of both is compared, with the equality of
+     * registered types where they have one.
+     * Objects held as values are compared by address and sent whole, as
+     * by Object::save. So a full diff always resends them, since the
+     * Objects of a replica are its own copies, and an incremental diff
+     * misses changes made inside them, which do not change the versions
+     * of this object; set the property again to send such a change.
+     * Throws -1 if a changed value cannot be saved.
+     * @return the delta, for base.apply
+     */
+    std::string diff(const Object &base) const {
+        std::vector<std::pair<const std::string *,
+                const Shared_Pointer_And_Type *> > changes;
+        const Version_Table * v = this->version_table();
+        const Version_Table * b = base.version_table();
+        uint64_t from = 0;
+        if (v != nullptr && b != nullptr && b->source == v->id &&
+                b->source_version >= v->floor &&
+                b->source_version <= v->version) {
+            from = b->source_version;
+            for (const Version_Table::Entry * e = v->newest; e != nullptr &&
+                    e->second.version > from; e = e->second.older)
+                changes.push_back(std::make_pair(&e->first, e->second.removed ?
+                        nullptr : this->find_own(e->first)));
+        } else {
+            std::vector<std::pair<const std::string *,
+                    const Shared_Pointer_And_Type *> > slots;
+            this->for_each_slot(Slot_Collector(slots));
+            for (std::size_t i = 0; i < slots.size(); ++i) {
+                const Shared_Pointer_And_Type * mine =
+                        Object::built_slot(slots[i].second);
+                if (!Object::same_value(mine, base.find_own(*slots[i].first)))
+                    changes.push_back(std::make_pair(slots[i].first, mine));
+            }
+            slots.clear();
+            base.for_each_slot(Slot_Collector(slots));
+            for (std::size_t i = 0; i < slots.size(); ++i) {
+                if (this->find_slot(*slots[i].first) == nullptr)
+                    changes.push_back(std::make_pair(slots[i].first,
+                        (const Shared_Pointer_And_Type *) nullptr));
+            }
+        }
+        return Object::encode_delta(changes, v == nullptr ? 0 : v->id, from,
+                v == nullptr ? 0 : v->version);
+    }
+
+    /**
+     * \brief Sets and removes the properties in a delta returned by
+     * Object::diff. The delta is checked and decoded before this object is
+     * changed, and if a change throws, as a Change_Hook may, the changes
+     * made before it are undone, so that this object is patched entirely
+     * or not at all. Afterwards this object keeps versions, and remembers
+     * the version it matches, so that the next diff against it is
+     * incremental.
+     * Throws -1 if the delta is corrupt, holds a type that is not
+     * registered, was computed against another version of this object,
+     * or if this object is frozen.
+     */
+    void apply(const std::string &delta) {
+        const char * p = delta.data();
+        const char * end = p + delta.size();
+        uint64_t id, from, to, type_count, count;
+        if (delta.size() < 1 + sizeof (id) ||
+                (unsigned char) *p != delta_version)
+            corrupt_delta(__LINE__);
+        std::copy(p + 1, p + 1 + sizeof (id), reinterpret_cast<char *> (&id));
+        p += 1 + sizeof (id);
+        if (!get_varint(p, end, from) || !get_varint(p, end, to) ||
+                !get_varint(p, end, type_count) ||
+                type_count > (uint64_t) (end - p) / sizeof (uint64_t))
+            corrupt_delta(__LINE__);
+        std::vector<const Type_Descriptor *> types((std::size_t) type_count);
+        for (std::size_t i = 0; i < types.size(); ++i) {
+            uint64_t type;
+            std::copy(p, p + sizeof (type), reinterpret_cast<char *> (&type));
+            p += sizeof (type);
+            types[i] = Object::find_type(type);
+            if (types[i] == nullptr || types[i]->deserialize == nullptr) {
+                printf("In Object.apply, the delta holds a value of type id "
+                        "%llu, which is not registered.\n  "
+                        "See line number %d in file %s\n\n",
+                        (unsigned long long) type, __LINE__, __FILE__);
+                throw -1;
+            }
+        }
+        if (!get_varint(p, end, count) || count > (uint64_t) (end - p))
+            corrupt_delta(__LINE__);
+        std::vector<std::pair<std::string, Shared_Pointer_And_Type> >
+                changes((std::size_t) count);
+        std::vector<bool> removed((std::size_t) count);
+        for (std::size_t i = 0; i < changes.size(); ++i)
+            removed[i] = Object::read_delta_property(p, end, types,
+                changes[i].first, changes[i].second);
+        if (p != end)
+            corrupt_delta(__LINE__);
+        Version_Table * v = this->version_table();
+        if (from != 0 && (v == nullptr || v->source != id ||
+                v->source_version != from)) {
+            printf("In Object.apply, the delta was computed against another "
+                    "version of this object.\n  "
+                    "See line number %d in file %s\n\n", __LINE__, __FILE__);
+            throw -1;
+        }
+        this->check_not_frozen("apply", "");
+        // The slots the changes replace, put back if one of them throws.
+        std::vector<Shared_Pointer_And_Type> before(changes.size());
+        std::vector<bool> present(changes.size());
+        for (std::size_t i = 0; i < changes.size(); ++i) {
+            const Shared_Pointer_And_Type * slot =
+                    this->find_slot(changes[i].first);
+            present[i] = slot != nullptr;
+            if (slot != nullptr)
+                before[i] = *slot;
+        }
+        this->track_versions();
+        v = this->version_table();
+        v->applying = true;
+        std::size_t done = 0;
+        try {
+            for (; done < changes.size(); ++done) {
+                if (removed[done])
+                    this->remove(changes[done].first);
+                else
+                    this->store(changes[done].first, changes[done].second);
+            }
+        } catch (...) {
+            for (std::size_t i = done + 1; i-- > 0;) {
+                try {
+                    if (present[i])
+                        this->store(changes[i].first, before[i]);
+                    else
+                        this->remove(changes[i].first);
+                } catch (...) {
+                }
+            }
+            v->applying = false;
+            v->source = 0;
+            throw;
+        }
+        v->applying = false;
+        v->source = id;
+        v->source_version = to;
+    }
+
+private:
+
+    /**  \brief Delta format written by Object::diff: the format version,
+     *  the id of the Object it was computed on as 8 bytes, the versions it
+     *  goes from and to, the value types as in a snapshot, then for every
+     *  change a name, a tag and the length-prefixed value. from is 0 when
+     *  every property was compared.
+     */
+    static const unsigned char delta_version = 1;
+    /** tags before the type numbers */
+    static const uint64_t delta_removed = 0;
+    static const uint64_t delta_empty = 1;
+    static const uint64_t delta_object = 2;
+
+    static void corrupt_delta(int line) {
+        printf("In Object.apply, the delta is truncated or corrupt.\n  "
+                "See line number %d in file %s\n\n", line, __FILE__);
+        throw -1;
+    }
+
+    /**
+     *  \brief True if a and b hold the same value: the same pointer, or
+     *  equal values of a type with an equality.
+     */
+    static bool same_value(const Shared_Pointer_And_Type * a,
+            const Shared_Pointer_And_Type * b) {
+        if (a == nullptr || b == nullptr)
+            return a == b;
+        if (a->p == b->p)
+            return true;
+        return a->p != nullptr && b->p != nullptr && a->t == b->t &&
+                a->t->equal != nullptr && a->t->equal(a->p.get(), b->p.get());
+    }
+
+    /**
+     *  \brief Encodes changes, where a null slot is a removed property, as
+     *  described at delta_version. An Object value is written as a snapshot.
+     */
+    static std::string encode_delta(const std::vector<std::pair<const
+            std::string *, const Shared_Pointer_And_Type *> > &changes,
+            uint64_t id, uint64_t from, uint64_t to) {
+        std::vector<const Type_Descriptor *> types;
+        std::unordered_map<const Type_Descriptor *, uint64_t> numbers;
+        for (std::size_t i = 0; i < changes.size(); ++i) {
+            const Shared_Pointer_And_Type * slot = changes[i].second;
+            if (slot == nullptr || slot->p == nullptr || slot->t == nullptr ||
+                    slot->t == Object::descriptor<Object>() ||
+                    numbers.find(slot->t) != numbers.end())
+                continue;
+            if (Object::registered_id(slot->t) == 0 ||
+                    slot->t->serialize == nullptr || slot->t->is_object) {
+                printf("In Object.diff, property \"%s\" holds a type that is "
+                        "not registered or cannot be serialized.\n  "
+                        "See line number %d in file %s\n\n",
+                        changes[i].first->c_str(), __LINE__, __FILE__);
+                throw -1;
+            }
+            numbers[slot->t] = types.size();
+            types.push_back(slot->t);
+        }
+        std::string out(1, (char) delta_version);
+        out.append(reinterpret_cast<const char *> (&id), sizeof (id));
+        put_varint(out, from);
+        put_varint(out, to);
+        put_varint(out, types.size());
+        for (std::size_t i = 0; i < types.size(); ++i)
+            out.append(reinterpret_cast<const char *> (&types[i]->id),
+                sizeof (uint64_t));
+        put_varint(out, changes.size());
+        std::string value;
+        for (std::size_t i = 0; i < changes.size(); ++i) {
+            const Shared_Pointer_And_Type * slot = changes[i].second;
+            put_varint(out, changes[i].first->size());
+            out.append(*changes[i].first);
+            value.clear();
+            if (slot == nullptr) {
+                put_varint(out, delta_removed);
+                continue;
+            } else if (slot->p == nullptr || slot->t == nullptr) {
+                put_varint(out, delta_empty);
+                continue;
+            } else if (slot->t == Object::descriptor<Object>()) {
+                put_varint(out, delta_object);
+                std::ostringstream snapshot;
+                static_cast<const Object *> (slot->p.get())->save(snapshot);
+                value = snapshot.str();
+            } else {
+                put_varint(out, numbers.find(slot->t)->second + 3);
+                slot->t->serialize(slot->p.get(), value);
+            }
+            put_varint(out, value.size());
+            out.append(value);
+        }
+        return out;
+    }
+
+    /**
+     *  \brief Reads one change written by encode_delta.
+     *  @return true if the property is removed
+     */
+    static bool read_delta_property(const char *&in, const char *end,
+            const std::vector<const Type_Descriptor *> &types,
+            std::string &name, Shared_Pointer_And_Type &slot) {
+        uint64_t length, tag;
+        if (!get_varint(in, end, length) || length > (uint64_t) (end - in))
+            corrupt_delta(__LINE__);
+        name.assign(in, (std::size_t) length);
+        in += length;
+        if (!get_varint(in, end, tag) || tag >= types.size() + 3)
+            corrupt_delta(__LINE__);
+        if (tag == delta_removed || tag == delta_empty)
+            return tag == delta_removed;
+        if (!get_varint(in, end, length) || length > (uint64_t) (end - in))
+            corrupt_delta(__LINE__);
+        const char * value_end = in + length;
+        if (tag == delta_object) {
+            std::istringstream snapshot(std::string(in, (std::size_t) length));
+            slot = Shared_Pointer_And_Type(std::static_pointer_cast<void>
+                    (Object::load(snapshot)), Object::descriptor<Object>());
+            in = value_end;
+        } else {
+            const Type_Descriptor * t = types[tag - 3];
+            slot = Shared_Pointer_And_Type(t->deserialize(in, value_end), t);
+            if (slot.p == nullptr || in != value_end)
+                corrupt_delta(__LINE__);
+        }
+        Object::call_slot_hook(slot.p, slot.t);
+        return false;
+    }
+
+    /**
+     * \brief Writes the Objects of index to out, as Object::save.
+     */
+    static void write_snapshot(const Snapshot_Index &index, std::ostream &out) {
+        std::string objects;
+        for (std::size_t i = 0; i < index.objects.size(); ++i)
+            Object::write_snapshot_object(*index.objects[i], index, objects);
+        Object::write_snapshot(index,
+                std::vector<const std::string *>(1, &objects), out);
+    }
+
+    /**
+     * \brief Writes a snapshot of the Objects of index to out, where the
+     * Objects written by write_snapshot_object, in the order of their
+     * numbers, are the concatenation of parts.
+     */
+    template <class Index> static void write_snapshot(const Index &index,
+            const std::vector<const std::string *> &parts, std::ostream &out) {
+        std::string payload;
+        put_varint(payload, index.objects.size());
+        payload.append(index.flags.begin(), index.flags.end());
+        put_varint(payload, index.types.size());
+        for (std::size_t i = 0; i < index.types.size(); ++i)
+            payload.append(reinterpret_cast<const char *>
+                (&index.types[i]->id), sizeof (uint64_t));
+        uint32_t words[3] = {snapshot_magic, snapshot_version,
+            snapshot_byte_order};
+        uint64_t length = payload.size();
+        for (std::size_t i = 0; i < parts.size(); ++i)
+            length += parts[i]->size();
+        char header[snapshot_header_bytes];
+        std::copy(reinterpret_cast<const char *> (words),
+                reinterpret_cast<const char *> (words) + 12, header);
+        std::copy(reinterpret_cast<const char *> (&length),
+                reinterpret_cast<const char *> (&length) + 8, header + 12);
+        out.write(header, sizeof (header));
+        out.write(payload.data(), (std::streamsize) payload.size());
+        for (std::size_t i = 0; i < parts.size(); ++i)
+            out.write(parts[i]->data(), (std::streamsize) parts[i]->size());
+        if (!out) {
+            printf("In Object.save, the snapshot could not be written.\n  "
+                    "See line number %d in file %s\n\n", __LINE__, __FILE__);
+            throw -1;
+        }
+    }
+
+    /**
+     * \brief Reads a snapshot as Object::load. objects and types are set to
+     * the Objects and value types of the snapshot, in the order of their
+     * numbers.
+     */
+    static std::shared_ptr<Object> read_snapshot(std::istream &in,
+            std::vector<std::shared_ptr<Object> > &objects,
+            std::vector<const Type_Descriptor *> &types) {
+        char header[snapshot_header_bytes];
+        if (!in.read(header, sizeof (header)))
+            corrupt_snapshot(__LINE__);
+        uint32_t magic, version, byte_order;
+        uint64_t length;
+        std::copy(header, header + 4, reinterpret_cast<char *> (&magic));
+        std::copy(header + 4, header + 8, reinterpret_cast<char *> (&version));
+        std::copy(header + 8, header + 12, reinterpret_cast<char *> (&byte_order));
+        std::copy(header + 12, header + 20, reinterpret_cast<char *> (&length));
+        if (magic != snapshot_magic || version != snapshot_version ||
+                byte_order != snapshot_byte_order) {
+            printf("In Object.load, the stream is not a snapshot of this "
+                    "version and byte order.\n  See line number %d in file %s\n\n",
+                    __LINE__, __FILE__);
+            throw -1;
+        }
+        std::string payload;
+        if (!read_snapshot_payload(in, length, payload))
+            corrupt_snapshot(__LINE__);
+        const char * p = payload.data();
+        const char * end = p + payload.size();
+        uint64_t object_count, type_count;
+        if (!get_varint(p, end, object_count) || object_count == 0 ||
+                object_count > (uint64_t) (end - p))
+            corrupt_snapshot(__LINE__);
+        const char * flags = p;
+        p += object_count;
+        if (!get_varint(p, end, type_count) ||
+                type_count > (uint64_t) (end - p) / sizeof (uint64_t))
+            corrupt_snapshot(__LINE__);
+        types.assign((std::size_t) type_count, nullptr);
+        for (std::size_t i = 0; i < types.size(); ++i) {
+            uint64_t id;
+            std::copy(p, p + sizeof (id), reinterpret_cast<char *> (&id));
+            p += sizeof (id);
+            types[i] = Object::find_type(id);
+            if (types[i] == nullptr || types[i]->deserialize_into == nullptr) {
+                printf("In Object.load, the snapshot holds a value of type "
+                        "id %llu, which is not registered.\n  "
+                        "See line number %d in file %s\n\n",
+                        (unsigned long long) id, __LINE__, __FILE__);
+                throw -1;
+            }
+        }
+        objects.assign((std::size_t) object_count, std::shared_ptr<Object>());
+        std::shared_ptr<std::vector<std::shared_ptr<Object> > > roots =
+                std::make_shared<std::vector<std::shared_ptr<Object> > >();
+        for (std::size_t i = 0; i < objects.size(); ++i) {
+            objects[i] = std::allocate_shared<Object>(Object::Allocator<Object>());
+            if (i == 0 || !(flags[i] & snapshot_owned))
+                roots->push_back(objects[i]);
+        }
+        for (std::size_t i = 0; i < objects.size(); ++i)
+            Object::read_snapshot_object(*objects[i], p, end, objects, types);
+        if (p != end)
+            corrupt_snapshot(__LINE__);
+        for (std::size_t i = 0; i < objects.size(); ++i) {
+            if (flags[i] & snapshot_frozen)
+                objects[i]->freeze();
+        }
+        return std::shared_ptr<Object>(roots, objects[0].get());
+    }
+
+public:
+
     /**
      * \brief Retrieves an element from this object with non-void return type
      * Throws -1 when name cannot be found
@@ -268,12 +3530,11 @@ public:
      * angle brackets
      */
     template <class Return_Type> Return_Type get(const std::string &name) {
-        auto pair = this->my_contents.find(name);
+        const Shared_Pointer_And_Type * found = this->find_own(name);
         // If the element exists, get it.
-        if (pair != this->my_contents.end()) {
-            Shared_Pointer_And_Type spt = pair->second;
-            if (spt.t == std::type_index(typeid (Return_Type))) {
-                return *(std::static_pointer_cast<Return_Type>(spt.p));
+        if (found != nullptr) {
+            if (found->t == Object::descriptor<Return_Type>()) {
+                return *static_cast<const Return_Type *> (found->p.get());
             } else {
                 printf("In Object.get<class Return_Type>(\"%s\"), "
                         "template Return_Type "
@@ -297,135 +3558,309 @@ public:
     }
 
     /**
-     * \brief Directly calls the generic function pointer execute_me if the return 
-     * type is void.
-     * Throws bad function call if pointer is null. Will leaks memory if used 
-     * with a non-void  function.
-     * @param Parameters - generic list of function parameters
+     * \brief Directly calls the generic function pointer execute_me contained within 
+     * this object, or in its parent tree if this object has none.
+     * For a non-void Return_Type the function must return a pointer to a heap
+     * allocated Return_Type, which is copied and freed. With the default void
+     * Return_Type the result is discarded, so a non-void function will leak
+     * memory. Throws -1 if no function pointer can be found.
+     * @param Parameters - generic list of comma delimited function parameters
+     * @return Return_Type - generic return type - specified in <>, void if omitted
      */
-    template <class ...A> void call(A... Parameters) {
+    template <class Return_Type = void, class ...A>
+    Return_Type call(A... Parameters) {
         if (this->execute_me != nullptr) {
-            (this->execute_me(Parameters...));
-            return;
+            return Returned<Return_Type>::take
+                    (this->execute_me(Parameters...));
         } else if (this->my_parent != nullptr) {
-            this->my_parent->call(Parameters...);
-            return;
+            return this->my_parent->call<Return_Type>(Parameters...);
         } else {
             printf("In Object.call, function pointer passed to call is nullptr"
                     ".\n  See line number %d in file %s\n\n", __LINE__, __FILE__);
             throw -1; //dereferencing a null pointer is a serious problem.
-            return;
         }
     }
 
     /**
-     * \brief Directly calls the generic function pointer execute_me contained within 
-     * this object if the return type is non-void
-     * Throws bad function call if pointer is null
-     * @param Parameters - generic list of generic list of comma delimited 
-     * function parameters
-     * @return Return_Type - generic return type - must be specified in <>
+     * \brief Calls the method in slot of this object, or of the nearest
+     * object in its parent tree that has one. Each step is an array index,
+     * with no hashing. Same return conventions as Object::call.
+     * Throws -1 if no object in the parent tree has a method in slot.
+     * @param slot - a slot from Object::method_slot or Object::setMethod
+     * @param Parameters - generic list of function parameters
+     * @return Return_Type - generic return type - specified in <>, void if omitted
      */
-    template <class Return_Type, class ...A> Return_Type call(A... Parameters) {
-        if (this->execute_me != nullptr) {
-            Return_Type * rptr = reinterpret_cast<Return_Type *>
-                    (this->execute_me(Parameters...));
-            Return_Type ret = *rptr; // copy contents of hash table
-            delete rptr;
-            return ret; // return the copy.
-        } else if (this->my_parent != nullptr) {
-            return this->my_parent->call<Return_Type>(Parameters...);
-        } else {
-            printf("In Object.call<class Return_Type>, function pointer passed"
-                    " to call is nullptr.\n  See line number %d in file %s\n\n",
-                    __LINE__, __FILE__);
-            throw -1;
+    template <class Return_Type = void, class ...A>
+    Return_Type invoke(std::size_t slot, A... Parameters) {
+        for (Object * o = this; o != nullptr; o = o->my_parent) {
+            const std::vector<pcast> * methods = o->method_table();
+            if (methods != nullptr && slot < methods->size()) {
+                pcast method = (*methods)[slot];
+                if (method != nullptr)
+                    return Returned<Return_Type>::take(method(Parameters...));
+            }
         }
+        printf("In Object.invoke, method slot %d (\"%s\") is not set in this "
+                "object or its parent tree.\n  See line number %d in file %s\n\n",
+                (int) slot, Object::method_name(slot).c_str(), __LINE__, __FILE__);
+        throw -1;
+    }
+
+    /**
+     * \brief Calls the method named function_name, see Object::invoke.
+     * Costs one look-up in the method registry; keep the slot to avoid it.
+     */
+    template <class Return_Type = void, class ...A>
+    Return_Type invoke(const std::string &function_name, A... Parameters) {
+        return this->invoke<Return_Type>(Object::method_slot(function_name),
+                Parameters...);
     }
 
     /**
-     * \brief Executes a function with no return type by its function name 
+     * \brief Executes a function by its function name. The name must refer to
+     * an Object (or subclass of Object) whose call function is performed.
      * @param function_name - the key name of the function as a std::string
      * @param Parameters - generic list of function parameters
+     * @return Return_Type - generic return type - specified in <>, void if omitted
      */
-    template<class ...A> void exec
+    template<class Return_Type = void, class ...A> Return_Type exec
     (const std::string &function_name, A... Parameters) {
-        auto pair = this->my_contents.find(function_name);
-        if (pair != this->my_contents.end()) {
-            Object::Shared_Pointer_And_Type spt =
-                    pair->second;
-            std::shared_ptr<Object> isObject = std::static_pointer_cast<Object>
-                    (spt.p);
-            if (isObject->my_type == ____OBJECT_TYPE) {
-                // Call the corresponding function
-                isObject->call(Parameters...);
-                return;
+        Memo_Function * m = this->find_memo(function_name);
+        if (m != nullptr)
+            return Memoized<Cacheable<Return_Type, A...>::value>::template
+                    get<Return_Type>(*m, [&]() {
+                return this->exec_uncached<Return_Type>(function_name,
+                        Parameters...);
+            }, Parameters...);
+        return this->exec_uncached<Return_Type>(function_name, Parameters...);
+    }
+
+private:
 
+    template<class Return_Type, class ...A> Return_Type exec_uncached
+    (const std::string &function_name, A... Parameters) {
+        const Shared_Pointer_And_Type * found = this->find_own(function_name);
+        if (found != nullptr) {
+            const Object::Shared_Pointer_And_Type &spt = *found;
+            if (spt.t != nullptr && spt.t->is_object) {
+                //  Calls the corresponding function.
+                return static_cast<Object *> (spt.p.get())->call<Return_Type>
+                        (Parameters...);
             } else {
                 printf("Object.exec(\"%s\") does not "
                         "reference a callable Object.\n "
                         " See line number %d in file %s\n\n",
                         function_name.c_str(), __LINE__, __FILE__);
                 throw -1;
-                return;
             }
         } else {
             // Check my_parent.
-            if (this->my_parent != nullptr) {
-                this->my_parent->exec(function_name, Parameters...);
-                return;
-            }// Give up.
+            if (this->my_parent != nullptr)
+                return this->my_parent->exec<Return_Type>
+                    (function_name, Parameters...);
+                // Give up.
             else {
                 printf("Function pointer named \"%s\" referenced by "
                         "Object.exec cannot be found.\n  "
                         "See line number %d in file %s\n\n",
                         function_name.c_str(), __LINE__, __FILE__);
                 throw -1;
-                return;
             }
         }
     }
 
+public:
+
     /**
-     * \brief Executes a value-returning function by its function name 
-     * @param function_name - the key name of the function as a std::string
-     * @param Parameters - generic list of function parameters
-     * @return Return_Type - generic return type - must be specified in <>
+     * \brief Finds the Object whose call function exec(function_name, ...)
+     * would perform, without calling it.
+     * Throws -1 if function_name names a property that is not an Object.
+     * @param inherited - false to only search this object's own properties
+     * @return the callable Object, nullptr if function_name cannot be found
      */
-    template<class Return_Type, class ...A> Return_Type exec
-    (const std::string &function_name, A... Parameters) {
-        auto pair = this->my_contents.find(function_name);
-        if (pair != this->my_contents.end()) {
-            Object::Shared_Pointer_And_Type spt =
-                    pair->second;
-            std::shared_ptr<Object> isObject = std::static_pointer_cast<Object>
-                    (spt.p);
-            if (isObject->my_type == ____OBJECT_TYPE) {
-                //  Calls the corresponding function.
-                return isObject->call<Return_Type>(Parameters...);
-            } else {
-                printf("Object.exec<class Return_Type>(\"%s\") does not "
-                        "reference a callable Object.\n "
-                        " See line number %d in file %s\n\n",
-                        function_name.c_str(), __LINE__, __FILE__);
-                throw -1;
-            }
+    Object * findCallable(const std::string &function_name,
+            bool inherited = true) const {
+        const Shared_Pointer_And_Type * found = this->find_own(function_name);
+        if (found != nullptr) {
+            if (found->t != nullptr && found->t->is_object)
+                return static_cast<Object *> (found->p.get());
+            printf("Object.findCallable(\"%s\") does not "
+                    "reference a callable Object.\n "
+                    " See line number %d in file %s\n\n",
+                    function_name.c_str(), __LINE__, __FILE__);
+            throw -1;
+        }
+        if (inherited && this->my_parent != nullptr)
+            return this->my_parent->findCallable(function_name);
+        return nullptr;
+    }
 
-        } else {
-            // Check my_parent.
-            if (this->my_parent != nullptr)
-                return this->my_parent->exec<Return_Type>
-                    (function_name, Parameters...);
-                // Give up.
-            else {
-                printf("Function pointer named \"%s\" referenced by "
-                        "Object.exec<class Return_Type> cannot be found.\n  "
-                        "See line number %d in file %s\n\n",
+    /**
+     * \brief Finds the Object whose memo exec(function_name, ...) goes
+     * through: this object or the first one up the parent tree that
+     * memoizes function_name, up to the one that holds function_name.
+     * @return nullptr if such calls are not memoized
+     */
+    Object * findMemoized(const std::string &function_name) {
+        for (Object * o = this; o != nullptr; o = o->my_parent) {
+            if (o->find_memo(function_name) != nullptr)
+                return o;
+            if (o->find_own(function_name) != nullptr)
+                return nullptr;
+        }
+        return nullptr;
+    }
+
+    /**
+     * \brief Sets a kernel that exec_batch runs instead of calling this
+     * Object once per argument tuple, for example a vectorized loop. The
+     * kernel is used when exec_batch's argument and result types match its
+     * own exactly. It is kept next to the methods, not as a property, and
+     * copies of this Object share it. Throws -1 if this object is frozen.
+     * @param kernel - computes results[i] from arguments[i] for i < count
+     */
+    template <class Return_Type, class ...A> void setBatchFunc
+    (void (*kernel)(const std::tuple<A...> *arguments, std::size_t count,
+            Return_Type *results)) {
+        typedef void (*Kernel)(const std::tuple<A...> *, std::size_t,
+                Return_Type *);
+        this->check_not_frozen("setBatchFunc", "");
+        Extension &e = this->extension();
+        e.batch = reinterpret_cast<void (*)()> (kernel);
+        e.batch_type = kernel == nullptr ? nullptr
+                : Object::descriptor<Kernel>();
+    }
+
+    /**
+     * \brief Performs exec(function_name, arguments[i]...) for every i below
+     * count and stores the results in results[i]. The callable Object is
+     * found once. If it has a batch kernel for these types, see
+     * Object::setBatchFunc, the kernel does the whole batch in one call.
+     * If the call is memoized, see Object::findMemoized, every tuple goes
+     * through the memo as with exec instead, and the kernel is not used.
+     * Throws -1 like exec when function_name cannot be found.
+     * @param arguments - count tuples of function parameters
+     * @param results - room for count results, nullptr for void
+     */
+    template <class Return_Type, class ...A> void exec_batch
+    (const std::string &function_name, const std::tuple<A...> *arguments,
+            std::size_t count, Return_Type *results) {
+        Object * callable = this->findCallable(function_name);
+        if (callable == nullptr) {
+            printf("Function pointer named \"%s\" referenced by "
+                    "Object.exec_batch cannot be found.\n  "
+                    "See line number %d in file %s\n\n",
+                    function_name.c_str(), __LINE__, __FILE__);
+            throw -1;
+        }
+        Object * memoized = this->findMemoized(function_name);
+        if (memoized != nullptr) {
+            Batch_Loop<Return_Type>::exec_each(*memoized, function_name,
+                    arguments, count, results);
+            return;
+        }
+        typedef void (*Kernel)(const std::tuple<A...> *, std::size_t,
+                Return_Type *);
+        const Extension * e = callable->my_extension.get();
+        if (e != nullptr && e->batch != nullptr &&
+                e->batch_type == Object::descriptor<Kernel>()) {
+            reinterpret_cast<Kernel> (e->batch)(arguments, count, results);
+            return;
+        }
+        Batch_Loop<Return_Type>::exec(*callable, arguments, count, results);
+    }
+
+    /**
+     * \brief exec_batch for functions without results.
+     */
+    template <class ...A> void exec_batch(const std::string &function_name,
+            const std::tuple<A...> *arguments, std::size_t count) {
+        this->exec_batch<void>(function_name, arguments, count,
+                static_cast<void *> (nullptr));
+    }
+
+    /**
+     * \brief exec_batch over a vector of argument tuples. results is resized
+     * to one result per tuple.
+     */
+    template <class Return_Type, class ...A> void exec_batch
+    (const std::string &function_name,
+            const std::vector<std::tuple<A...> > &arguments,
+            std::vector<Return_Type> &results) {
+        results.resize(arguments.size());
+        this->exec_batch(function_name, arguments.data(), arguments.size(),
+                results.data());
+    }
+
+    /**
+     * \brief exec_batch over a vector of argument tuples, without results.
+     */
+    template <class ...A> void exec_batch(const std::string &function_name,
+            const std::vector<std::tuple<A...> > &arguments) {
+        this->exec_batch(function_name, arguments.data(), arguments.size());
+    }
+
+    /**
+     * \brief Performs lexec<Standard_Function>(function_name,
+     * arguments[i]...) for every i below count and stores the results in
+     * results[i]. The standard function is found and type checked once and
+     * is not copied. If the call is memoized, see Object::findMemoized,
+     * every tuple goes through the memo as with lexec instead.
+     * Throws -1 like lexec when it cannot be found or has another type.
+     * @param results - room for count results, nullptr for void
+     */
+    template <class Standard_Function, class Return_Type, class ...A>
+    void lexec_batch(const std::string &function_name,
+            const std::tuple<A...> *arguments, std::size_t count,
+            Return_Type *results) {
+        Object * memoized = this->findMemoized(function_name);
+        if (memoized != nullptr) {
+            Batch_Loop<Return_Type>::template lexec_each<Standard_Function>
+                    (*memoized, function_name, arguments, count, results);
+            return;
+        }
+        for (Object * o = this; o != nullptr; o = o->my_parent) {
+            const Shared_Pointer_And_Type * found = o->find_own(function_name);
+            if (found == nullptr)
+                continue;
+            if (found->t != Object::descriptor<Standard_Function>()) {
+                printf("Wrong standard function class referenced by "
+                        "Object.lexec_batch<class Standard_Function>(\"%s\")."
+                        "\n  See line number %d in file %s\n\n",
                         function_name.c_str(), __LINE__, __FILE__);
-                //throw oor;
                 throw -1;
             }
+            Batch_Loop<Return_Type>::lexec(*static_cast<const Standard_Function *>
+                    (found->p.get()), arguments, count, results);
+            return;
         }
+        printf("In Object.lexec_batch, std::function \"%s\" "
+                "could not be found.\n  See line number %d in file %s\n\n",
+                function_name.c_str(), __LINE__, __FILE__);
+        throw -1;
+    }
+
+    /**
+     * \brief lexec_batch for functions without results.
+     */
+    template <class Standard_Function, class ...A> void lexec_batch
+    (const std::string &function_name, const std::tuple<A...> *arguments,
+            std::size_t count) {
+        this->lexec_batch<Standard_Function, void>(function_name, arguments,
+                count, static_cast<void *> (nullptr));
+    }
+
+    /**
+     * \brief lexec_batch over a vector of argument tuples. results is
+     * resized to one result per tuple.
+     */
+    template <class Standard_Function, class Return_Type, class ...A>
+    void lexec_batch(const std::string &function_name,
+            const std::vector<std::tuple<A...> > &arguments,
+            std::vector<Return_Type> &results) {
+        results.resize(arguments.size());
+        this->lexec_batch<Standard_Function>(function_name, arguments.data(),
+                arguments.size(), results.data());
     }
 
     /**
@@ -439,10 +3874,26 @@ public:
      */
     template<class Standard_Function, class Return_Type = void, class ...A>
     Return_Type lexec(const std::string &function_name, A... Parameters) {
-        auto pair = this->my_contents.find(function_name);
-        if (pair != this->my_contents.end()) {
-            Object::Shared_Pointer_And_Type spt = pair->second;
-            if (std::type_index(typeid (Standard_Function)) == spt.t) {
+        Memo_Function * m = this->find_memo(function_name);
+        if (m != nullptr)
+            return Memoized<Cacheable<Return_Type, A...>::value>::template
+                    get<Return_Type>(*m, [&]() {
+                return this->lexec_uncached<Standard_Function, Return_Type>
+                        (function_name, Parameters...);
+            }, Parameters...);
+        return this->lexec_uncached<Standard_Function, Return_Type>
+                (function_name, Parameters...);
+    }
+
+private:
+
+    template<class Standard_Function, class Return_Type, class ...A>
+    Return_Type lexec_uncached(const std::string &function_name,
+            A... Parameters) {
+        const Shared_Pointer_And_Type * found = this->find_own(function_name);
+        if (found != nullptr) {
+            Object::Shared_Pointer_And_Type spt = *found;
+            if (Object::descriptor<Standard_Function>() == spt.t) {
                 Standard_Function isLambda =
                         *(std::static_pointer_cast<Standard_Function>(spt.p));
                 return isLambda(Parameters...);
@@ -467,4 +3918,8 @@ public:
         }
     }
 };
+
+template <> inline std::size_t Object::owned_bytes<std::string>(const void *p) {
+    return Object::string_bytes(*static_cast<const std::string *> (p));
+}
 #endif    // NETBEANSPROJECTS_MINIFIED_VERSION_4_PROTOTYPAL_CPP_H_
@@ -0,0 +1,557 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+/*
+ * File:   Read_Mostly_Object.h
+ * Created on October 18, 2026
+ */
+
+#ifndef PROTOTYPAL_C_READ_MOSTLY_OBJECT_H_
+#define PROTOTYPAL_C_READ_MOSTLY_OBJECT_H_
+
+#include "Prototypal_Cpp.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**  \brief Epoch based reclamation for Read_Mostly_Object tables.
+ *  A reader publishes the global epoch in its own cache line when it starts
+ *  reading and clears it when done. A writer retires a replaced table with
+ *  the epoch it was replaced in, and the table is freed once every active
+ *  reader started in a later epoch. Readers only write to their own record,
+ *  so reads scale with cores.
+ */
+class Epoch_Reclaimer {
+
+    /**  \brief Per-thread reader state, on its own cache line.
+     */
+    struct alignas(64) Record {
+        /** epoch the thread started reading in, 0 when not reading */
+        std::atomic<uint64_t> epoch;
+        std::atomic<bool> in_use;
+        Record * next;
+    };
+
+    /**  \brief A thread's record and how deeply its reads are nested.
+     *  Returns the record to the pool when the thread exits.
+     */
+    struct Local {
+        Record * record;
+        int depth;
+
+        Local() : record(nullptr), depth(0) {
+        }
+
+        ~Local() {
+            if (this->record != nullptr)
+                this->record->in_use.store(false, std::memory_order_release);
+        }
+    };
+
+    /**  \brief A replaced table waiting for its readers to finish.
+     */
+    struct Retired {
+        uint64_t epoch;
+        void * pointer;
+        void (*destroy)(void *);
+    };
+
+    std::atomic<uint64_t> my_epoch;
+    std::atomic<Record *> my_records;
+    std::mutex my_retired_mutex;
+    std::vector<Retired> my_retired;
+
+    Epoch_Reclaimer() : my_epoch(1), my_records(nullptr), my_retired_mutex(),
+    my_retired() {
+    }
+
+    ~Epoch_Reclaimer() {
+        for (std::size_t i = 0; i < this->my_retired.size(); ++i)
+            this->my_retired[i].destroy(this->my_retired[i].pointer);
+    }
+
+    /**
+     *  \brief Takes a free record or adds a new one to the list.
+     */
+    Record * acquire_record() {
+        for (Record * r = this->my_records.load(std::memory_order_acquire);
+                r != nullptr; r = r->next) {
+            bool expected = false;
+            if (!r->in_use.load(std::memory_order_relaxed) &&
+                    r->in_use.compare_exchange_strong(expected, true))
+                return r;
+        }
+        // Records live until exit. Over-allocate to align them by hand, since
+        // new only honors alignas(64) from C++17 on.
+        uintptr_t raw = reinterpret_cast<uintptr_t>
+                (::operator new(sizeof (Record) + 64));
+        Record * r = new (reinterpret_cast<void *> ((raw + 63) &
+                ~(uintptr_t) 63)) Record();
+        r->epoch.store(0, std::memory_order_relaxed);
+        r->in_use.store(true, std::memory_order_relaxed);
+        Record * head = this->my_records.load(std::memory_order_relaxed);
+        do {
+            r->next = head;
+        } while (!this->my_records.compare_exchange_weak(head, r,
+                std::memory_order_release, std::memory_order_relaxed));
+        return r;
+    }
+
+    static Local & local() {
+        static thread_local Local l;
+        return l;
+    }
+
+public:
+
+    /**
+     *  \brief The process-wide reclaimer.
+     */
+    static Epoch_Reclaimer & instance() {
+        static Epoch_Reclaimer reclaimer;
+        return reclaimer;
+    }
+
+    /**  \brief Marks the calling thread as reading for its lifetime.
+     *  Guards may be nested.
+     */
+    class Guard {
+        Local * my_local;
+
+    public:
+
+        Guard() : my_local(&Epoch_Reclaimer::local()) {
+            if (this->my_local->depth++ == 0) {
+                if (this->my_local->record == nullptr)
+                    this->my_local->record =
+                        Epoch_Reclaimer::instance().acquire_record();
+                this->my_local->record->epoch.store(Epoch_Reclaimer::instance()
+                        .my_epoch.load(std::memory_order_acquire),
+                        std::memory_order_relaxed);
+                // The epoch must be visible before any table is read.
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            }
+        }
+
+        ~Guard() {
+            if (--this->my_local->depth == 0)
+                this->my_local->record->epoch.store(0,
+                    std::memory_order_release);
+        }
+
+        Guard(const Guard &) = delete;
+        Guard& operator =(const Guard &) = delete;
+    };
+
+    /**
+     * \brief Frees pointer with destroy once no reader can still see it.
+     * Call after pointer has been unpublished.
+     */
+    void retire(void *pointer, void (*destroy)(void *)) {
+        Retired r = {
+            this->my_epoch.fetch_add(1, std::memory_order_seq_cst), pointer,
+            destroy
+        };
+        std::lock_guard<std::mutex> lock(this->my_retired_mutex);
+        this->my_retired.push_back(r);
+        this->reclaim_locked();
+    }
+
+    /**
+     *  \brief Frees every retired pointer that no reader can still see.
+     */
+    void reclaim() {
+        std::lock_guard<std::mutex> lock(this->my_retired_mutex);
+        this->reclaim_locked();
+    }
+
+    /**
+     *  \brief Number of retired pointers not yet freed.
+     */
+    std::size_t pending() {
+        std::lock_guard<std::mutex> lock(this->my_retired_mutex);
+        return this->my_retired.size();
+    }
+
+private:
+
+    void reclaim_locked() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        uint64_t oldest = this->my_epoch.load(std::memory_order_acquire);
+        for (Record * r = this->my_records.load(std::memory_order_acquire);
+                r != nullptr; r = r->next) {
+            uint64_t e = r->epoch.load(std::memory_order_acquire);
+            if (e != 0 && e < oldest)
+                oldest = e;
+        }
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < this->my_retired.size(); ++i) {
+            if (this->my_retired[i].epoch < oldest)
+                this->my_retired[i].destroy(this->my_retired[i].pointer);
+            else
+                this->my_retired[kept++] = this->my_retired[i];
+        }
+        this->my_retired.resize(kept);
+    }
+};
+
+/**  \brief Object for prototypes that are read far more often than written.
+ *  Readers see an immutable property table published through an atomic
+ *  pointer. They take no lock, copy no shared pointer and write to no shared
+ *  cache line. Writers are serialized by a mutex, copy the table, change the
+ *  copy and publish it, so each write costs O(number of properties); use
+ *  update() to publish many changes at once. Replaced tables are freed by
+ *  the Epoch_Reclaimer.
+ */
+class Read_Mostly_Object {
+
+    /**  \brief A property value and the descriptor of its type.
+     */
+    struct Slot {
+        std::shared_ptr<void> p;
+        const Object::Type_Descriptor * t;
+    };
+
+    typedef std::unordered_map<std::string, Slot> Table;
+
+    std::atomic<const Table *> my_table;
+    std::atomic<pcast> execute_me;
+    std::atomic<Read_Mostly_Object *> my_parent;
+    std::mutex my_writer_mutex;
+
+    static void destroy_table(void *table) {
+        delete static_cast<const Table *> (table);
+    }
+
+    /**
+     *  \brief Publishes table and retires the one it replaces.
+     */
+    void publish(const Table *table) {
+        const Table * old = this->my_table.exchange(table,
+                std::memory_order_acq_rel);
+        Epoch_Reclaimer::instance().retire(const_cast<Table *> (old),
+                &Read_Mostly_Object::destroy_table);
+    }
+
+    /**
+     *  \brief The slot named name in this object, or nullptr. Call inside a
+     *  Guard; the slot stays valid until the Guard ends.
+     */
+    const Slot * find(const std::string &name) const {
+        const Table * table = this->my_table.load(std::memory_order_acquire);
+        auto pair = table->find(name);
+        return pair == table->end() ? nullptr : &pair->second;
+    }
+
+    template <class Return_Type, class Unused = void> struct Returned {
+
+        static Return_Type take(void *pointer) {
+            Return_Type * rptr = reinterpret_cast<Return_Type *> (pointer);
+            Return_Type ret = *rptr;
+            delete rptr;
+            return ret;
+        }
+    };
+
+    template <class Unused> struct Returned<void, Unused> {
+
+        static void take(void *) {
+        }
+    };
+
+public:
+
+    /**  \brief Changes collected by update() and published together.
+     */
+    class Transaction {
+        friend class Read_Mostly_Object;
+        Table * my_table;
+
+        explicit Transaction(Table *table) : my_table(table) {
+        }
+
+    public:
+
+        template <class Type> void set(const std::string &name,
+                const Type &value) {
+            Slot slot = {
+                std::static_pointer_cast<void>(std::allocate_shared<Type>
+                (Object::Allocator<Type>(), value)), Object::descriptor<Type>()
+            };
+            (*this->my_table)[name] = slot;
+        }
+
+        bool remove(const std::string &name) {
+            return this->my_table->erase(name) != 0;
+        }
+    };
+
+    /**
+     *  \brief Empty default constructor. Constructs the reclaimer first, so
+     *  that it outlives this object even at namespace scope: statics are
+     *  destroyed in the reverse order of their construction.
+     */
+    Read_Mostly_Object() : my_table(new Table()), execute_me(nullptr),
+    my_parent(nullptr), my_writer_mutex() {
+        Epoch_Reclaimer::instance();
+    }
+
+    Read_Mostly_Object(const Read_Mostly_Object &) = delete;
+    Read_Mostly_Object& operator =(const Read_Mostly_Object &) = delete;
+
+    /**
+     *  \brief Retires the current table. No reader may still use this object.
+     */
+    ~Read_Mostly_Object() {
+        Epoch_Reclaimer::instance().retire(const_cast<Table *>
+                (this->my_table.load()), &Read_Mostly_Object::destroy_table);
+    }
+
+    /**
+     * \brief Applies every change f makes to a Transaction, then publishes
+     * them all at once: readers see either none or all of them.
+     * @param f - called with a Transaction&
+     */
+    template <class Function> void update(Function f) {
+        std::lock_guard<std::mutex> lock(this->my_writer_mutex);
+        Table * copy = new Table(*this->my_table.load(std::memory_order_relaxed));
+        Transaction transaction(copy);
+        try {
+            f(transaction);
+        } catch (...) {
+            delete copy;
+            throw;
+        }
+        this->publish(copy);
+    }
+
+    /**
+     * \brief Adds or replaces the property name. Copies the whole table.
+     */
+    template <class Type> void set(const std::string &name, const Type &value) {
+        std::lock_guard<std::mutex> lock(this->my_writer_mutex);
+        Table * copy = new Table(*this->my_table.load(std::memory_order_relaxed));
+        Transaction(copy).set(name, value);
+        this->publish(copy);
+    }
+
+    /**
+     *  \brief Alias for Read_Mostly_Object.set
+     */
+    template <typename... Args>
+    auto add(Args&&... args) -> decltype(set(std::forward<Args>(args)...)) {
+        return set(std::forward<Args>(args)...);
+    }
+
+    /**
+     * \brief Removes the property name from this object.
+     * @return true if this object had the property
+     */
+    bool remove(const std::string &name) {
+        std::lock_guard<std::mutex> lock(this->my_writer_mutex);
+        const Table * current = this->my_table.load(std::memory_order_relaxed);
+        if (current->count(name) == 0)
+            return false;
+        Table * copy = new Table(*current);
+        copy->erase(name);
+        this->publish(copy);
+        return true;
+    }
+
+    /**  \brief Sets the parent of this object.
+     *  @param other_object - new parent
+     */
+    void setParent(Read_Mostly_Object &other_object) {
+        if (&other_object != this)
+            this->my_parent.store(&other_object, std::memory_order_release);
+        else {
+            printf("In Read_Mostly_Object.setParent, Read_Mostly_Object is not "
+                    "allowed to set its parent pointer to itself.\n  "
+                    "See line number %d in file %s\n\n", __LINE__, __FILE__);
+            return;
+        }
+    }
+
+    /**
+     *  \brief Sets function pointer execute_me to the address of a static function.
+     */
+    template <class Type> void setFunc(Type function_pointer) {
+        if (function_pointer != nullptr && (sizeof (function_pointer) ==
+                sizeof (pcast))) {
+            this->execute_me.store((pcast) function_pointer,
+                    std::memory_order_release);
+            return;
+        } else {
+            printf("In Read_Mostly_Object.setFunc, function pointer is null or "
+                    "function cannot safely be assigned.\n  "
+                    "See line number %d in file %s\n\n", __LINE__, __FILE__);
+            return;
+        }
+    }
+
+    /**
+     * \brief Checks to see if this object or its parent has a variable named
+     * name.
+     */
+    bool has(const std::string &name) const {
+        Epoch_Reclaimer::Guard guard;
+        for (const Read_Mostly_Object * o = this; o != nullptr;
+                o = o->my_parent.load(std::memory_order_acquire)) {
+            if (o->find(name) != nullptr)
+                return true;
+        }
+        return false;
+    }
+
+    /**
+     * \brief Checks to see if this object has a variable named name.
+     */
+    bool hasOwnProperty(const std::string &name) const {
+        Epoch_Reclaimer::Guard guard;
+        return this->find(name) != nullptr;
+    }
+
+    /**
+     * \brief Checks to see if this object or its parent has a variable named
+     * name of type Element_Type.
+     */
+    template <class Element_Type> bool has(const std::string &name) const {
+        Epoch_Reclaimer::Guard guard;
+        for (const Read_Mostly_Object * o = this; o != nullptr;
+                o = o->my_parent.load(std::memory_order_acquire)) {
+            const Slot * slot = o->find(name);
+            if (slot != nullptr)
+                return slot->t == Object::descriptor<Element_Type>();
+        }
+        return false;
+    }
+
+    /**
+     * \brief Checks to see if this object has a variable named name of type
+     * Element_Type.
+     */
+    template <class Element_Type> bool hasOwnProperty
+    (const std::string &name) const {
+        Epoch_Reclaimer::Guard guard;
+        const Slot * slot = this->find(name);
+        return slot != nullptr && slot->t == Object::descriptor<Element_Type>();
+    }
+
+    /**
+     * \brief Retrieves a copy of an element from this object or its parent
+     * tree. Throws -1 when name cannot be found or has another type.
+     */
+    template <class Return_Type> Return_Type get(const std::string &name) const {
+        Epoch_Reclaimer::Guard guard;
+        for (const Read_Mostly_Object * o = this; o != nullptr;
+                o = o->my_parent.load(std::memory_order_acquire)) {
+            const Slot * slot = o->find(name);
+            if (slot == nullptr)
+                continue;
+            if (slot->t == Object::descriptor<Return_Type>())
+                return *static_cast<const Return_Type *> (slot->p.get());
+            printf("In Read_Mostly_Object.get<class Return_Type>(\"%s\"), "
+                    "template Return_Type does not match up with a "
+                    "retrievable member's type.\n"
+                    "  See line number %d in file %s\n\n",
+                    name.c_str(), __LINE__, __FILE__);
+            throw -1;
+        }
+        printf("In Read_Mostly_Object.get<class Return_Type>(\"%s\"), "
+                "parameter \"%s\" does not correspond to a named "
+                "element.\n  See line number %d in file %s\n\n",
+                name.c_str(), name.c_str(), __LINE__, __FILE__);
+        throw -1;
+    }
+
+    /**
+     * \brief Directly calls the function pointer of this object, or of its
+     * parent tree. Same conventions as Object.call.
+     */
+    template <class Return_Type = void, class ...A>
+    Return_Type call(A... Parameters) {
+        for (Read_Mostly_Object * o = this; o != nullptr;
+                o = o->my_parent.load(std::memory_order_acquire)) {
+            pcast f = o->execute_me.load(std::memory_order_acquire);
+            if (f != nullptr)
+                return Returned<Return_Type>::take(f(Parameters...));
+        }
+        printf("In Read_Mostly_Object.call, function pointer passed to call is "
+                "nullptr.\n  See line number %d in file %s\n\n",
+                __LINE__, __FILE__);
+        throw -1;
+    }
+
+    /**
+     * \brief Executes a function by its function name. The name must refer to
+     * an Object whose call function is performed. The table holding the
+     * Object is kept alive for the duration of the call.
+     */
+    template<class Return_Type = void, class ...A> Return_Type exec
+    (const std::string &function_name, A... Parameters) {
+        Epoch_Reclaimer::Guard guard;
+        for (Read_Mostly_Object * o = this; o != nullptr;
+                o = o->my_parent.load(std::memory_order_acquire)) {
+            const Slot * slot = o->find(function_name);
+            if (slot == nullptr)
+                continue;
+            if (slot->t->is_object)
+                return static_cast<Object *> (slot->p.get())
+                ->call<Return_Type>(Parameters...);
+            printf("Read_Mostly_Object.exec(\"%s\") does not reference a "
+                    "callable Object.\n  See line number %d in file %s\n\n",
+                    function_name.c_str(), __LINE__, __FILE__);
+            throw -1;
+        }
+        printf("Function pointer named \"%s\" referenced by "
+                "Read_Mostly_Object.exec cannot be found.\n  "
+                "See line number %d in file %s\n\n",
+                function_name.c_str(), __LINE__, __FILE__);
+        throw -1;
+    }
+
+    /**
+     * \brief Executes a standard function by name. Same conventions as
+     * Object.lexec. The std::function is called in place, without a copy.
+     */
+    template<class Standard_Function, class Return_Type = void, class ...A>
+    Return_Type lexec(const std::string &function_name, A... Parameters) {
+        Epoch_Reclaimer::Guard guard;
+        for (Read_Mostly_Object * o = this; o != nullptr;
+                o = o->my_parent.load(std::memory_order_acquire)) {
+            const Slot * slot = o->find(function_name);
+            if (slot == nullptr)
+                continue;
+            if (slot->t == Object::descriptor<Standard_Function>())
+                return (*static_cast<const Standard_Function *> (slot->p.get()))
+                (Parameters...);
+            printf("Wrong standard function class referenced by "
+                    "Read_Mostly_Object.lexec<class Standard_Function>(\"%s\")."
+                    "\n  See line number %d in file %s\n\n",
+                    function_name.c_str(), __LINE__, __FILE__);
+            throw -1;
+        }
+        printf("In Read_Mostly_Object.lexec, std::function \"%s\" could not be "
+                "found.\n  See line number %d in file %s\n\n",
+                function_name.c_str(), __LINE__, __FILE__);
+        throw -1;
+    }
+};
+#endif    // PROTOTYPAL_C_READ_MOSTLY_OBJECT_H_
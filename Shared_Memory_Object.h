@@ -0,0 +1,664 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+/*
+ * File:   Shared_Memory_Object.h
+ * Created on October 18, 2026
+ */
+
+#ifndef PROTOTYPAL_C_SHARED_MEMORY_OBJECT_H_
+#define PROTOTYPAL_C_SHARED_MEMORY_OBJECT_H_
+
+#include "Prototypal_Cpp.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**  \brief Object whose properties live in a POSIX shared memory segment,
+ *  so that several processes read and update one physical copy.
+ *
+ *  Every Object of a segment is a hash table in the segment. Tables, names
+ *  and values refer to each other by offsets from the start of the segment,
+ *  which is mapped at a different address in each process, and are
+ *  allocated from size classes inside the segment. One process-shared
+ *  reader/writer lock guards the segment: reads take it shared, updates
+ *  take it exclusively, and an update is visible to every process as soon
+ *  as it returns.
+ *
+ *  Values must be of registered types that can be serialized, as for
+ *  Object::save, and get returns a copy. Nested Objects and parents are
+ *  other tables of the same segment. Tables are not freed when their
+ *  property is replaced or removed, since they may still be a parent.
+ *  A process that dies while updating leaves the lock held.
+ *  Views are cheap to copy and keep the mapping alive.
+ */
+class Shared_Memory_Object {
+
+    static const uint32_t segment_magic = 0x4f534350; // "PCSO"
+    static const uint32_t segment_version = 1;
+    static const uint32_t segment_byte_order = 0x01020304;
+    /** block sizes are 32 << class, the first 16 bytes hold the class */
+    static const std::size_t size_classes = 48;
+    static const uint64_t block_header = 16;
+    static const uint64_t empty_kind = 0;
+    static const uint64_t object_kind = 1;
+    static const uint64_t value_kind = 2;
+
+    /**  \brief Start of the segment.
+     */
+    struct Segment_Header {
+        std::atomic<uint32_t> magic;
+        uint32_t version;
+        uint32_t byte_order;
+        uint32_t unused;
+        uint64_t size;
+        /** first byte never allocated */
+        uint64_t top;
+        /** table of the first Object */
+        uint64_t root;
+        /** first free block of each size class, 0 for none */
+        uint64_t free_blocks[size_classes];
+        pthread_rwlock_t lock;
+    };
+
+    /**  \brief One Object: an open addressing table of capacity Slots.
+     */
+    struct Table {
+        /** offset of the parent's table, 0 for none */
+        uint64_t parent;
+        uint64_t count;
+        uint64_t capacity;
+        uint64_t slots;
+    };
+
+    struct Slot {
+        /** Object::type_id of the name with the low bit set, 0 if free */
+        uint64_t hash;
+        uint64_t name;
+        uint64_t name_length;
+        uint64_t kind;
+        /** registered id of the value's type */
+        uint64_t type;
+        /** offset of the serialized value, or of the nested table */
+        uint64_t value;
+        uint64_t value_length;
+    };
+
+    /**  \brief A mapping of the segment, unmapped with the last view of it.
+     */
+    struct Mapping {
+        char * base;
+        std::size_t size;
+
+        Mapping(char * b, std::size_t n) : base(b), size(n) {
+        }
+
+        Mapping(const Mapping &) = delete;
+        Mapping& operator =(const Mapping &) = delete;
+
+        ~Mapping() {
+            munmap(this->base, this->size);
+        }
+    };
+
+    struct Read_Lock {
+        pthread_rwlock_t &lock;
+
+        explicit Read_Lock(pthread_rwlock_t &l) : lock(l) {
+            pthread_rwlock_rdlock(&this->lock);
+        }
+
+        ~Read_Lock() {
+            pthread_rwlock_unlock(&this->lock);
+        }
+    };
+
+    struct Write_Lock {
+        pthread_rwlock_t &lock;
+
+        explicit Write_Lock(pthread_rwlock_t &l) : lock(l) {
+            pthread_rwlock_wrlock(&this->lock);
+        }
+
+        ~Write_Lock() {
+            pthread_rwlock_unlock(&this->lock);
+        }
+    };
+
+    std::shared_ptr<Mapping> my_mapping;
+    /** offset of this Object's table */
+    uint64_t my_table;
+
+    Shared_Memory_Object(const std::shared_ptr<Mapping> &mapping,
+            uint64_t table) : my_mapping(mapping), my_table(table) {
+    }
+
+    static void fail(const char *caller, const std::string &name,
+            const char *problem, int line) {
+        printf("In Shared_Memory_Object.%s(\"%s\"), %s.\n  "
+                "See line number %d in file %s\n\n",
+                caller, name.c_str(), problem, line, __FILE__);
+        throw -1;
+    }
+
+    Segment_Header & header() const {
+        return *reinterpret_cast<Segment_Header *> (this->my_mapping->base);
+    }
+
+    template <class Type> Type * at(uint64_t offset) const {
+        return reinterpret_cast<Type *> (this->my_mapping->base + offset);
+    }
+
+    static uint64_t hash_of(const std::string &name) {
+        return Object::type_id(name) | 1;
+    }
+
+    /**
+     *  \brief Allocates n bytes, 16-byte aligned, from the segment. The
+     *  write lock must be held. Throws -1 when the segment is full.
+     */
+    uint64_t allocate(uint64_t n) const {
+        Segment_Header &h = this->header();
+        std::size_t c = 0;
+        while (((uint64_t) 32 << c) < n + block_header)
+            ++c;
+        uint64_t block = c < size_classes ? h.free_blocks[c] : 0;
+        if (block != 0) {
+            h.free_blocks[c] = *this->at<uint64_t>(block + block_header);
+        } else {
+            uint64_t bytes = (uint64_t) 32 << c;
+            if (c >= size_classes || bytes > h.size - h.top)
+                fail("set", "", "the shared memory segment is full", __LINE__);
+            block = h.top;
+            h.top += bytes;
+            *this->at<uint64_t>(block) = c;
+        }
+        return block + block_header;
+    }
+
+    /**
+     *  \brief Returns a block of allocate to its size class. The write lock
+     *  must be held.
+     */
+    void deallocate(uint64_t offset) const {
+        if (offset == 0)
+            return;
+        Segment_Header &h = this->header();
+        uint64_t block = offset - block_header;
+        uint64_t c = *this->at<uint64_t>(block);
+        *this->at<uint64_t>(offset) = h.free_blocks[c];
+        h.free_blocks[c] = block;
+    }
+
+    uint64_t copy_in(const char * data, std::size_t n) const {
+        uint64_t offset = this->allocate(n);
+        std::copy(data, data + n, this->at<char>(offset));
+        return offset;
+    }
+
+    /**
+     *  \brief An empty table. The write lock must be held.
+     */
+    uint64_t new_table() const {
+        uint64_t t = this->allocate(sizeof (Table));
+        Table &table = *this->at<Table>(t);
+        table.parent = 0;
+        table.count = 0;
+        table.capacity = 8;
+        table.slots = this->allocate(8 * sizeof (Slot));
+        Slot * slots = this->at<Slot>(table.slots);
+        for (std::size_t i = 0; i < 8; ++i)
+            slots[i] = Slot();
+        return t;
+    }
+
+    /**
+     *  \brief The slot of name in table t, or the free slot where it
+     *  belongs.
+     */
+    Slot & probe(uint64_t t, const std::string &name, uint64_t hash) const {
+        const Table &table = *this->at<Table>(t);
+        Slot * slots = this->at<Slot>(table.slots);
+        uint64_t mask = table.capacity - 1;
+        for (uint64_t i = (hash >> 1) & mask;; i = (i + 1) & mask) {
+            Slot &s = slots[i];
+            if (s.hash == 0 || (s.hash == hash && s.name_length == name.size() &&
+                    name.compare(0, name.size(), this->at<char>(s.name),
+                    (std::size_t) s.name_length) == 0))
+                return s;
+        }
+    }
+
+    /**
+     *  \brief The slot of name in this Object or its parent tree, nullptr
+     *  if there is none. The lock must be held.
+     */
+    const Slot * find(const std::string &name, bool inherited) const {
+        uint64_t hash = hash_of(name);
+        for (uint64_t t = this->my_table; t != 0;
+                t = inherited ? this->at<Table>(t)->parent : 0) {
+            const Slot &s = this->probe(t, name, hash);
+            if (s.hash != 0)
+                return &s;
+        }
+        return nullptr;
+    }
+
+    /**
+     *  \brief Doubles the capacity of table t. The write lock must be held.
+     */
+    void grow(uint64_t t) const {
+        Table &table = *this->at<Table>(t);
+        uint64_t old_slots = table.slots;
+        uint64_t old_capacity = table.capacity;
+        uint64_t capacity = old_capacity * 2;
+        uint64_t slots_offset = this->allocate(capacity * sizeof (Slot));
+        Slot * slots = this->at<Slot>(slots_offset);
+        for (uint64_t i = 0; i < capacity; ++i)
+            slots[i] = Slot();
+        const Slot * old = this->at<Slot>(old_slots);
+        for (uint64_t i = 0; i < old_capacity; ++i) {
+            if (old[i].hash == 0)
+                continue;
+            uint64_t j = (old[i].hash >> 1) & (capacity - 1);
+            while (slots[j].hash != 0)
+                j = (j + 1) & (capacity - 1);
+            slots[j] = old[i];
+        }
+        table.slots = slots_offset;
+        table.capacity = capacity;
+        this->deallocate(old_slots);
+    }
+
+    /**
+     *  \brief Adds or replaces name in table t. The write lock must be held.
+     *  Everything is allocated before the slot is changed, and a new slot
+     *  is published by its hash last, so a full segment leaves the table
+     *  as it was.
+     */
+    void store(uint64_t t, const std::string &name, uint64_t kind,
+            uint64_t type, uint64_t value, uint64_t value_length) const {
+        uint64_t hash = hash_of(name);
+        Slot * s = &this->probe(t, name, hash);
+        if (s->hash == 0) {
+            Table &table = *this->at<Table>(t);
+            if ((table.count + 1) * 4 > table.capacity * 3) {
+                this->grow(t);
+                s = &this->probe(t, name, hash);
+            }
+            s->name = this->copy_in(name.data(), name.size());
+            s->name_length = name.size();
+            s->kind = kind;
+            s->type = type;
+            s->value = value;
+            s->value_length = value_length;
+            s->hash = hash;
+            ++this->at<Table>(t)->count;
+            return;
+        }
+        uint64_t old = s->kind == value_kind ? s->value : 0;
+        s->kind = kind;
+        s->type = type;
+        s->value = value;
+        s->value_length = value_length;
+        this->deallocate(old);
+    }
+
+    /**
+     *  \brief Copies bytes into the segment and stores them as the value
+     *  name of table t. The write lock must be held. Frees the copy if
+     *  the name cannot be stored.
+     */
+    void store_value(uint64_t t, const std::string &name, uint64_t type,
+            const std::string &bytes) const {
+        uint64_t offset = this->copy_in(bytes.data(), bytes.size());
+        try {
+            this->store(t, name, value_kind, type, offset, bytes.size());
+        } catch (int) {
+            this->deallocate(offset);
+            throw;
+        }
+    }
+
+    /**  \brief Copies a value of Type out of the segment.
+     */
+    template <class Type, bool Bytes = Object::Byte_Serial<Type>::value>
+    struct Value {
+
+        static Type read(const char * at, uint64_t length,
+                const std::string &name) {
+            if (length != sizeof (Type))
+                fail("get", name, "the segment is corrupt", __LINE__);
+            typename std::aligned_storage<sizeof (Type),
+                    std::alignment_of<Type>::value>::type value;
+            std::copy(at, at + sizeof (Type), reinterpret_cast<char *> (&value));
+            return *reinterpret_cast<const Type *> (&value);
+        }
+    };
+
+    template <class Type> struct Value<Type, false> {
+
+        static Type read(const char * at, uint64_t length,
+                const std::string &name) {
+            const char * end = at + length;
+            std::shared_ptr<void> value =
+                    Object::descriptor<Type>()->deserialize(at, end);
+            if (value == nullptr || at != end)
+                fail("get", name, "the segment is corrupt", __LINE__);
+            return *static_cast<const Type *> (value.get());
+        }
+    };
+
+    /**
+     *  \brief Serialized value of Type. Throws -1 if Type is not registered
+     *  or cannot be serialized.
+     */
+    template <class Type> static std::string serialize(const std::string &name,
+            const Type &value) {
+        const Object::Type_Descriptor * t = Object::descriptor<Type>();
+        if (Object::registered_id(t) == 0 || t->serialize == nullptr
+                || t->is_object)
+            fail("set", name, "the type is not registered or cannot be "
+                "serialized", __LINE__);
+        std::string bytes;
+        t->serialize(&value, bytes);
+        return bytes;
+    }
+
+public:
+
+    /**
+     *  \brief Creates the shared memory segment name of bytes bytes, for
+     *  example "/prototypes", and views its empty root Object.
+     *  Throws -1 if the segment exists or cannot be created.
+     */
+    Shared_Memory_Object(const std::string &name, std::size_t bytes)
+    : my_mapping(), my_table(0) {
+        if (bytes < sizeof (Segment_Header) + 4096)
+            bytes = sizeof (Segment_Header) + 4096;
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0)
+            fail("Shared_Memory_Object", name, "the segment cannot be created",
+                __LINE__);
+        void * base = MAP_FAILED;
+        if (ftruncate(fd, (off_t) bytes) == 0)
+            base = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (base == MAP_FAILED) {
+            shm_unlink(name.c_str());
+            fail("Shared_Memory_Object", name, "the segment cannot be mapped",
+                __LINE__);
+        }
+        this->my_mapping = std::make_shared<Mapping>(static_cast<char *> (base),
+                bytes);
+        Segment_Header &h = this->header();
+        h.version = segment_version;
+        h.byte_order = segment_byte_order;
+        h.size = bytes;
+        h.top = (sizeof (Segment_Header) + 15) / 16 * 16;
+        for (std::size_t i = 0; i < size_classes; ++i)
+            h.free_blocks[i] = 0;
+        pthread_rwlockattr_t attributes;
+        pthread_rwlockattr_init(&attributes);
+        pthread_rwlockattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+        pthread_rwlock_init(&h.lock, &attributes);
+        pthread_rwlockattr_destroy(&attributes);
+        h.root = this->new_table();
+        this->my_table = h.root;
+        h.magic.store(segment_magic, std::memory_order_release);
+    }
+
+    /**
+     *  \brief Maps the existing segment name and views its root Object.
+     *  Throws -1 if there is no such segment or it was not created by
+     *  Shared_Memory_Object.
+     */
+    explicit Shared_Memory_Object(const std::string &name) : my_mapping(),
+    my_table(0) {
+        int fd = shm_open(name.c_str(), O_RDWR, 0);
+        if (fd < 0)
+            fail("Shared_Memory_Object", name, "the segment cannot be opened",
+                __LINE__);
+        struct stat st;
+        void * base = MAP_FAILED;
+        if (fstat(fd, &st) == 0 && (std::size_t) st.st_size >= sizeof (Segment_Header))
+            base = mmap(nullptr, (std::size_t) st.st_size, PROT_READ | PROT_WRITE,
+                MAP_SHARED, fd, 0);
+        close(fd);
+        if (base == MAP_FAILED)
+            fail("Shared_Memory_Object", name, "the segment cannot be mapped",
+                __LINE__);
+        this->my_mapping = std::make_shared<Mapping>(static_cast<char *> (base),
+                (std::size_t) st.st_size);
+        Segment_Header &h = this->header();
+        if (h.magic.load(std::memory_order_acquire) != segment_magic ||
+                h.version != segment_version ||
+                h.byte_order != segment_byte_order ||
+                h.size != (uint64_t) st.st_size)
+            fail("Shared_Memory_Object", name, "the segment is not an "
+                "initialized Shared_Memory_Object", __LINE__);
+        this->my_table = h.root;
+    }
+
+    /**
+     *  \brief Removes the segment name. Processes that mapped it keep
+     *  their mapping.
+     */
+    static void unlink(const std::string &name) {
+        shm_unlink(name.c_str());
+    }
+
+    /**
+     *  \brief Adds or replaces the property name of this Object.
+     */
+    template <class Type> void set(const std::string &name, const Type &value) {
+        std::string bytes = serialize(name, value);
+        Write_Lock lock(this->header().lock);
+        this->store_value(this->my_table, name,
+                Object::registered_id(Object::descriptor<Type>()), bytes);
+    }
+
+    /**
+     *  \brief Adds or replaces the property name of this Object with a new,
+     *  empty Object of the segment.
+     *  @return the new Object
+     */
+    Shared_Memory_Object addObject(const std::string &name) {
+        Write_Lock lock(this->header().lock);
+        uint64_t t = this->new_table();
+        try {
+            this->store(this->my_table, name, object_kind, 0, t, 0);
+        } catch (int) {
+            this->deallocate(this->at<Table>(t)->slots);
+            this->deallocate(t);
+            throw;
+        }
+        return Shared_Memory_Object(this->my_mapping, t);
+    }
+
+    /**
+     *  \brief Copies the properties of o into this Object. Nested Objects
+     *  and parents of o, and theirs, become Objects of the segment; an
+     *  Object reached several times is copied once. Values must be of
+     *  registered types that can be serialized; lazy values are built.
+     *  Function pointers and methods are not copied.
+     */
+    void import_object(const Object &o) {
+        Object::Snapshot_Index index(o);
+        Write_Lock lock(this->header().lock);
+        std::vector<uint64_t> tables(index.objects.size());
+        tables[0] = this->my_table;
+        for (std::size_t i = 1; i < tables.size(); ++i)
+            tables[i] = this->new_table();
+        std::vector<std::pair<const std::string *,
+                const Object::Shared_Pointer_And_Type *> > slots;
+        std::string bytes;
+        for (std::size_t i = 0; i < tables.size(); ++i) {
+            const Object &from = *index.objects[i];
+            if (from.my_parent != nullptr)
+                this->at<Table>(tables[i])->parent =
+                    tables[index.object_numbers.find(from.my_parent)->second];
+            slots.clear();
+            from.for_each_slot(Object::Slot_Collector(slots));
+            for (std::size_t j = 0; j < slots.size(); ++j) {
+                const Object::Shared_Pointer_And_Type * slot =
+                        Object::built_slot(slots[j].second);
+                if (slot->p == nullptr || slot->t == nullptr)
+                    continue;
+                if (slot->t == Object::descriptor<Object>()) {
+                    this->store(tables[i], *slots[j].first, object_kind, 0,
+                            tables[index.object_numbers.find(static_cast<const
+                            Object *> (slot->p.get()))->second], 0);
+                } else {
+                    bytes.clear();
+                    slot->t->serialize(slot->p.get(), bytes);
+                    this->store_value(tables[i], *slots[j].first,
+                            slot->t->id, bytes);
+                }
+            }
+        }
+    }
+
+    /**
+     * \brief Returns a copy of the property name of type Type of this
+     * Object or its parent tree. Throws -1 if there is no such property or
+     * its type is not Type.
+     */
+    template <class Type> Type get(const std::string &name) const {
+        Read_Lock lock(this->header().lock);
+        const Slot * s = this->find(name, true);
+        if (s == nullptr)
+            fail("get", name, "there is no property of that name", __LINE__);
+        if (s->kind != value_kind ||
+                s->type != Object::registered_id(Object::descriptor<Type>()))
+            fail("get", name, "template Type does not match up with the "
+                "property's type", __LINE__);
+        return Value<Type>::read(this->at<char>(s->value), s->value_length, name);
+    }
+
+    /**
+     * \brief Returns the Object stored as the property name of this Object
+     * or its parent tree. Throws -1 if there is none.
+     */
+    Shared_Memory_Object getObject(const std::string &name) const {
+        Read_Lock lock(this->header().lock);
+        const Slot * s = this->find(name, true);
+        if (s == nullptr || s->kind != object_kind)
+            fail("getObject", name, "there is no Object of that name", __LINE__);
+        return Shared_Memory_Object(this->my_mapping, s->value);
+    }
+
+    bool has(const std::string &name) const {
+        Read_Lock lock(this->header().lock);
+        return this->find(name, true) != nullptr;
+    }
+
+    template <class Type> bool has(const std::string &name) const {
+        Read_Lock lock(this->header().lock);
+        const Slot * s = this->find(name, true);
+        return s != nullptr && s->kind == value_kind &&
+                s->type == Object::registered_id(Object::descriptor<Type>()) &&
+                s->type != 0;
+    }
+
+    bool hasOwnProperty(const std::string &name) const {
+        Read_Lock lock(this->header().lock);
+        return this->find(name, false) != nullptr;
+    }
+
+    /**
+     * \brief Removes the property name from this Object. The parent tree is
+     * not affected.
+     * @return true if this Object had the property
+     */
+    bool remove(const std::string &name) {
+        Write_Lock lock(this->header().lock);
+        Slot * s = &this->probe(this->my_table, name, hash_of(name));
+        if (s->hash == 0)
+            return false;
+        Table &table = *this->at<Table>(this->my_table);
+        Slot * slots = this->at<Slot>(table.slots);
+        uint64_t mask = table.capacity - 1;
+        this->deallocate(s->name);
+        if (s->kind == value_kind)
+            this->deallocate(s->value);
+        // Backward shift deletion keeps every probe sequence unbroken.
+        uint64_t hole = (uint64_t) (s - slots);
+        for (uint64_t i = (hole + 1) & mask; slots[i].hash != 0; i = (i + 1) & mask) {
+            uint64_t home = (slots[i].hash >> 1) & mask;
+            if (((i - home) & mask) >= ((i - hole) & mask)) {
+                slots[hole] = slots[i];
+                hole = i;
+            }
+        }
+        slots[hole] = Slot();
+        --table.count;
+        return true;
+    }
+
+    /**
+     * \brief Sets the parent of this Object to another Object of the same
+     * segment. Throws -1 for an Object of another segment or this Object.
+     */
+    void setParent(const Shared_Memory_Object &parent) {
+        if (parent.my_mapping->base != this->my_mapping->base ||
+                parent.my_table == this->my_table)
+            fail("setParent", "", "the parent must be another Object of the "
+                "same segment", __LINE__);
+        Write_Lock lock(this->header().lock);
+        this->at<Table>(this->my_table)->parent = parent.my_table;
+    }
+
+    bool hasParent() const {
+        Read_Lock lock(this->header().lock);
+        return this->at<Table>(this->my_table)->parent != 0;
+    }
+
+    /**
+     * \brief Returns the parent of this Object. Throws -1 if it has none.
+     */
+    Shared_Memory_Object getParent() const {
+        Read_Lock lock(this->header().lock);
+        uint64_t parent = this->at<Table>(this->my_table)->parent;
+        if (parent == 0)
+            fail("getParent", "", "the Object has no parent", __LINE__);
+        return Shared_Memory_Object(this->my_mapping, parent);
+    }
+
+    /**
+     *  \brief Number of own properties.
+     */
+    std::size_t size() const {
+        Read_Lock lock(this->header().lock);
+        return (std::size_t) this->at<Table>(this->my_table)->count;
+    }
+
+    /**
+     *  \brief Bytes of the segment in use.
+     */
+    std::size_t used() const {
+        Read_Lock lock(this->header().lock);
+        return (std::size_t) this->header().top;
+    }
+};
+#endif    // PROTOTYPAL_C_SHARED_MEMORY_OBJECT_H_
@@ -0,0 +1,267 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+/*
+ * File:   Thread_Pool.h
+ * Created on October 18, 2026
+ */
+
+#ifndef PROTOTYPAL_C_THREAD_POOL_H_
+#define PROTOTYPAL_C_THREAD_POOL_H_
+
+#include <stddef.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**  \brief Work-stealing thread pool.
+ *  Every worker has its own task queue. A worker runs its newest task first
+ *  and, when its queue is empty, steals the oldest task of another worker.
+ *  Tasks posted from outside the pool are spread over the queues in turn.
+ *  A thread waiting in parallel_for runs queued tasks itself, so
+ *  parallel_for may be called from inside a task.
+ */
+class Thread_Pool {
+
+    /**  \brief One worker's tasks.
+     */
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()> > tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue> > my_queues;
+    std::vector<std::thread> my_threads;
+    /**
+     *   \brief Tasks posted and not yet taken by a thread
+     */
+    std::atomic<size_t> my_queued;
+    std::atomic<size_t> my_next_queue;
+    std::atomic<bool> my_stopping;
+    std::mutex my_sleep_mutex;
+    std::condition_variable my_wake;
+
+    /**
+     *  \brief Index of the calling worker's queue in the pool it belongs to,
+     *  or -1 outside of any pool.
+     */
+    static int & worker_index() {
+        static thread_local int index = -1;
+        return index;
+    }
+
+    static Thread_Pool *& worker_pool() {
+        static thread_local Thread_Pool * pool = nullptr;
+        return pool;
+    }
+
+    /**
+     *  \brief Takes a task: the newest of queue first, then the oldest of
+     *  every other queue.
+     *  @return false if every queue is empty
+     */
+    bool take(size_t first, std::function<void()> &task) {
+        const size_t n = this->my_queues.size();
+        for (size_t i = 0; i < n; ++i) {
+            Queue &q = *this->my_queues[(first + i) % n];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (q.tasks.empty())
+                continue;
+            if (i == 0) {
+                task = std::move(q.tasks.back());
+                q.tasks.pop_back();
+            } else {
+                task = std::move(q.tasks.front());
+                q.tasks.pop_front();
+            }
+            this->my_queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    void work(size_t index) {
+        worker_index() = (int) index;
+        worker_pool() = this;
+        std::function<void()> task;
+        while (true) {
+            if (this->take(index, task)) {
+                task();
+                task = nullptr;
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(this->my_sleep_mutex);
+            this->my_wake.wait(lock, [this] {
+                return this->my_stopping.load() || this->my_queued.load() > 0;
+            });
+            if (this->my_stopping.load() && this->my_queued.load() == 0)
+                return;
+        }
+    }
+
+public:
+
+    /**
+     *  \brief Starts threads workers, at least one.
+     *  Defaults to the number of hardware threads.
+     */
+    explicit Thread_Pool(size_t threads = std::thread::hardware_concurrency())
+    : my_queues(), my_threads(), my_queued(0), my_next_queue(0),
+    my_stopping(false), my_sleep_mutex(), my_wake() {
+        if (threads == 0)
+            threads = 1;
+        for (size_t i = 0; i < threads; ++i)
+            this->my_queues.emplace_back(new Queue());
+        for (size_t i = 0; i < threads; ++i)
+            this->my_threads.emplace_back(&Thread_Pool::work, this, i);
+    }
+
+    Thread_Pool(const Thread_Pool &) = delete;
+    Thread_Pool& operator =(const Thread_Pool &) = delete;
+
+    /**
+     *  \brief Runs every queued task, then joins the workers.
+     */
+    ~Thread_Pool() {
+        {
+            std::lock_guard<std::mutex> lock(this->my_sleep_mutex);
+            this->my_stopping.store(true);
+        }
+        this->my_wake.notify_all();
+        for (size_t i = 0; i < this->my_threads.size(); ++i)
+            this->my_threads[i].join();
+    }
+
+    /**
+     *  \brief A pool with one worker per hardware thread, started on first use.
+     */
+    static Thread_Pool & shared() {
+        static Thread_Pool pool;
+        return pool;
+    }
+
+    /**
+     *  \brief Number of worker threads.
+     */
+    size_t size() const {
+        return this->my_threads.size();
+    }
+
+    /**
+     * \brief Queues task. From a worker of this pool it goes to that
+     * worker's own queue, otherwise to the next queue in turn.
+     * Exceptions thrown by task are the caller's to catch.
+     */
+    void post(std::function<void()> task) {
+        size_t index = worker_pool() == this ? (size_t) worker_index()
+                : this->my_next_queue.fetch_add(1, std::memory_order_relaxed)
+                % this->my_queues.size();
+        {
+            Queue &q = *this->my_queues[index];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            q.tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(this->my_sleep_mutex);
+            this->my_queued.fetch_add(1, std::memory_order_relaxed);
+        }
+        this->my_wake.notify_one();
+    }
+
+    /**
+     * \brief Queues task behind the tasks already queued. From a worker of
+     * this pool it goes to the end of that worker's queue that the worker
+     * runs last, otherwise to the next queue in turn, like post.
+     */
+    void defer(std::function<void()> task) {
+        size_t index = worker_pool() == this ? (size_t) worker_index()
+                : this->my_next_queue.fetch_add(1, std::memory_order_relaxed)
+                % this->my_queues.size();
+        {
+            Queue &q = *this->my_queues[index];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            q.tasks.push_front(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(this->my_sleep_mutex);
+            this->my_queued.fetch_add(1, std::memory_order_relaxed);
+        }
+        this->my_wake.notify_one();
+    }
+
+    /**
+     * \brief Runs one queued task on the calling thread.
+     * @return false if there was nothing to run
+     */
+    bool run_one() {
+        std::function<void()> task;
+        size_t first = worker_pool() == this ? (size_t) worker_index() : 0;
+        if (!this->take(first, task))
+            return false;
+        task();
+        return true;
+    }
+
+    /**
+     * \brief Calls f(begin, end) over [0, n) in chunks of at most chunk
+     * indices, spread over the pool, and returns once every chunk is done.
+     * The calling thread runs tasks while it waits. The first exception
+     * thrown by f is rethrown here once the running chunks finished; chunks
+     * that had not started by then are skipped.
+     * @param chunk - indices per task, 0 picks about 4 chunks per worker
+     */
+    template <class Function> void parallel_for(size_t n, size_t chunk,
+            Function f) {
+        if (n == 0)
+            return;
+        if (chunk == 0)
+            chunk = n / (4 * this->size()) + 1;
+        struct Shared_State {
+            std::atomic<size_t> remaining;
+            std::atomic<bool> failed;
+            std::mutex mutex;
+            std::exception_ptr error;
+        };
+        std::shared_ptr<Shared_State> state = std::make_shared<Shared_State>();
+        state->remaining.store((n + chunk - 1) / chunk);
+        state->failed.store(false);
+        for (size_t begin = 0; begin < n; begin += chunk) {
+            size_t end = begin + chunk < n ? begin + chunk : n;
+            this->post([state, &f, begin, end] {
+                try {
+                    if (!state->failed.load(std::memory_order_relaxed))
+                        f(begin, end);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    if (!state->error)
+                        state->error = std::current_exception();
+                    state->failed.store(true, std::memory_order_relaxed);
+                }
+                state->remaining.fetch_sub(1, std::memory_order_release);
+            });
+        }
+        while (state->remaining.load(std::memory_order_acquire) != 0) {
+            if (!this->run_one())
+                std::this_thread::yield();
+        }
+        if (state->error)
+            std::rethrow_exception(state->error);
+    }
+};
+#endif    // PROTOTYPAL_C_THREAD_POOL_H_
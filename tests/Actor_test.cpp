@@ -0,0 +1,91 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+
+/*
+ * File:   Actor_test.cpp
+ * Created on October 18, 2026
+ */
+#include "../Actor.h"
+#include "Check.h"
+#include <functional>
+#include <thread>
+#include <vector>
+
+static void * increment(long *count) {
+    ++*count;
+    return nullptr;
+}
+
+int main() {
+    Thread_Pool pool(4);
+    Actor_Scheduler scheduler(pool, 64);
+    Object f;
+    f.setFunc(&increment);
+
+    // Plain counters stay exact: an Actor handles one message at a time.
+    const int actor_count = 16, messages = 20000;
+    std::vector<Actor *> actors;
+    std::vector<long> counts(actor_count, 0);
+    for (int i = 0; i < actor_count; ++i) {
+        actors.push_back(new Actor(scheduler));
+        actors[i]->set("increment", f);
+    }
+    double ms = time_ms([&] {
+        std::vector<std::thread> senders;
+        for (int s = 0; s < 2; ++s)
+            senders.push_back(std::thread([&] {
+                for (int m = 0; m < messages; ++m)
+                    send(*actors[m % actor_count], "increment",
+                        &counts[m % actor_count]);
+            }));
+        for (std::size_t s = 0; s < senders.size(); ++s)
+            senders[s].join();
+        scheduler.wait_idle();
+    });
+    long total = 0;
+    for (int i = 0; i < actor_count; ++i)
+        total += counts[i];
+    printf("%ld messages to %d Actors from 2 threads: %.0f messages/s\n",
+            total, actor_count, total / ms * 1000);
+    CHECK(total == 2 * messages && counts[0] == 2 * messages / actor_count);
+    for (int i = 0; i < actor_count; ++i)
+        delete actors[i];
+
+    // Messages from one sender arrive in order; a failed one is counted.
+    std::vector<int> seen;
+    Actor ordered(scheduler);
+    for (int i = 0; i < 1000; ++i)
+        ordered.post([&seen, i](Actor &) {
+            seen.push_back(i);
+        });
+    send(ordered, "missing");
+    scheduler.wait_idle();
+    bool in_order = seen.size() == 1000;
+    for (int i = 0; i < 1000 && in_order; ++i)
+        in_order = seen[i] == i;
+    CHECK(in_order && scheduler.failures() == 1);
+
+    // An Actor that sends to itself does not grow the stack.
+    Actor ping(scheduler);
+    int rounds = 0;
+    ping.set("ping", std::function<void(int) >([&](int n) {
+        ++rounds;
+        if (n > 0)
+            lsend<std::function<void(int)> >(ping, "ping", n - 1);
+    }));
+    lsend<std::function<void(int)> >(ping, "ping", 100000);
+    scheduler.wait_idle();
+    CHECK(rounds == 100001);
+    return check_result();
+}
@@ -0,0 +1,90 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+/*
+ * File:   Async_Exec_test.cpp
+ * Created on October 18, 2026
+ */
+#include "../Async_Exec.h"
+#include "Check.h"
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+static void * fetch(int x) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    return new int(x * 2);
+}
+
+static void * fail(int) {
+    throw -1;
+}
+
+#ifdef PROTOTYPAL_CPP_COROUTINES
+
+static Task<int> twice(Executor executor, Object &backend, int x) {
+    int a = co_await co_exec<int>(executor, backend, "fetch", x);
+    int b = co_await co_exec<int>(executor, backend, "fetch", a);
+    co_return a + b;
+}
+#endif
+
+int main() {
+    Object backend, f, g;
+    f.setFunc(fetch);
+    g.setFunc(fail);
+    backend.set("fetch", f);
+    backend.set("fail", g);
+    const int n = 64;
+
+    long sum = 0;
+    double serial_ms = time_ms([&] {
+        for (int i = 0; i < n; ++i)
+            sum += backend.exec<int>("fetch", i);
+    });
+    Thread_Pool io(32);
+    Executor executor = pool_executor(io);
+    long async_sum = 0;
+    double async_ms = time_ms([&] {
+        std::vector<std::future<int> > futures;
+        for (int i = 0; i < n; ++i)
+            futures.push_back(exec_async<int>(executor, backend, "fetch", i));
+        for (std::size_t i = 0; i < futures.size(); ++i)
+            async_sum += futures[i].get();
+    });
+    CHECK(sum == async_sum);
+    printf("%d calls blocking 5 ms: exec %.1f ms, exec_async on 32 threads "
+            "%.1f ms\n", n, serial_ms, async_ms);
+
+    CHECK(throws([&] {
+        exec_async(executor, backend, "fail", 1).get();
+    }));
+    CHECK(call_async<int>(executor, f, 21).get() == 42);
+
+#ifdef PROTOTYPAL_CPP_COROUTINES
+    CHECK(sync_wait(twice(executor, backend, 1), io) == 6);
+
+    // sync_wait on the only worker of a pool runs the pool's tasks itself.
+    Thread_Pool one(1);
+    Executor on_one = pool_executor(one);
+    std::promise<int> done;
+    std::future<int> result = done.get_future();
+    one.post([&] {
+        done.set_value(sync_wait(twice(on_one, backend, 2), one));
+    });
+    CHECK(result.wait_for(std::chrono::seconds(10)) == std::future_status::ready
+            && result.get() == 12);
+#endif
+    return check_result();
+}
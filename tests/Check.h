@@ -0,0 +1,85 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+/*
+ * File:   Check.h
+ * Created on October 18, 2026
+ */
+
+#ifndef PROTOTYPAL_C_TESTS_CHECK_H_
+#define PROTOTYPAL_C_TESTS_CHECK_H_
+
+/* Each program in this directory tests one header and times what its
+ * commit claims. Build and run one from this directory with, for example:
+ *
+ *     g++ -std=c++11 -O2 -pthread -I.. Object_Array_test.cpp -o test && ./test
+ *
+ * Async_Exec_test.cpp needs -std=c++20, Concurrent_Object_test.cpp
+ * -std=c++14. Scaling figures depend on the cores of the host.
+ * A program prints what it measured and exits with 1 if a check failed.
+ */
+
+#include <stdio.h>
+#include <chrono>
+
+inline int & check_failures() {
+    static int failures = 0;
+    return failures;
+}
+
+inline void check_condition(bool ok, const char *text, int line,
+        const char *file) {
+    if (ok)
+        return;
+    printf("Check failed: %s\n  See line number %d in file %s\n\n", text, line,
+            file);
+    check_failures() += 1;
+}
+
+#define CHECK(condition) check_condition((condition), #condition, __LINE__, \
+        __FILE__)
+
+/**
+ * \brief True if f throws -1, the way Objects report errors.
+ */
+template <class Function> bool throws(Function f) {
+    try {
+        f();
+    } catch (int) {
+        return true;
+    }
+    return false;
+}
+
+/**
+ * \brief Milliseconds taken by f().
+ */
+template <class Function> double time_ms(Function f) {
+    std::chrono::steady_clock::time_point start =
+            std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>
+            (std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * \brief Prints the outcome. Return it from main.
+ */
+inline int check_result() {
+    if (check_failures() == 0)
+        printf("All checks passed\n");
+    else
+        printf("%d checks failed\n", check_failures());
+    return check_failures() == 0 ? 0 : 1;
+}
+#endif    // PROTOTYPAL_C_TESTS_CHECK_H_
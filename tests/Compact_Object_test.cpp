@@ -0,0 +1,117 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+
+/*
+ * File:   Compact_Object_test.cpp
+ * Created on October 18, 2026
+ */
+#include "../Compact_Object.h"
+#include "Check.h"
+#include <malloc.h>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <string>
+
+// Counts the live bytes that glibc malloc hands out through operator new.
+// The replacements are kept out of line: inlined, GCC sees free() called
+// on a pointer from operator new and warns under -Wall.
+static std::size_t allocated = 0;
+
+__attribute__((noinline)) void * operator new(std::size_t n) {
+    void * p = std::malloc(n == 0 ? 1 : n);
+    if (p == nullptr)
+        throw std::bad_alloc();
+    allocated += malloc_usable_size(p);
+    return p;
+}
+
+__attribute__((noinline)) void operator delete(void * p) noexcept {
+    allocated -= malloc_usable_size(p);
+    std::free(p);
+}
+
+__attribute__((noinline)) void operator delete(void * p, std::size_t)
+noexcept {
+    allocated -= malloc_usable_size(p);
+    std::free(p);
+}
+
+static int * add(int a, int b) {
+    return new int(a + b);
+}
+
+/**
+ * \brief Live heap bytes of a new Type with properties int properties,
+ * the Type itself included.
+ */
+template <class Type> std::size_t bytes_with(int properties) {
+    std::size_t before = allocated;
+    Type * o = new Type();
+    for (int i = 0; i < properties; ++i)
+        o->set(std::string("p") + char('a' + i), i);
+    std::size_t bytes = allocated - before;
+    delete o;
+    return bytes;
+}
+
+int main() {
+    CHECK(sizeof(Compact_Object) == sizeof(void *));
+    const int counts[] = {0, 1, 4, 8};
+    for (int i = 0; i < 4; ++i) {
+        std::size_t object = bytes_with<Object>(counts[i]);
+        std::size_t compact = bytes_with<Compact_Object>(counts[i]);
+        printf("%d properties: Object %zu bytes, Compact_Object %zu bytes\n",
+                counts[i], object, compact);
+        CHECK(compact < object);
+    }
+    std::size_t before = allocated;
+    Compact_Object empty;
+    CHECK(allocated == before);
+
+    // The same interface as Object.
+    Compact_Object a, b;
+    a.set("x", 5);
+    b.setParent(a);
+    CHECK(b.get<int>("x") == 5 && b.has<int>("x") && !b.has<float>("x"));
+    CHECK(!b.hasOwnProperty("x"));
+    Compact_Object f;
+    f.setFunc(&add);
+    a.set("f", f);
+    CHECK(b.exec<int>("f", 5, 6) == 11);
+    Object of;
+    of.setFunc(&add);
+    a.set("of", of);
+    CHECK(b.exec<int>("of", 1, 2) == 3);
+    std::function<int(int) > twice = [](int v) {
+        return v * 2;
+    };
+    a.set("twice", twice);
+    CHECK((b.lexec<std::function<int(int)>, int>("twice", 21) == 42));
+    Compact_Object c(b);
+    CHECK(c.get<int>("x") == 5);
+    c = a;
+    CHECK(c.hasOwnProperty("x") && c.hasOwnProperty("twice"));
+    CHECK(a.get<int>("x") == 5);
+    CHECK(throws([&] { a.get<int>("missing"); }));
+    CHECK(c.remove("x") && !c.remove("x") && !c.hasOwnProperty("x"));
+    CHECK(a.hasOwnProperty("x") && c.hasOwnProperty("twice"));
+    c.clear();
+    CHECK(!c.hasOwnProperty("twice") && !empty.remove("x"));
+    Compact_Object moved;
+    moved = std::move(a);
+    CHECK(moved.get<int>("x") == 5 && !a.hasOwnProperty("x"));
+    CHECK(!b.has("x"));
+    return check_result();
+}
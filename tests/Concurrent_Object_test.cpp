@@ -0,0 +1,75 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+
+/*
+ * File:   Concurrent_Object_test.cpp
+ * Created on October 18, 2026
+ */
+#include "../Concurrent_Object.h"
+#include "Check.h"
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+static int * add(int a, int b) {
+    return new int(a + b);
+}
+
+int main() {
+    Concurrent_Object<> prototype, o;
+    o.setParent(prototype);
+    for (int i = 0; i < 64; ++i)
+        prototype.set("k" + std::to_string(i), i);
+    Object f;
+    f.setFunc(&add);
+    prototype.set("add", f);
+    std::function<int(int) > plus_k1 = [&o](int v) {
+        return v + o.get<int>("k1");
+    };
+    prototype.set("plus_k1", plus_k1);
+    CHECK(o.exec<int>("add", 2, 3) == 5);
+    // The callable runs unlocked, so it can read o again.
+    CHECK((o.lexec<std::function<int(int)>, int>("plus_k1", 1) == 2));
+    CHECK(o.has<int>("k3") && !o.has<float>("k3") && !o.hasOwnProperty("k3"));
+
+    // Mixed gets and sets from 1 to 64 threads. On a single core this only
+    // shows that contention costs little; run it on many cores for scaling.
+    printf("%u hardware threads\n", std::thread::hardware_concurrency());
+    for (int count = 1; count <= 64; count *= 2) {
+        std::atomic<long> total(0);
+        double ms = time_ms([&] {
+            std::vector<std::thread> threads;
+            for (int t = 0; t < count; ++t)
+                threads.push_back(std::thread([&, t] {
+                    long sum = 0;
+                    for (int i = 0; i < 200000 / count; ++i) {
+                        sum += o.get<int>("k" + std::to_string((i + t) & 63));
+                        if (i % 1000 == 0)
+                            o.set("w" + std::to_string(t), i);
+                    }
+                    total.fetch_add(sum);
+                }));
+            for (std::size_t t = 0; t < threads.size(); ++t)
+                threads[t].join();
+        });
+        printf("200000 gets from %d threads: %.3f ms\n", count, ms);
+        CHECK(total.load() > 0
+                && o.hasOwnProperty("w" + std::to_string(count - 1)));
+    }
+    CHECK(o.remove("w0") && !o.hasOwnProperty("w0") && o.hasOwnProperty("w1"));
+    CHECK(throws([&] { o.get<int>("missing"); }));
+    return check_result();
+}
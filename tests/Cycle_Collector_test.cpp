@@ -0,0 +1,90 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+/*
+ * File:   Cycle_Collector_test.cpp
+ * Created on October 18, 2026
+ */
+#define PROTOTYPAL_CPP_STATISTICS
+#include "../Cycle_Collector.h"
+#include "Check.h"
+#include <memory>
+#include <string>
+
+static int clears = 0;
+
+static void count_clears(Object &, Object::Change change, const std::string *,
+        const void *, const Object::Type_Descriptor *) {
+    if (change == Object::change_clear)
+        ++clears;
+}
+
+int main() {
+    Cycle_Collector &collector = Cycle_Collector::instance();
+    collector.enable();
+    long long before = Object::statistics().live_objects;
+    const int cycles = 10000;
+    for (int i = 0; i < cycles; ++i) {
+        std::shared_ptr<Object> a = std::make_shared<Object>();
+        std::shared_ptr<Object> b = std::make_shared<Object>();
+        a->set("b", b);
+        b->set("a", a);
+        a->set("pad", std::string(200, 'x'));
+    }
+    CHECK(Object::statistics().live_objects == before + 2 * cycles);
+
+    std::shared_ptr<Object> live = std::make_shared<Object>();
+    std::shared_ptr<Object> other = std::make_shared<Object>();
+    live->set("other", other);
+    other->set("live", live);
+
+    // A bounded step frees part of the garbage.
+    Cycle_Collector::Result r = collector.step(64);
+    CHECK(r.visited <= 64 && r.objects > 0);
+    double ms = time_ms([&] {
+        r = collector.collect();
+    });
+    printf("collect freed %zu Objects, %zu bytes, in %.3f ms\n", r.objects,
+            r.bytes, ms);
+    CHECK(Object::statistics().live_objects == before + 2);
+    CHECK(live->has("other") && other->has("live"));
+
+    // Candidates that stay alive are dropped after max_examinations.
+    collector.set_max_examinations(3);
+    for (int i = 0; i < 3; ++i)
+        collector.collect();
+    CHECK(collector.totals().pending == 0);
+
+    // Once dropped, a candidate is tracked again when stored again.
+    other->set("live", live);
+    live.reset();
+    other.reset();
+    collector.collect();
+    CHECK(Object::statistics().live_objects == before);
+
+    // Garbage is emptied through change_clear, frozen or not.
+    Object::add_change_hook(&count_clears);
+    {
+        std::shared_ptr<Object> a = std::make_shared<Object>();
+        std::shared_ptr<Object> b = std::make_shared<Object>();
+        a->set("b", b);
+        b->set("a", a);
+        b->freeze();
+    }
+    collector.collect();
+    Object::remove_change_hook(&count_clears);
+    CHECK(clears == 2);
+    CHECK(Object::statistics().live_objects == before);
+    collector.disable();
+    return check_result();
+}
@@ -0,0 +1,72 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+/*
+ * File:   Mapped_Object_test.cpp
+ * Created on October 18, 2026
+ */
+#include "../Mapped_Object.h"
+#include "Check.h"
+#include <sys/wait.h>
+#include <unistd.h>
+#include <string>
+
+static void write_file(const std::string &path, int legs, int count) {
+    Object prototype;
+    prototype.set("legs", legs);
+    Object root;
+    root.setParent(prototype);
+    root.set("name", std::string("rex"));
+    for (int i = 0; i < count; ++i)
+        root.set("k" + std::to_string((long long) i), i);
+    Mapped_Object::write(root, path);
+}
+
+int main() {
+    const std::string path = "Mapped_Object_test.map";
+    // Written by another process, so that this one reads built-in types
+    // before anything built its type registry.
+    pid_t child = fork();
+    if (child == 0) {
+        write_file(path, 4, 200000);
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+    CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    Mapped_Object m(path);
+    CHECK(m.has<int>("legs") && !m.has<double>("legs"));
+    CHECK(m.get<int>("legs") == 4 && m.get<std::string>("name") == "rex");
+
+    long long sum = 0;
+    double ms = time_ms([&] {
+        for (int i = 0; i < 200000; ++i)
+            sum += m.get<int>("k" + std::to_string((long long) i));
+    });
+    printf("200000 gets on a mapped file: %.3f ms\n", ms);
+    CHECK(sum == 199999LL * 200000 / 2);
+
+    // Rewriting the file leaves the open mapping on the old contents.
+    write_file(path, 6, 10);
+    CHECK(m.get<int>("legs") == 4 && m.get<int>("k199999") == 199999);
+    Mapped_Object fresh(path);
+    CHECK(fresh.get<int>("legs") == 6 && !fresh.has("k10"));
+    CHECK(access((path + ".tmp").c_str(), F_OK) != 0);
+
+    // A file that cannot be created leaves nothing behind.
+    CHECK(throws([&] {
+        write_file("no_such_directory/x.map", 1, 1);
+    }));
+    unlink(path.c_str());
+    return check_result();
+}
@@ -0,0 +1,77 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+
+/*
+ * File:   Memory_Usage_test.cpp
+ * Created on October 18, 2026
+ */
+#define PROTOTYPAL_CPP_STATISTICS
+#include "../Prototypal_Cpp.h"
+#include "Check.h"
+#include <string>
+#include <vector>
+
+int main() {
+    Object::Statistics start = Object::statistics();
+    Object empty;
+    Object::Memory_Usage usage = empty.memory_usage();
+    CHECK(usage.header == sizeof (Object) && usage.nested_objects == 0);
+    CHECK(usage.keys == 0 && usage.slots == 0 && usage.values == 0);
+
+    Object o;
+    o.set("count", 1);
+    o.set("name", std::string(100, 'x'));
+    usage = o.memory_usage();
+    CHECK(usage.keys > 0 && usage.slots > 0 && usage.control_blocks > 0);
+    CHECK(usage.values >= sizeof (int) + 100);
+    CHECK(usage.total() == usage.header + usage.buckets + usage.keys
+            + usage.slots + usage.control_blocks + usage.values
+            + usage.nested_objects);
+
+    // A nested Object is counted in full only when deep.
+    Object child;
+    child.set("x", 2.5);
+    Object holder;
+    holder.set("child", child);
+    Object::Memory_Usage deep = holder.memory_usage(true);
+    Object::Memory_Usage shallow = holder.memory_usage(false);
+    CHECK(shallow.nested_objects == sizeof (Object));
+    CHECK(deep.nested_objects == child.memory_usage().total());
+
+    // The counters follow Objects, properties and allocations.
+    Object::Statistics now = Object::statistics();
+    CHECK(now.live_objects - start.live_objects == 5);
+    CHECK(now.live_properties - start.live_properties == 5);
+    CHECK(now.bytes_allocated > start.bytes_allocated);
+    CHECK(now.allocations > start.allocations);
+    long long before = now.live_objects;
+    {
+        Object temporary;
+        temporary.set("y", 1);
+        CHECK(Object::statistics().live_objects == before + 1);
+    }
+    CHECK(Object::statistics().live_objects == before);
+
+    std::vector<Object> many(10000);
+    double ms = time_ms([&] {
+        for (std::size_t i = 0; i < many.size(); ++i)
+            many[i].set("v", (int) i);
+    });
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < many.size(); ++i)
+        total += many[i].memory_usage().total();
+    printf("10000 Objects with one int: %.1f bytes each, set %.1f ns with "
+            "counters\n", (double) total / many.size(), ms * 1e6 / many.size());
+    return check_result();
+}
@@ -0,0 +1,77 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+/*
+ * File:   Object_Array_test.cpp
+ * Created on October 18, 2026
+ */
+#include "../Object_Array.h"
+#include "Check.h"
+#include <vector>
+
+int main() {
+    const size_t n = 100000;
+    std::vector<Object> objects(n);
+    Object_Array array;
+    array.addColumn<double>("x");
+    array.addColumn<int>("id");
+    array.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        objects[i].set("x", (double) i * 0.5);
+        objects[i].set("id", (int) i);
+        array.push_back(objects[i]);
+    }
+    CHECK(array.size() == n);
+    CHECK(array[10].get<double>("x") == 5.0);
+    CHECK(array.hasColumn<int>("id") && !array.hasColumn<float>("id"));
+
+    // Summing a column against get<double> on every Object.
+    double object_sum = 0, array_sum = 0;
+    double object_ms = time_ms([&] {
+        for (size_t i = 0; i < n; ++i)
+            object_sum += objects[i].get<double>("x");
+    });
+    double array_ms = time_ms([&] {
+        array_sum = array.sum<double>("x");
+    });
+    CHECK(object_sum == array_sum);
+    printf("sum of %zu doubles: Objects %.3f ms, Object_Array %.3f ms\n", n,
+            object_ms, array_ms);
+
+    array.map<double>("x", [](double v) {
+        return v * 2;
+    });
+    CHECK(array[10].get<double>("x") == 10.0);
+    CHECK(array.filter<int>("id", [](int v) {
+        return v % 1000 == 0;
+    }).size() == 100);
+
+    const Object_Array &constant = array;
+    CHECK(constant.sum<int>("id") == array.sum<int>("id"));
+    CHECK(constant.filter<double>("x", [](double v) {
+        return v < 4;
+    }).size() == 4);
+
+    array[3].set("y", 1.5f);
+    CHECK(array.to_object(3).get<float>("y") == 1.5f);
+    Object_Array copy(array);
+    copy.swap_remove(0);
+    CHECK(copy.size() == n - 1 && copy[0].get<int>("id") == (int) n - 1);
+    CHECK(throws([&] {
+        array[0].get<int>("x");
+    }));
+    CHECK(throws([&] {
+        array.addColumn<float>("x");
+    }));
+    return check_result();
+}
@@ -0,0 +1,120 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+
+/*
+ * File:   Object_Batch_test.cpp
+ * Created on October 18, 2026
+ */
+#include "../Prototypal_Cpp.h"
+#include "Check.h"
+#include <functional>
+#include <tuple>
+#include <vector>
+
+static int * add(int a, int b) {
+    return new int(a + b);
+}
+
+static int kernel_calls = 0;
+
+static void add_kernel(const std::tuple<int, int> *arguments,
+        std::size_t count, int *results) {
+    kernel_calls += 1;
+    for (std::size_t i = 0; i < count; ++i)
+        results[i] = std::get<0>(arguments[i]) + std::get<1>(arguments[i]);
+}
+
+static int touched = 0;
+
+static void * touch(int x) {
+    touched += x;
+    return nullptr;
+}
+
+int main() {
+    Object prototype, middle, leaf, f, g;
+    f.setFunc(&add);
+    g.setFunc(&touch);
+    prototype.set("add", f);
+    prototype.set("touch", g);
+    std::function<int(int, int) > multiply = [](int a, int b) {
+        return a * b;
+    };
+    prototype.set("multiply", multiply);
+    middle.setParent(prototype);
+    leaf.setParent(middle);
+
+    const int n = 1000000;
+    std::vector<std::tuple<int, int> > arguments;
+    for (int i = 0; i < n; ++i)
+        arguments.push_back(std::make_tuple(i % 1000, 2));
+    std::vector<int> results;
+    double loop_ms = time_ms([&] {
+        for (int i = 0; i < n; ++i)
+            leaf.exec<int>("add", i % 1000, 2);
+    });
+    double batch_ms = time_ms([&] {
+        leaf.exec_batch("add", arguments, results);
+    });
+    CHECK(results.size() == (std::size_t) n && results[999] == 1001);
+
+    // A kernel with the same types takes the whole batch.
+    Object with_kernel;
+    with_kernel.setFunc(&add);
+    with_kernel.setBatchFunc(&add_kernel);
+    prototype.set("add", with_kernel);
+    results.clear();
+    double kernel_ms = time_ms([&] {
+        leaf.exec_batch("add", arguments, results);
+    });
+    CHECK(kernel_calls == 1 && results[1999] == 1001);
+    CHECK(leaf.exec<int>("add", 1, 2) == 3);
+    // The kernel is not a property, and copies keep it.
+    CHECK(!with_kernel.hasOwnProperty("[batch]"));
+    Object kernel_copy(with_kernel);
+    prototype.set("add", kernel_copy);
+    leaf.exec_batch("add", arguments.data(), 10, results.data());
+    CHECK(kernel_calls == 2);
+
+    // A memo on the way to the callable is used for every tuple instead.
+    middle.memoize("add", 1000);
+    leaf.exec_batch("add", arguments.data(), 2000, results.data());
+    CHECK(kernel_calls == 2 && results[1999] == 1001);
+    Object::Memo_Statistics memo = middle.memo_statistics("add");
+    CHECK(memo.misses == 1000 && memo.hits == 1000);
+    middle.memoize("multiply", 1000);
+    leaf.lexec_batch<std::function<int(int, int)> >("multiply",
+            arguments.data(), 2000, results.data());
+    CHECK(middle.memo_statistics("multiply").hits == 1000);
+
+    results.clear();
+    double lexec_ms = time_ms([&] {
+        leaf.lexec_batch<std::function<int(int, int)> >("multiply", arguments,
+                results);
+    });
+    CHECK(results[7] == 14);
+    std::vector<std::tuple<int> > ones(10, std::make_tuple(1));
+    leaf.exec_batch("touch", ones);
+    CHECK(touched == 10);
+    CHECK(throws([&] {
+        leaf.exec_batch("missing", ones);
+    }));
+    CHECK(throws([&] {
+        leaf.lexec_batch<std::function<int(int)> >("multiply", ones, results);
+    }));
+    printf("per call: exec %.1f ns, exec_batch %.1f ns, kernel %.1f ns, "
+            "lexec_batch %.1f ns\n", loop_ms * 1e6 / n, batch_ms * 1e6 / n,
+            kernel_ms * 1e6 / n, lexec_ms * 1e6 / n);
+    return check_result();
+}
@@ -0,0 +1,91 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+
+/*
+ * File:   Object_Collection_test.cpp
+ * Created on October 18, 2026
+ */
+#include "../Object_Collection.h"
+#include "Check.h"
+#include <stdio.h>
+#include <atomic>
+#include <string>
+#include <thread>
+
+int main() {
+    Object other;
+    double no_collection_ms = time_ms([&] {
+        for (int i = 0; i < 1000000; ++i)
+            other.set("n", i);
+    });
+    {
+        Object_Collection people;
+        people.add_hash_index<std::string>("name");
+        people.add_ordered_index<int>("age");
+        Object a, b, c;
+        a.set("name", std::string("ann"));
+        a.set("age", 31);
+        b.set("name", std::string("bob"));
+        b.set("age", 25);
+        CHECK(people.add(a) && people.add(b) && !people.add(a));
+        CHECK(people.find<std::string>("name", "ann").size() == 1);
+        CHECK(&*people.find<std::string>("name", "ann").begin() == &a);
+
+        // Changes to members update the indexes.
+        b.set("age", 40);
+        int n = 0;
+        for (Object &m : people.range<int>("age", 30, 50))
+            n += m.get<int>("age");
+        CHECK(n == 71);
+        a.remove("name");
+        CHECK(people.find<std::string>("name", "ann").empty());
+        CHECK(throws([&] { people.find<int>("name", 1); }));
+        {
+            Object d;
+            d.set("age", 35);
+            people.add(d);
+            CHECK(people.range<int>("age", 30, 40).size() == 3);
+        }
+        CHECK(people.size() == 2 && people.range<int>("age", 30, 40).size() == 2);
+
+        // Changes to Objects that are not members skip the lock.
+        double collection_ms = time_ms([&] {
+            for (int i = 0; i < 1000000; ++i)
+                other.set("n", i);
+        });
+        printf("1000000 sets of an Object that is not a member: %.3f ms, "
+                "%.3f ms with a collection\n", no_collection_ms,
+                collection_ms);
+        c.set("age", 45);
+        CHECK(!people.contains(c) && people.range<int>("age", 45, 45).empty());
+    }
+
+    // Collections come and go while another thread changes Objects.
+    std::atomic<bool> done(false);
+    std::thread changer([&] {
+        Object o;
+        for (int i = 0; !done.load(); ++i)
+            o.set("n", i);
+    });
+    for (int i = 0; i < 10000; ++i) {
+        Object_Collection collection;
+        Object member;
+        collection.add(member);
+        member.set("n", i);
+    }
+    done = true;
+    changer.join();
+    CHECK(Object::change_hook() == nullptr);
+    return check_result();
+}
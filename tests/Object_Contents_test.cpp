@@ -0,0 +1,61 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+
+/*
+ * File:   Object_Contents_test.cpp
+ * Created on October 18, 2026
+ */
+#define PROTOTYPAL_CPP_STATISTICS
+#include "../Prototypal_Cpp.h"
+#include "Check.h"
+#include <string>
+
+int main() {
+    long long properties = Object::statistics().live_properties;
+    Object o = {
+        {"name", std::string("rex")},
+        {"legs", 4},
+        {"legs", 3}
+    };
+    CHECK(o.get<std::string>("name") == "rex" && o.get<int>("legs") == 3);
+    CHECK(Object::statistics().live_properties == properties + 2);
+
+    // remove only touches this Object, not its parent.
+    Object child;
+    child.setParent(o);
+    child.set("legs", 2);
+    CHECK(child.remove("legs") && !child.remove("legs"));
+    CHECK(child.get<int>("legs") == 3 && !child.remove("name"));
+    CHECK(Object::statistics().live_properties == properties + 2);
+
+    // reserve sizes the table once; shrink_to_fit gives buckets back.
+    Object big;
+    big.reserve(100000);
+    std::size_t reserved = big.memory_usage().buckets;
+    double ms = time_ms([&] {
+        for (int i = 0; i < 100000; ++i)
+            big.set("k" + std::to_string((long long) i), i);
+    });
+    CHECK(big.memory_usage().buckets == reserved);
+    printf("100000 sets into a reserved table: %.3f ms\n", ms);
+    for (int i = 10; i < 100000; ++i)
+        big.remove("k" + std::to_string((long long) i));
+    big.shrink_to_fit();
+    CHECK(big.memory_usage().buckets < reserved / 100);
+    CHECK(big.get<int>("k9") == 9 && !big.has("k10"));
+    big.clear();
+    CHECK(!big.has("k0") && big.memory_usage().keys == 0);
+    CHECK(Object::statistics().live_properties == properties + 2);
+    return check_result();
+}
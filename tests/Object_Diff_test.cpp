@@ -0,0 +1,126 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+/*
+ * File:   Object_Diff_test.cpp
+ * Created on October 18, 2026
+ */
+#include "../Prototypal_Cpp.h"
+#include "Check.h"
+#include <sys/wait.h>
+#include <unistd.h>
+#include <string>
+
+/**
+ * \brief The lineage id a delta was computed from: the 8 bytes after the
+ * format byte.
+ */
+static uint64_t lineage(const std::string &delta) {
+    uint64_t id = 0;
+    std::copy(delta.data() + 1, delta.data() + 9, reinterpret_cast<char *> (&id));
+    return id;
+}
+
+static bool refuse_c = false;
+
+static void refuse(Object &, Object::Change, const std::string * name,
+        const void *, const Object::Type_Descriptor *) {
+    if (refuse_c && name != nullptr && *name == "c")
+        throw -1;
+}
+
+static uint64_t fresh_lineage() {
+    Object o;
+    o.track_versions();
+    return lineage(o.diff(Object()));
+}
+
+int main() {
+    Object primary;
+    primary.track_versions();
+    for (int i = 0; i < 100000; ++i)
+        primary.set("p" + std::to_string((long long) i), i);
+    Object replica;
+    replica.apply(primary.diff(replica));
+    CHECK(replica.get<int>("p99999") == 99999);
+
+    for (int i = 0; i < 10; ++i)
+        primary.set("p" + std::to_string((long long) i), -i);
+    primary.remove("p10");
+    std::string delta;
+    double incremental_ms = time_ms([&] {
+        delta = primary.diff(replica);
+    });
+    replica.apply(delta);
+    CHECK(replica.get<int>("p9") == -9 && !replica.has("p10"));
+    Object stranger(replica);
+    double full_ms = time_ms([&] {
+        delta = primary.diff(stranger);
+    });
+    printf("diff of 11 changes among 100000 properties: %.3f ms incremental, "
+            "%.3f ms full\n", incremental_ms, full_ms);
+    CHECK(lineage(delta) == lineage(primary.diff(replica)));
+
+    // A replica cannot take a delta computed against another version.
+    Object stale;
+    stale.apply(primary.diff(stale));
+    primary.set("p0", 0);
+    replica.apply(primary.diff(replica));
+    CHECK(throws([&] {
+        stale.apply(primary.diff(replica));
+    }));
+
+    // A change that throws, here the removal of c, which comes after the
+    // sets, undoes the changes applied before it.
+    Object source;
+    Object target;
+    for (int i = 0; i < 100; ++i) {
+        source.set("s" + std::to_string((long long) i), i);
+        target.set("t" + std::to_string((long long) i), i);
+    }
+    target.set("c", 3);
+    target.set("s0", -1);
+    delta = source.diff(target);
+    Object::add_change_hook(&refuse);
+    refuse_c = true;
+    CHECK(throws([&] {
+        target.apply(delta);
+    }));
+    refuse_c = false;
+    Object::remove_change_hook(&refuse);
+    CHECK(target.get<int>("s0") == -1 && target.get<int>("t0") == 0);
+    CHECK(!target.has("s1") && target.get<int>("c") == 3);
+    target.apply(delta);
+    CHECK(target.get<int>("s0") == 0 && target.get<int>("s99") == 99);
+    CHECK(!target.has("c") && !target.has("t99"));
+
+    // Processes forked from one another pick different lineages.
+    int pipe_ends[2];
+    CHECK(pipe(pipe_ends) == 0);
+    pid_t child = fork();
+    if (child == 0) {
+        uint64_t id = fresh_lineage();
+        ssize_t written = write(pipe_ends[1], &id, sizeof (id));
+        _exit(written == (ssize_t) sizeof (id) ? 0 : 1);
+    }
+    uint64_t mine = fresh_lineage();
+    uint64_t theirs = 0;
+    CHECK(read(pipe_ends[0], &theirs, sizeof (theirs)) == (ssize_t) sizeof (theirs));
+    int status = 0;
+    waitpid(child, &status, 0);
+    CHECK(mine != 0 && theirs != 0 && mine != theirs);
+    CHECK(fresh_lineage() != mine);
+    close(pipe_ends[0]);
+    close(pipe_ends[1]);
+    return check_result();
+}
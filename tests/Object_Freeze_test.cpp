@@ -0,0 +1,94 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+
+/*
+ * File:   Object_Freeze_test.cpp
+ * Created on October 18, 2026
+ */
+#include "../Prototypal_Cpp.h"
+#include "Check.h"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+int main() {
+    Object prototype;
+    prototype.set("legs", 4);
+    Object o;
+    o.setParent(prototype);
+    o.set("name", std::string("rex"));
+    o.set("age", 3);
+    o.freeze();
+    CHECK(o.isFrozen() && !prototype.isFrozen());
+    CHECK(o.get<std::string>("name") == "rex" && o.get<int>("legs") == 4);
+    CHECK(o.has<int>("age") && !o.has<double>("age") && !o.has("weight"));
+    CHECK(o.hasOwnProperty("age") && !o.hasOwnProperty("legs"));
+
+    // Every write throws and leaves the Object as it was.
+    Object other;
+    CHECK(throws([&] {
+        o.set("age", 4);
+    }));
+    CHECK(throws([&] {
+        o.remove("age");
+    }));
+    CHECK(throws([&] {
+        o.clear();
+    }));
+    CHECK(throws([&] {
+        o.pass_contents(other);
+    }));
+    CHECK(throws([&] {
+        o = other;
+    }));
+    CHECK(o.get<int>("age") == 3 && o.isFrozen());
+
+    // Copies share the table and stay frozen.
+    Object copy(o);
+    CHECK(copy.isFrozen() && copy.get<std::string>("name") == "rex");
+    other = o;
+    CHECK(other.isFrozen() && other.get<int>("age") == 3);
+
+    // Lookups of 100000 keys in random order, before and after freezing.
+    const int n = 100000;
+    Object big;
+    std::vector<std::string> names;
+    for (int i = 0; i < n; ++i) {
+        names.push_back("key" + std::to_string((long long) i));
+        big.set(names.back(), i);
+    }
+    std::shuffle(names.begin(), names.end(), std::mt19937(42));
+    long long sum = 0;
+    double hashed_ms = time_ms([&] {
+        for (int i = 0; i < n; ++i)
+            sum += big.get<int>(names[i]);
+    });
+    double freeze_ms = time_ms([&] {
+        big.freeze();
+    });
+    double frozen_ms = time_ms([&] {
+        for (int i = 0; i < n; ++i)
+            sum -= big.get<int>(names[i]);
+    });
+    CHECK(sum == 0);
+    bool all_found = true;
+    for (int i = 0; i < n; ++i)
+        all_found = all_found && big.hasOwnProperty(names[i]);
+    CHECK(all_found);
+    CHECK(!big.has("key100000") && !big.has(""));
+    printf("100000 keys: get %.1f ns hashed, %.1f ns frozen; freeze %.1f ms\n",
+            hashed_ms * 1e6 / n, frozen_ms * 1e6 / n, freeze_ms);
+    return check_result();
+}
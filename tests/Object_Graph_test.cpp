@@ -0,0 +1,128 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+
+/*
+ * File:   Object_Graph_test.cpp
+ * Created on October 18, 2026
+ */
+#include "../Object_Graph.h"
+#include "Check.h"
+#include <sstream>
+#include <string>
+
+static int answer() {
+    return 42;
+}
+
+struct Unsaveable {
+    int x;
+};
+
+int main() {
+    Thread_Pool pool(4);
+    Object prototype, root, child, leaf;
+    prototype.set("kind", std::string("prototype"));
+    root.set("n", 1);
+    child.set("v", 2.5);
+    child.setParent(prototype);
+    root.set("child", child);
+    std::shared_ptr<Object> clone = deep_clone(pool, root);
+    CHECK(clone->get<int>("n") == 1);
+    CHECK(clone->get<Object>("child").get<double>("v") == 2.5);
+    // Parents outside the graph are kept, not cloned.
+    CHECK(clone->get<Object>("child").getParent() == &prototype);
+
+    // Frozen and lazy values.
+    Object frozen, lazy;
+    leaf.set("x", 7);
+    frozen.set("a", 1);
+    frozen.set("leaf", leaf);
+    frozen.freeze();
+    lazy.set("frozen", frozen);
+    lazy.set_lazy<int>("answer", &answer);
+    clone = deep_clone(pool, lazy);
+    CHECK(clone->get<Object>("frozen").isFrozen());
+    CHECK(clone->get<Object>("frozen").get<Object>("leaf").get<int>("x") == 7);
+    CHECK(clone->get<int>("answer") == 42);
+
+    // parallel_save writes what save writes, and it loads back.
+    Object holder, big;
+    for (int i = 0; i < 1000; ++i) {
+        Object e;
+        e.set("i", i);
+        e.set("s", std::to_string(i));
+        big.set("e" + std::to_string(i), e);
+    }
+    holder.set("big", big);
+    holder.set("big2", big);
+    std::ostringstream saved, parallel_saved;
+    holder.save(saved);
+    parallel_save(pool, holder, parallel_saved);
+    CHECK(saved.str().size() == parallel_saved.str().size());
+    std::istringstream in(parallel_saved.str());
+    std::shared_ptr<Object> loaded = Object::load(in);
+    CHECK(loaded->get<Object>("big2").get<Object>("e999").get<std::string>("s")
+            == "999");
+
+    // A value save cannot write fails the whole save.
+    Object bad, inner;
+    inner.set("u", Unsaveable{1});
+    bad.set("inner", inner);
+    CHECK(throws([&] {
+        std::ostringstream out;
+        parallel_save(pool, bad, out);
+    }));
+
+    // A deep chain does not recurse.
+    Object chain;
+    chain.set("leaf", 1);
+    for (int i = 0; i < 2000; ++i) {
+        Object next;
+        next.set("next", chain);
+        chain = next;
+    }
+    std::ostringstream chain_out;
+    parallel_save(pool, chain, chain_out);
+    CHECK(deep_clone(pool, chain)->hasOwnProperty("next"));
+
+    Object huge;
+    for (int i = 0; i < 100000; ++i) {
+        Object e;
+        e.set("i", i);
+        e.set("d", i * 0.5);
+        e.set("s", std::string("value") + std::to_string(i));
+        huge.set("k" + std::to_string(i), e);
+    }
+    std::ostringstream s1, s2;
+    double save_ms = time_ms([&] {
+        huge.save(s1);
+    });
+    double parallel_save_ms = time_ms([&] {
+        parallel_save(pool, huge, s2);
+    });
+    double clone_ms = time_ms([&] {
+        deep_clone(pool, huge);
+    });
+    double copy_ms = time_ms([&] {
+        std::ostringstream out;
+        huge.save(out);
+        std::istringstream back(out.str());
+        Object::load(back);
+    });
+    printf("100000 Objects on %zu workers: save %.1f ms, parallel_save %.1f ms,"
+            " deep_clone %.1f ms, save and load %.1f ms\n", pool.size(),
+            save_ms, parallel_save_ms, clone_ms, copy_ms);
+    CHECK(s1.str().size() == s2.str().size());
+    return check_result();
+}
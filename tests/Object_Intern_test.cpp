@@ -0,0 +1,108 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+/*
+ * File:   Object_Intern_test.cpp
+ * Created on October 18, 2026
+ */
+#include "../Prototypal_Cpp.h"
+#include "Check.h"
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Counts the bytes requested through operator new. The replacements are
+// kept out of line: inlined, GCC sees free() called on a pointer from
+// operator new and warns under -Wall.
+static std::size_t allocated = 0;
+
+__attribute__((noinline)) void * operator new(std::size_t n) {
+    allocated += n;
+    void * p = std::malloc(n == 0 ? 1 : n);
+    if (p == nullptr)
+        throw std::bad_alloc();
+    return p;
+}
+
+__attribute__((noinline)) void operator delete(void * p) noexcept {
+    std::free(p);
+}
+
+__attribute__((noinline)) void operator delete(void * p, std::size_t)
+noexcept {
+    std::free(p);
+}
+
+/**
+ * \brief Bytes requested from operator new by f().
+ */
+template <class Function> std::size_t bytes_of(Function f) {
+    std::size_t before = allocated;
+    f();
+    return allocated - before;
+}
+
+int main() {
+    const std::string config(1000, 'x');
+    const int count = 100000;
+    std::vector<Object> copied(count), interned(count);
+    std::size_t copied_bytes = 0, interned_bytes = 0;
+    double copied_ms = time_ms([&] {
+        copied_bytes = bytes_of([&] {
+            for (int i = 0; i < count; ++i)
+                copied[i].set("config", config);
+        });
+    });
+    double interned_ms = time_ms([&] {
+        interned_bytes = bytes_of([&] {
+            for (int i = 0; i < count; ++i)
+                interned[i].set_interned("config", config);
+        });
+    });
+    Object::Intern_Statistics s = Object::intern_statistics();
+    printf("%d Objects holding a 1000-byte string: set %zu bytes in %.3f ms, "
+            "set_interned %zu bytes in %.3f ms, dedup ratio %.1f\n", count,
+            copied_bytes, copied_ms, interned_bytes, interned_ms,
+            s.dedup_ratio());
+    CHECK(s.calls == count && s.hits == count - 1 && s.size == 1);
+    CHECK(interned_bytes * 4 < copied_bytes);
+    CHECK(interned[count - 1].get<std::string>("config") == config);
+
+    // The value is freed with the last property holding it.
+    interned.clear();
+    CHECK(Object::intern_statistics().size == 0);
+
+    struct Unhashed {
+        int x;
+    };
+    Object o;
+    CHECK(throws([&] {
+        o.set_interned("u", Unhashed());
+    }));
+
+    // Threads interning equal values share one of each.
+    std::vector<Object> shared(4000);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+        threads.push_back(std::thread([&, t] {
+            for (int i = t * 1000; i < (t + 1) * 1000; ++i)
+                shared[i].set_interned("k", std::to_string((long long) (i % 100))
+                        + std::string(40, 'y'));
+        }));
+    for (std::size_t t = 0; t < threads.size(); ++t)
+        threads[t].join();
+    CHECK(Object::intern_statistics().size == 100);
+    return check_result();
+}
@@ -0,0 +1,98 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+/*
+ * File:   Object_Journal_test.cpp
+ * Created on October 18, 2026
+ */
+#include "../Object_Journal.h"
+#include "Check.h"
+#include <stdio.h>
+#include <string>
+#include <thread>
+
+static int builds = 0;
+
+static long build() {
+    builds += 1;
+    return 77;
+}
+
+int main() {
+    const std::string path = "Object_Journal_test.snap";
+    // Once a thread has run, as the Journal's writer does, shared_ptr
+    // counts are atomic, so the times are compared from then on.
+    std::thread([] {
+    }).join();
+    Object other;
+    double unjournaled_ms = time_ms([&] {
+        for (int i = 0; i < 1000000; ++i)
+            other.set("n", i);
+    });
+    {
+        Object root;
+        root.set("a", 1);
+        Journal journal(path, root, Journal::sync_none);
+        Object child;
+        child.set("x", 2.5);
+        root.set("child", child);
+        root.set_lazy<long>("lazy", &build);
+        root.remove("a");
+
+        // A lazy value of an Object that is not journaled stays unbuilt,
+        // and its changes skip the journal's lock.
+        other.set_lazy<long>("lazy", &build);
+        CHECK(builds == 1);
+        double journal_open_ms = time_ms([&] {
+            for (int i = 0; i < 1000000; ++i)
+                other.set("n", i);
+        });
+        printf("1000000 sets of an Object that is not journaled: %.3f ms, "
+                "%.3f ms with a Journal open\n", unjournaled_ms,
+                journal_open_ms);
+        journal.flush();
+        CHECK(journal.statistics().changes == 3);
+    }
+    std::shared_ptr<Object> r = Journal::recover(path);
+    CHECK(!r->hasOwnProperty("a") && r->get<long>("lazy") == 77);
+    CHECK(r->get<Object>("child").get<double>("x") == 2.5);
+    CHECK(builds == 1 && other.get<long>("lazy") == 77 && builds == 2);
+    {
+        // With many Objects watched, changes to others still skip the lock,
+        // and compaction leaves them watched once.
+        Object root;
+        Journal journal(path, root, Journal::sync_none);
+        for (int i = 0; i < 100000; ++i) {
+            Object child;
+            child.set("i", i);
+            root.set("c" + std::to_string(i), child);
+        }
+        double crowded_ms = time_ms([&] {
+            for (int i = 0; i < 1000000; ++i)
+                other.set("n", i);
+        });
+        printf("1000000 sets of an Object that is not journaled: %.3f ms "
+                "with 100001 Objects journaled\n", crowded_ms);
+        journal.compact();
+        root.set("after", -5);
+        root.remove("c6");
+        journal.flush();
+        CHECK(journal.statistics().compactions == 1);
+    }
+    r = Journal::recover(path);
+    CHECK(r->get<int>("after") == -5);
+    CHECK(!r->hasOwnProperty("c6") && r->get<Object>("c7").get<int>("i") == 7);
+    remove(path.c_str());
+    remove((path + ".log").c_str());
+    return check_result();
+}
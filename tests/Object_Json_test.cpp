@@ -0,0 +1,116 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+/*
+ * File:   Object_Json_test.cpp
+ * Created on October 18, 2026
+ */
+#include "../Object_Json.h"
+#include "Check.h"
+#include <clocale>
+#include <sstream>
+#include <string>
+
+static std::shared_ptr<Object> read_text(const std::string &text) {
+    std::istringstream in(text);
+    return json_read(in);
+}
+
+static bool rejected(const std::string &text) {
+    return throws([&] {
+        read_text(text);
+    });
+}
+
+static void check_numbers() {
+    std::shared_ptr<Object> o = read_text(
+            "[0, -0.5, 1e5, 1E-2, 0.25, 123456789012345678901234, -7]");
+    CHECK(o->get<long long>("0") == 0 && o->get<double>("1") == -0.5);
+    CHECK(o->get<double>("2") == 1e5 && o->get<double>("3") == 0.01);
+    CHECK(o->get<double>("4") == 0.25 && o->get<double>("5") > 1e23);
+    CHECK(o->get<long long>("6") == -7);
+    const char * bad[] = {"[01]", "[-01]", "[1.]", "[.5]", "[-]", "[1e]",
+        "[1e+]", "[+1]", "[0x10]", "[1.5.2]", "[--1]"};
+    for (std::size_t i = 0; i < sizeof (bad) / sizeof (bad[0]); ++i)
+        CHECK(rejected(bad[i]));
+}
+
+int main() {
+    std::shared_ptr<Object> o = read_text("{\"name\":\"rex\\n\\u00e9\","
+            "\"legs\":4,\"w\":12.5,\"ok\":true,\"nothing\":null,"
+            "\"tags\":[\"a\",[1,{}],[]]}");
+    CHECK(o->get<std::string>("name") == "rex\n\xc3\xa9");
+    CHECK(o->get<long long>("legs") == 4 && o->get<double>("w") == 12.5);
+    std::string out;
+    json_write(*o, out);
+    std::string again;
+    json_write(*read_text(out), again);
+    CHECK(again.size() == out.size());
+    check_numbers();
+
+    // Numbers are read and written with '.' whatever the locale.
+    if (setlocale(LC_NUMERIC, "de_DE.UTF-8") != nullptr) {
+        check_numbers();
+        Object d;
+        d.set("w", 12.5);
+        std::string text;
+        json_write(d, text);
+        CHECK(text == "{\"w\":12.5}");
+        setlocale(LC_NUMERIC, "C");
+    } else
+        printf("de_DE.UTF-8 is not installed, locale check skipped\n");
+
+    // Cycles are found, deep trees are written without recursion.
+    std::shared_ptr<Object> cyclic = std::make_shared<Object>();
+    std::shared_ptr<Object> child = std::make_shared<Object>();
+    cyclic->set("child", child);
+    child->set("parent", cyclic);
+    CHECK(throws([&] {
+        std::string text;
+        json_write(*cyclic, text);
+    }));
+    child->remove("parent");
+    const int depth = 100000;
+    std::shared_ptr<Object> deep = read_text(std::string(depth, '[') +
+            std::string(depth, ']'));
+    std::string deep_text;
+    CHECK(!throws([&] {
+        json_write(*deep, deep_text);
+    }));
+    CHECK(deep_text.size() == 2 * (std::size_t) depth);
+
+    std::string doc = "[";
+    for (int i = 0; i < 200000; ++i) {
+        if (i != 0)
+            doc += ',';
+        doc += "{\"id\":" + std::to_string((long long) i) +
+                ",\"name\":\"item number " + std::to_string((long long) i) +
+                "\",\"price\":" + std::to_string(i * 0.25) +
+                ",\"tags\":[\"x\",\"y\"],\"active\":true}";
+    }
+    doc += "]";
+    std::shared_ptr<Object> big;
+    double read_ms = time_ms([&] {
+        big = read_text(doc);
+    });
+    std::ostringstream written;
+    double write_ms = time_ms([&] {
+        json_write(*big, written);
+    });
+    double mb = (double) doc.size() / 1e6;
+    printf("%.1f MB: read %.0f MB/s, write %.0f MB/s\n", mb,
+            mb / read_ms * 1000, (double) written.str().size() / 1e6 / write_ms
+            * 1000);
+    CHECK(read_text(written.str())->get<long long>("length") == 200000);
+    return check_result();
+}
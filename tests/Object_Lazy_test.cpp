@@ -0,0 +1,90 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+
+/*
+ * File:   Object_Lazy_test.cpp
+ * Created on October 18, 2026
+ */
+#include "../Prototypal_Cpp.h"
+#include "Check.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+static std::atomic<int> builds(0);
+
+static std::vector<double> table() {
+    builds.fetch_add(1);
+    return std::vector<double>(100000, 1.5);
+}
+
+static int failures = 0;
+
+static int flaky() {
+    if (failures++ == 0)
+        throw -1;
+    return 7;
+}
+
+int main() {
+    Object prototype, child;
+    prototype.set_lazy<std::vector<double> >("table", &table);
+    child.setParent(prototype);
+    CHECK(builds.load() == 0);
+    // Checking for the name does not build the value.
+    CHECK(child.has("table") && prototype.hasOwnProperty("table"));
+    CHECK(builds.load() == 0);
+    CHECK(child.get<std::vector<double> >("table").size() == 100000);
+    CHECK(child.has<std::vector<double> >("table") && builds.load() == 1);
+    Object copy(prototype);
+    CHECK(copy.get<std::vector<double> >("table")[5] == 1.5);
+    CHECK(builds.load() == 1);
+
+    // A factory that throws leaves the value unbuilt for the next read.
+    Object o;
+    o.set_lazy<int>("n", &flaky);
+    CHECK(throws([&] {
+        o.get<int>("n");
+    }));
+    CHECK(o.get<int>("n") == 7 && failures == 2);
+
+    // Eight first readers at once build the value once.
+    Object shared;
+    shared.set_lazy<std::vector<double> >("table", &table);
+    std::vector<std::thread> readers;
+    std::atomic<int> wrong(0);
+    for (int t = 0; t < 8; ++t)
+        readers.push_back(std::thread([&] {
+            if (shared.get<std::vector<double> >("table").size() != 100000)
+                wrong.fetch_add(1);
+        }));
+    for (std::size_t t = 0; t < readers.size(); ++t)
+        readers[t].join();
+    CHECK(builds.load() == 2 && wrong.load() == 0);
+
+    Object eager, lazy;
+    double eager_ms = time_ms([&] {
+        for (int i = 0; i < 100; ++i)
+            eager.set("t" + std::to_string((long long) i), table());
+    });
+    double lazy_ms = time_ms([&] {
+        for (int i = 0; i < 100; ++i)
+            lazy.set_lazy<std::vector<double> >
+                    ("t" + std::to_string((long long) i), &table);
+    });
+    printf("100 tables of 100000 doubles: %.2f ms eagerly, %.2f ms lazily\n",
+            eager_ms, lazy_ms);
+    return check_result();
+}
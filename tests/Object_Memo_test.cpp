@@ -0,0 +1,83 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+
+/*
+ * File:   Object_Memo_test.cpp
+ * Created on October 18, 2026
+ */
+#include "../Prototypal_Cpp.h"
+#include "Check.h"
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+static int calls = 0;
+
+static int * slow_square(int x) {
+    calls += 1;
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+    return new int(x * x);
+}
+
+static void * nothing(int) {
+    calls += 1;
+    return nullptr;
+}
+
+int main() {
+    Object o, f, g;
+    f.setFunc(&slow_square);
+    g.setFunc(&nothing);
+    o.set("square", f);
+    o.set("nothing", g);
+    o.set("scale", 2);
+    o.memoize("square", 2, std::vector<std::string>(1, "scale"));
+    CHECK(o.exec<int>("square", 3) == 9 && calls == 1);
+    CHECK(o.exec<int>("square", 3) == 9 && calls == 1);
+    CHECK(o.exec<int>("square", 4) == 16 && calls == 2);
+    CHECK(o.exec<int>("square", 5) == 25 && calls == 3);
+    Object::Memo_Statistics stats = o.memo_statistics("square");
+    CHECK(stats.hits == 1 && stats.misses == 3 && stats.evictions == 1);
+    CHECK(stats.size == 2);
+
+    // Writes to the function or a dependency empty the cache.
+    o.set("scale", 3);
+    CHECK(o.memo_statistics("square").size == 0);
+    o.exec<int>("square", 5);
+    o.invalidate("square");
+    CHECK(o.memo_statistics("square").size == 0 && calls == 4);
+
+    // Void results are not cached; copies keep the settings, not results.
+    o.memoize("nothing");
+    o.exec("nothing", 1);
+    o.exec("nothing", 1);
+    CHECK(calls == 6);
+    o.exec<int>("square", 6);
+    Object copy(o);
+    copy.exec<int>("square", 6);
+    CHECK(calls == 8 && copy.memo_statistics("square").misses == 1);
+    o.unmemoize("square");
+    o.exec<int>("square", 6);
+    CHECK(calls == 9 && o.memo_statistics("square").size == 0);
+
+    copy.exec<int>("square", 7);
+    double hit_ms = time_ms([&] {
+        for (int i = 0; i < 100000; ++i)
+            copy.exec<int>("square", 7);
+    });
+    printf("memo hit: %.1f ns, against 50 us for the function\n",
+            hit_ms * 1e6 / 100000);
+    return check_result();
+}
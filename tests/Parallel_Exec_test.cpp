@@ -0,0 +1,86 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+/*
+ * File:   Parallel_Exec_test.cpp
+ * Created on October 18, 2026
+ */
+#include "../Parallel_Exec.h"
+#include "Check.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+static std::atomic<int> calls(0);
+
+static int * cube(int x) {
+    calls.fetch_add(1);
+    return new int(x * x * x);
+}
+
+int main() {
+    Thread_Pool pool(4);
+    Object prototype;
+    Object f;
+    f.setFunc(&cube);
+    prototype.set("cube", f);
+    std::vector<Object> objects(10000);
+    for (std::size_t i = 0; i < objects.size(); ++i)
+        objects[i].setParent(prototype);
+    std::vector<int> results;
+    double ms = time_ms([&] {
+        results = parallel_exec<int>(pool, objects, "cube", 3);
+    });
+    printf("parallel_exec over %zu Objects: %.3f ms\n", objects.size(), ms);
+    CHECK(results.size() == objects.size() && results[0] == 27 &&
+            results.back() == 27 && calls.load() == 10000);
+
+    // A memoized function is called through the cache, also in parallel.
+    calls.store(0);
+    Object shared;
+    shared.set("cube", f);
+    shared.memoize("cube", 16);
+    shared.freeze();
+    std::vector<Object *> same(1000, &shared);
+    results = parallel_exec<int>(pool, same, "cube", 4);
+    CHECK(results[999] == 64 && calls.load() >= 1 && calls.load() <= 4);
+    Object::Memo_Statistics stats = shared.memo_statistics("cube");
+    CHECK(stats.hits + stats.misses == 1000 && stats.size == 1);
+
+    // A frozen memoized Object read from many threads at once.
+    std::vector<std::thread> threads;
+    std::atomic<int> wrong(0);
+    for (int t = 0; t < 4; ++t)
+        threads.push_back(std::thread([&, t] {
+            for (int i = 0; i < 20000; ++i)
+                if (shared.exec<int>("cube", (i + t) % 16) !=
+                        ((i + t) % 16) * ((i + t) % 16) * ((i + t) % 16))
+                    wrong.fetch_add(1);
+        }));
+    for (std::size_t t = 0; t < threads.size(); ++t)
+        threads[t].join();
+    stats = shared.memo_statistics("cube");
+    printf("memo from 4 threads: %lld hits, %lld misses, %lld evictions\n",
+            stats.hits, stats.misses, stats.evictions);
+    CHECK(wrong.load() == 0 && stats.size <= 16);
+    CHECK(stats.hits + stats.misses == 81000);
+
+    // A memo on the prototype is used by the Objects that inherit from it.
+    calls.store(0);
+    prototype.memoize("cube", 16);
+    results = parallel_exec<int>(pool, objects, "cube", 5);
+    CHECK(results.back() == 125 && calls.load() >= 1 && calls.load() <= 4);
+    stats = prototype.memo_statistics("cube");
+    CHECK(stats.hits + stats.misses == 10000);
+    return check_result();
+}
@@ -0,0 +1,136 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+
+/*
+ * File:   Prototypal_Cpp_test.cpp
+ * Created on October 18, 2026
+ */
+#include "../Prototypal_Cpp.h"
+#include "Check.h"
+#include <string>
+
+static int * square(int x) {
+    return new int(x * x);
+}
+
+static int * cube(int x) {
+    return new int(x * x * x);
+}
+
+static void * nothing() {
+    return nullptr;
+}
+
+static int calls = 0;
+
+static int * counted_square(int x) {
+    calls += 1;
+    return new int(x * x);
+}
+
+int main() {
+    // Methods are found by slot through the parent tree.
+    Object prototype, middle, leaf;
+    std::size_t square_slot = prototype.setMethod("square", &square);
+    CHECK(square_slot == Object::method_slot("square"));
+    CHECK(Object::method_name(square_slot) == "square");
+    middle.setParent(prototype);
+    leaf.setParent(middle);
+    CHECK(leaf.hasMethod(square_slot) && !prototype.has("square"));
+    CHECK(leaf.invoke<int>(square_slot, 4) == 16);
+    CHECK(leaf.invoke<int>("square", 5) == 25);
+    CHECK(throws([&] {
+        leaf.invoke<int>("missing", 1);
+    }));
+
+    // Copies share the table until they set a method of their own.
+    Object own(prototype);
+    own.setMethod("square", &cube);
+    CHECK(own.invoke<int>(square_slot, 2) == 8);
+    CHECK(prototype.invoke<int>(square_slot, 2) == 4);
+    Object frozen;
+    frozen.freeze();
+    CHECK(throws([&] {
+        frozen.setMethod("square", &square);
+    }));
+
+    Object function;
+    function.setFunc(&nothing);
+    prototype.set("nothing", function);
+    std::size_t nothing_slot = prototype.setMethod("nothing", &nothing);
+    const int n = 1000000;
+    double exec_ms = time_ms([&] {
+        for (int i = 0; i < n; ++i)
+            leaf.exec("nothing");
+    });
+    double invoke_ms = time_ms([&] {
+        for (int i = 0; i < n; ++i)
+            leaf.invoke(nothing_slot);
+    });
+    printf("two parents up: exec %.1f ns, invoke %.1f ns\n", exec_ms * 1e6 / n,
+            invoke_ms * 1e6 / n);
+
+    // The frozen, method, memo and version state sits behind one pointer.
+    printf("sizeof(Object) %zu\n", sizeof (Object));
+    CHECK(sizeof (Object) <= 88);
+    Object plain;
+    plain.set("a", 1);
+    Object::Memory_Usage usage = plain.memory_usage(false);
+    CHECK(usage.header == sizeof (Object));
+
+    // A copy shares the frozen table and methods, and copies the memo
+    // settings but not the cached results.
+    Object o;
+    o.set("x", 2);
+    o.setMethod("square", &square);
+    Object f;
+    f.setFunc(&counted_square);
+    o.set("f", f);
+    o.memoize("f");
+    CHECK(o.exec<int>("f", 3) == 9 && calls == 1);
+    Object copy(o);
+    CHECK(copy.exec<int>("f", 3) == 9 && calls == 2);
+    CHECK(copy.exec<int>("f", 3) == 9 && calls == 2);
+    CHECK(copy.memo_statistics("f").hits == 1);
+    CHECK(copy.hasMethod(Object::method_slot("square")));
+    CHECK(copy.invoke<int>(Object::method_slot("square"), 4) == 16);
+    o.freeze();
+    CHECK(o.isFrozen() && !copy.isFrozen());
+    CHECK(throws([&] {
+        o.set("x", 3);
+    }));
+    Object frozen_copy(o);
+    CHECK(frozen_copy.isFrozen() && frozen_copy.get<int>("x") == 2);
+    CHECK(o.memory_usage(false).header > sizeof (Object));
+
+    // Versions are not copied, and assignment keeps and resets its own.
+    Object a;
+    a.track_versions();
+    a.set("x", 1);
+    a.set("y", 2);
+    CHECK(a.version() == 2);
+    Object b;
+    b.apply(a.diff(b));
+    CHECK(b.get<int>("y") == 2 && Object(a).version() == 0);
+    a.set("y", 3);
+    b.apply(a.diff(b));
+    CHECK(b.get<int>("y") == 3);
+    Object c(copy);
+    c = a;
+    CHECK(c.version() == 0 && c.get<int>("x") == 1);
+    c.track_versions();
+    c = copy;
+    CHECK(c.version() == 1 && c.exec<int>("f", 3) == 9 && calls == 3);
+    return check_result();
+}
@@ -0,0 +1,95 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+
+/*
+ * File:   Read_Mostly_Object_test.cpp
+ * Created on October 18, 2026
+ */
+#include "../Read_Mostly_Object.h"
+#include "Check.h"
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Destroyed after main returns, so its table is retired at exit.
+static Read_Mostly_Object global;
+
+static int * add(int a, int b) {
+    return new int(a + b);
+}
+
+int main() {
+    global.set("exit", 1);
+    Read_Mostly_Object prototype, o;
+    o.setParent(prototype);
+    prototype.update([](Read_Mostly_Object::Transaction & t) {
+        for (int i = 0; i < 64; ++i)
+            t.set("k" + std::to_string(i), i);
+    });
+    Object f;
+    f.setFunc(&add);
+    prototype.set("add", f);
+    std::function<int(int) > plus_k1 = [&o](int v) {
+        return v + o.get<int>("k1");
+    };
+    prototype.set("plus_k1", plus_k1);
+    CHECK(o.exec<int>("add", 2, 3) == 5);
+    CHECK((o.lexec<std::function<int(int)>, int>("plus_k1", 1) == 2));
+    CHECK(o.has<int>("k3") && !o.has<float>("k3") && !o.has("zz"));
+
+    // Readers never see an older table than the one they saw last, so k1
+    // read after k0 is at least k0 + 1, and the tables they may still read
+    // are retired instead of freed.
+    std::atomic<bool> stop(false);
+    std::atomic<long> reads(0), torn(0);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t)
+        readers.push_back(std::thread([&] {
+            long n = 0;
+            while (!stop.load()) {
+                int k0 = o.get<int>("k0");
+                if (o.get<int>("k1") < k0 + 1)
+                    torn.fetch_add(1);
+                ++n;
+            }
+            reads.fetch_add(n);
+        }));
+    for (int i = 0; i < 200; ++i) {
+        prototype.update([i](Read_Mostly_Object::Transaction & t) {
+            t.set("k0", i);
+            t.set("k1", i + 1);
+        });
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    stop = true;
+    for (std::size_t t = 0; t < readers.size(); ++t)
+        readers[t].join();
+    Epoch_Reclaimer::instance().reclaim();
+    printf("%ld reads during 200 updates, %zu tables pending\n", reads.load(),
+            Epoch_Reclaimer::instance().pending());
+    CHECK(torn.load() == 0 && Epoch_Reclaimer::instance().pending() == 0);
+
+    long sum = 0;
+    const std::string name = "k5";
+    double ms = time_ms([&] {
+        for (int i = 0; i < 2000000; ++i)
+            sum += o.get<int>(name);
+    });
+    printf("get through one parent: %.1f ns\n", ms * 1e6 / 2000000);
+    CHECK(sum == 10000000);
+    CHECK(throws([&] { o.get<int>("missing"); }));
+    return check_result();
+}
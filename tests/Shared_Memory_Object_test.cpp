@@ -0,0 +1,83 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+/*
+ * File:   Shared_Memory_Object_test.cpp
+ * Created on October 18, 2026
+ */
+#include "../Shared_Memory_Object.h"
+#include "Check.h"
+#include <sys/wait.h>
+#include <unistd.h>
+#include <string>
+
+int main() {
+    const std::string segment = "/prototypal_c_test";
+    Shared_Memory_Object::unlink(segment);
+    Shared_Memory_Object root(segment, 64 << 20);
+    Object prototype;
+    prototype.set("legs", 4);
+    Object o;
+    o.setParent(prototype);
+    o.set("name", std::string("rex"));
+    root.import_object(o);
+    Shared_Memory_Object child = root.addObject("child");
+    child.setParent(root);
+    double ms = time_ms([&] {
+        for (int i = 0; i < 100000; ++i)
+            root.set("k" + std::to_string((long long) i), i);
+    });
+    printf("100000 sets: %.3f ms\n", ms);
+
+    // A worker process reads and updates the same segment.
+    pid_t worker = fork();
+    if (worker == 0) {
+        Shared_Memory_Object w(segment);
+        bool ok = w.get<int>("k99999") == 99999 && w.get<int>("legs") == 4;
+        w.set("config", std::string("updated by worker"));
+        w.getObject("child").set("legs", 3);
+        _exit(ok ? 0 : 1);
+    }
+    int status = 0;
+    waitpid(worker, &status, 0);
+    CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    CHECK(root.get<std::string>("config") == "updated by worker");
+    CHECK(child.get<int>("legs") == 3 && root.get<int>("legs") == 4);
+    Shared_Memory_Object::unlink(segment);
+
+    // A full segment leaves the table as it was and leaks nothing.
+    Shared_Memory_Object full(segment, 8192);
+    const std::string long_name(200, 'n');
+    int stored = 0;
+    while (!throws([&] {
+            full.set(long_name + std::to_string((long long) stored), stored);
+        }))
+        stored += 1;
+    CHECK(full.size() == (std::size_t) stored && !full.has(long_name + "x"));
+    // The failed set found room for its value but not its name, and gave
+    // the value block back: replacing a value needs no more than that.
+    CHECK(!throws([&] {
+        full.set(long_name + "1", -1);
+    }));
+    CHECK(full.get<int>(long_name + "1") == -1);
+    full.set(long_name + "1", 1);
+    for (int i = 0; i < stored; ++i)
+        CHECK(full.get<int>(long_name + std::to_string((long long) i)) == i);
+    CHECK(full.remove(long_name + "0"));
+    CHECK(!throws([&] {
+        full.set(long_name + "x", 1);
+    }));
+    CHECK(full.get<int>(long_name + "x") == 1);
+    Shared_Memory_Object::unlink(segment);
+    return check_result();
+}
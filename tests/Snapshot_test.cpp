@@ -0,0 +1,119 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+/*
+ * File:   Snapshot_test.cpp
+ * Created on October 18, 2026
+ */
+#include "../Prototypal_Cpp.h"
+#include "Check.h"
+#include <sstream>
+#include <streambuf>
+#include <string>
+
+// Reads a string without being able to seek, like a pipe.
+struct Pipe_Buffer : std::streambuf {
+
+    explicit Pipe_Buffer(std::string &bytes) {
+        this->setg(&bytes[0], &bytes[0], &bytes[0] + bytes.size());
+    }
+};
+
+/**
+ * \brief True if Object::load rejects bytes, through a seekable stream
+ * and through one that cannot seek.
+ */
+static bool rejected(std::string bytes) {
+    std::istringstream seekable(bytes);
+    Pipe_Buffer buffer(bytes);
+    std::istream pipe(&buffer);
+    return throws([&] {
+        Object::load(seekable);
+    }) && throws([&] {
+        Object::load(pipe);
+    });
+}
+
+int main() {
+    // The first thing this process does is save built-in types, before
+    // anything else built the type registry.
+    Object first;
+    first.set("n", 5);
+    first.set("s", std::string("five"));
+    std::stringstream stream;
+    CHECK(!throws([&] {
+        first.save(stream);
+    }));
+    std::shared_ptr<Object> loaded = Object::load(stream);
+    CHECK(loaded->get<int>("n") == 5 && loaded->get<std::string>("s") == "five");
+
+    // A shared child is written once, the parent tree is kept.
+    Object prototype;
+    prototype.set("legs", 4);
+    Object child;
+    child.set("v", 9.5);
+    Object holder;
+    holder.set("child", child);
+    Object root;
+    root.setParent(prototype);
+    root.set("a", holder); // a and b are copies sharing one child
+    root.set("b", holder);
+    std::stringstream tree;
+    root.save(tree);
+    loaded = Object::load(tree);
+    CHECK(loaded->get<int>("legs") == 4);
+    std::vector<Object *> a = loaded->get<Object>("a").getOwnObjects();
+    std::vector<Object *> b = loaded->get<Object>("b").getOwnObjects();
+    CHECK(a.size() == 1 && a == b && a[0]->get<double>("v") == 9.5);
+
+    // Values of unregistered types cannot be saved.
+    struct Unregistered {
+        int x;
+    };
+    Object bad;
+    bad.set("u", Unregistered());
+    std::stringstream out;
+    CHECK(throws([&] {
+        bad.save(out);
+    }));
+
+    Object big;
+    for (int i = 0; i < 100000; ++i)
+        big.set("p" + std::to_string((long long) i), i);
+    std::string bytes;
+    double save_ms = time_ms([&] {
+        std::ostringstream s;
+        big.save(s);
+        bytes = s.str();
+    });
+    double load_ms = time_ms([&] {
+        std::istringstream s(bytes);
+        loaded = Object::load(s);
+    });
+    printf("100000 ints: %zu bytes, save %.3f ms, load %.3f ms\n",
+            bytes.size(), save_ms, load_ms);
+    CHECK(loaded->get<int>("p99999") == 99999);
+    Pipe_Buffer buffer(bytes);
+    std::istream pipe(&buffer);
+    CHECK(Object::load(pipe)->get<int>("p99999") == 99999);
+
+    // A header that claims more bytes than the stream holds is rejected
+    // before they are allocated.
+    std::string huge = bytes;
+    uint64_t length = (uint64_t) 1 << 60;
+    huge.replace(12, sizeof (length), reinterpret_cast<const char *> (&length),
+            sizeof (length));
+    CHECK(rejected(huge));
+    CHECK(rejected(bytes.substr(0, bytes.size() - 1)));
+    return check_result();
+}
@@ -0,0 +1,80 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+
+/*
+ * File:   Thread_Pool_test.cpp
+ * Created on October 18, 2026
+ */
+#include "../Thread_Pool.h"
+#include "Check.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+int main() {
+    Thread_Pool pool(4);
+    CHECK(pool.size() == 4);
+    std::vector<int> squares(100000);
+    pool.parallel_for(squares.size(), 0, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            squares[i] = (int) (i % 1000) * (int) (i % 1000);
+    });
+    bool right = true;
+    for (size_t i = 0; i < squares.size(); ++i)
+        right = right && squares[i] == (int) (i % 1000) * (int) (i % 1000);
+    CHECK(right);
+
+    // parallel_for from inside a task: the waiting worker runs tasks itself.
+    std::atomic<int> count(0);
+    pool.parallel_for(8, 1, [&](size_t, size_t) {
+        pool.parallel_for(10, 2, [&](size_t begin, size_t end) {
+            count.fetch_add((int) (end - begin));
+        });
+    });
+    CHECK(count.load() == 80);
+
+    // The first exception is rethrown once the running chunks are done.
+    std::atomic<int> ran(0);
+    CHECK(throws([&] {
+        pool.parallel_for(1000, 1, [&](size_t begin, size_t) {
+            ran.fetch_add(1);
+            if (begin == 3)
+                throw -1;
+        });
+    }));
+    CHECK(ran.load() >= 1 && ran.load() <= 1000);
+
+    // Tasks posted from other threads, then the cost of an empty chunk.
+    std::atomic<int> posted(0);
+    std::vector<std::thread> posters;
+    for (int t = 0; t < 4; ++t)
+        posters.push_back(std::thread([&] {
+            for (int i = 0; i < 10000; ++i)
+                pool.post([&] {
+                    posted.fetch_add(1);
+                });
+        }));
+    for (std::size_t t = 0; t < posters.size(); ++t)
+        posters[t].join();
+    while (posted.load() != 40000)
+        if (!pool.run_one())
+            std::this_thread::yield();
+    double ms = time_ms([&] {
+        pool.parallel_for(100000, 1, [](size_t, size_t) {
+        });
+    });
+    printf("100000 empty chunks on %zu workers: %.1f ns per chunk\n",
+            pool.size(), ms * 1e6 / 100000);
+    return check_result();
+}
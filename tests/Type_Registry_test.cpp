@@ -0,0 +1,99 @@
+/*
+Copyright [2014] [John-Michael Reed]
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http:  // www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ */
+
+
+/*
+ * File:   Type_Registry_test.cpp
+ * Created on October 18, 2026
+ */
+#include "../Prototypal_Cpp.h"
+#include "Check.h"
+#include <string>
+#include <vector>
+
+struct Point {
+    int x;
+    int y;
+};
+
+struct Tags {
+    std::vector<std::string> names;
+};
+
+static void write_tags(const Tags &value, std::string &out) {
+    const Object::Type_Descriptor * t = Object::descriptor<std::string>();
+    for (std::size_t i = 0; i < value.names.size(); ++i)
+        t->serialize(&value.names[i], out);
+}
+
+static bool read_tags(Tags &value, const char *&in, const char *end) {
+    const Object::Type_Descriptor * t = Object::descriptor<std::string>();
+    while (in != end) {
+        std::shared_ptr<void> name = t->deserialize(in, end);
+        if (name == nullptr)
+            return false;
+        value.names.push_back(*static_cast<std::string *> (name.get()));
+    }
+    return true;
+}
+
+int main() {
+    // Built-in types are registered under their C++ names.
+    const Object::Type_Descriptor * int_type = Object::find_type("int");
+    CHECK(int_type == Object::descriptor<int>());
+    CHECK(int_type->id == Object::type_id("int") && int_type->name == "int");
+    CHECK(Object::find_type(Object::type_id("std::string")) ==
+            Object::descriptor<std::string>());
+    CHECK(Object::find_type("no such type") == nullptr);
+
+    // Trivially copyable types get every operation.
+    const Object::Type_Descriptor * point =
+            Object::register_type<Point>("Point");
+    CHECK(point->id == Object::type_id("Point") && point->serialize != nullptr);
+    CHECK(Object::register_type<Point>("Point") == point);
+    Point p = {3, 4};
+    std::string bytes;
+    point->serialize(&p, bytes);
+    const char * in = bytes.data();
+    std::shared_ptr<void> back = point->deserialize(in, bytes.data() +
+            bytes.size());
+    CHECK(back != nullptr && static_cast<Point *> (back.get())->y == 4);
+    CHECK(in == bytes.data() + bytes.size());
+    std::shared_ptr<void> cloned = point->clone(&p);
+    CHECK(static_cast<Point *> (cloned.get())->x == 3);
+    CHECK(point->equal == nullptr && point->hash == nullptr);
+
+    // Other types need their own serializers.
+    CHECK(Object::descriptor<Tags>()->serialize == nullptr);
+    const Object::Type_Descriptor * tags = Object::register_type<Tags>("Tags",
+            &write_tags, &read_tags);
+    Tags t;
+    t.names.push_back("a");
+    t.names.push_back("bc");
+    bytes.clear();
+    tags->serialize(&t, bytes);
+    in = bytes.data();
+    back = tags->deserialize(in, bytes.data() + bytes.size());
+    CHECK(static_cast<Tags *> (back.get())->names[1] == "bc");
+    std::string value = "xyz";
+    CHECK(Object::descriptor<std::string>()->equal(&value, &value));
+
+    // A name or a type registered twice to different things throws.
+    CHECK(throws([] {
+        Object::register_type<Tags>("Point");
+    }));
+    CHECK(throws([] {
+        Object::register_type<Point>("Other");
+    }));
+    return check_result();
+}